@@ -1,6 +1,9 @@
 import os
 import re
 import json
+import mmap
+import struct
+import zlib
 # from json import CSafeLoader as Loader
 
 def remove_unwanted_tasks(map_dict, task_list):
@@ -12,34 +15,298 @@ def remove_unwanted_tasks(map_dict, task_list):
             map_dict.pop(task)
     return map_dict
 
+COLLECTED_INDEX_SUFFIX = ".dayu.idx"
+
+def load_collected_index(index_file):
+    """{stream name: [(off, len), ...]} of a dayu-collector index. A stream
+    name repeats when a process re-initialized the tracker, its batches are
+    joined like an appended stat file"""
+    streams = {}
+    names = {}
+    with open(index_file) as stream:
+        for line in stream:
+            try:
+                ent = json.loads(line)
+            except json.JSONDecodeError:
+                continue  # last line cut short
+            if "name" in ent:
+                names[ent["stream"]] = ent["name"]
+                streams.setdefault(ent["name"], [])
+            elif "off" in ent and ent["stream"] in names:
+                streams[names[ent["stream"]]].append((ent["off"], ent["len"]))
+    return streams
+
 def find_files_with_pattern(directory, pattern):
+    """Stat files under directory whose name matches pattern. Streams merged
+    by dayu-collector are listed as "<node file>#<stat file name>". The
+    per-process file a stream fell back to mid-run holds the rest of that
+    stream, it is read with it rather than listed again"""
     file_list = []
     for root, dirs, files in os.walk(directory):
+        collected = set()
+        for file in files:
+            if file.endswith(COLLECTED_INDEX_SUFFIX):
+                data_file = os.path.join(root, file[:-len(".idx")])
+                for name in load_collected_index(os.path.join(root, file)):
+                    if re.search(pattern, name) and ('.json' in name):
+                        file_list.append(f"{data_file}#{name}")
+                        collected.add(name)
         for file in files:
-            if re.search(pattern, file) and ('.json' in file):
+            if file in collected:
+                continue
+            if not file.endswith(COLLECTED_INDEX_SUFFIX) and re.search(pattern, file) and ('.json' in file):
                 file_list.append(os.path.join(root, file))
                 #print(os.path.join(root, file))
     return file_list
 
+def read_collected_text(stat_file):
+    """Records of one stream in a dayu-collector node file, as JSON Lines,
+    followed by its per-process file if the tracker fell back to one"""
+    data_file, name = stat_file.split("#", 1)
+    ranges = load_collected_index(data_file + ".idx").get(name, [])
+    out = []
+    with open(data_file, "rb") as stream:
+        for off, length in ranges:
+            stream.seek(off)
+            out.append(stream.read(length))
+    text = b"".join(out).decode()
+    # pids are unique per stat directory, as for the per-process files
+    rest = os.path.join(os.path.dirname(data_file), name)
+    if os.path.exists(rest):
+        if text and not text.endswith("\n"):
+            text += "\n"
+        text += read_stat_text(rest)
+    return text
+
+def read_stat_text(stat_file):
+    """Text of a stat file, .gz/.zst files (TRACKER_LOG_COMPRESS) are
+    decompressed frame by frame and a frame cut short by a crash is dropped"""
+    if "#" in stat_file and os.path.exists(stat_file.split("#", 1)[0] + ".idx"):
+        return read_collected_text(stat_file)
+    with open(stat_file, "rb") as stream:
+        raw = stream.read()
+    if stat_file.endswith(".gz"):
+        out = []
+        while raw:
+            d = zlib.decompressobj(wbits=31)  # one gzip member per writer batch
+            chunk = d.decompress(raw)
+            if not d.eof:
+                print(f"WARNING: {stat_file} ends in a truncated frame, dropped")
+                break
+            out.append(chunk)
+            raw = d.unused_data
+        raw = b"".join(out)
+    elif stat_file.endswith(".zst"):
+        try:
+            import zstandard
+            reader = zstandard.ZstdDecompressor().stream_reader(raw, read_across_frames=True)
+            raw = reader.read()
+        except ImportError:
+            import subprocess
+            raw = subprocess.run(["zstd", "-dcq"], input=raw, stdout=subprocess.PIPE).stdout
+    return raw.decode()
+
 def load_stat_json(stat_files):
     # loag into {file_name:json_data} format
     ret_dict = {}
     tmp_dict = {}
     for f in stat_files:
         if '.json' in f:
-            with open(f, "r") as stream:
-                print(f"loading {f}")
-                
-                try:
-                    tmp_dict = json.load(stream)
-                    ret_dict[f] = tmp_dict
-                    # print(tmp_dict)
-                except json.JSONDecodeError as exc:
-                    print(exc)
-                    print(f"Error loading {f}")
-                    exit(1)
+            print(f"loading {f}")
+            text = read_stat_text(f)
+            try:
+                # stat files are a JSON array, or JSON Lines
+                # when written with TRACKER_LOG_FORMAT=jsonl
+                head = text.lstrip()[:1]
+                if head == '[':
+                    try:
+                        tmp_dict = json.loads(text)
+                    except json.JSONDecodeError:
+                        # writer did not get to close the array
+                        tmp_dict = json.loads(text.rstrip().rstrip(',') + "\n]")
+                elif not head:
+                    tmp_dict = []
+                else:
+                    lines = [line for line in text.splitlines() if line.strip()]
+                    if lines and not text.endswith("\n"):
+                        lines.pop()  # last record cut short
+                    tmp_dict = [json.loads(line) for line in lines]
+                ret_dict[f] = merge_stat_deltas(tmp_dict)
+                # print(tmp_dict)
+            except json.JSONDecodeError as exc:
+                print(exc)
+                print(f"Error loading {f}")
+                exit(1)
     return ret_dict
 
+# Incremental flushing (TRACKER_FLUSH_*) splits the stats of a long-lived
+# file into delta records marked with "delta_seq". Counts, bytes and times
+# of the deltas add up, page ranges and per-call lists are joined, other
+# fields (sizes, ratios, the cumulative "Task" timers) come from the last.
+DELTA_SUM_KEYS = {
+    "file_read_cnt", "file_write_cnt", "io_bytes", "read_cnt", "write_cnt",
+    "read_bytes", "write_bytes", "by_address", "by_context", "context_mismatch",
+    "dataset_read_cnt", "dataset_write_cnt", "selections_dropped", "chunk_heat_dropped",
+    "calls", "bytes", "time(us)", "blob_put_cnt", "blob_put_bytes", "blob_put_time(us)",
+    "blob_get_cnt", "blob_get_bytes", "blob_get_time(us)", "vlen_reads", "vlen_read_bytes",
+    "submitted", "completed", "released", "wait(us)",
+}
+DELTA_JOIN_KEYS = {"access_orders", "selections", "chunk_heat"}
+DELTA_MIN_KEYS = {"open_time(us)", "start_time"}
+DELTA_MAX_KEYS = {"close_time(us)", "end_time", "vlen_read_max", "delta_seq"}
+
+def _delta_add(old, new, key=None):
+    if new is None:
+        return old
+    if isinstance(old, dict) and isinstance(new, dict):
+        out = dict(old)
+        for k, v in new.items():
+            out[k] = _delta_add(out[k], v, k) if k in out else v
+        return out
+    if key in ("data", "metadata", "datasets") and isinstance(old, list) and isinstance(new, list):
+        # one-element lists, [{dset_name: {mem_type: stat}}] or [{"dset_name": ...}]
+        return [_delta_add(old[0] if old else {}, new[0] if new else {})]
+    if key in DELTA_JOIN_KEYS and isinstance(old, list) and isinstance(new, list):
+        return old + new
+    if isinstance(old, (int, float)) and isinstance(new, (int, float)) and not isinstance(old, bool):
+        if key in DELTA_SUM_KEYS:
+            return old + new
+        if key in DELTA_MIN_KEYS:
+            return min(old, new)
+        if key in DELTA_MAX_KEYS:
+            return max(old, new)
+    return new
+
+def _access_type(read_cnt, write_cnt):
+    if read_cnt > 0 and write_cnt == 0:
+        return "read_only", "input"
+    if write_cnt > 0 and read_cnt == 0:
+        return "write_only", "output"
+    if read_cnt > 0 and write_cnt > 0:
+        return "read_write", "input-output"
+    return "not_accessed", "na"
+
+def _delta_group(rec):
+    """(file key, dataset name) of a record, and whether it is a delta"""
+    for key, val in rec.items():
+        if not key.startswith("file-") or not isinstance(val, dict):
+            continue
+        if "datasets" in val:  # VOL dataset record
+            dset = val["datasets"][0] if val["datasets"] else {}
+            return (key, dset.get("dset_name")), "delta_seq" in dset
+        return (key, None), "delta_seq" in val
+    return None, False
+
+def merge_stat_deltas(records):
+    """Sum the delta records of each file (VFD) or dataset (VOL) into one
+    record, kept where the last of them was. Records of processes that
+    never flushed are returned as they are."""
+    if not isinstance(records, list):
+        return records
+    groups = {}
+    for rec in records:
+        group, delta = _delta_group(rec) if isinstance(rec, dict) else (None, False)
+        if delta:
+            groups[group] = None
+    if not groups:
+        return records
+
+    last = {}
+    for i, rec in enumerate(records):
+        group, _ = _delta_group(rec) if isinstance(rec, dict) else (None, False)
+        if group in groups:
+            groups[group] = rec if groups[group] is None else _delta_add(groups[group], rec)
+            last[group] = i
+
+    merged = []
+    for i, rec in enumerate(records):
+        group, _ = _delta_group(rec) if isinstance(rec, dict) else (None, False)
+        if group not in groups:
+            merged.append(rec)
+        elif last[group] == i:
+            rec = groups[group]
+            stat = rec[group[0]]
+            if group[1] is None:
+                stat["access_type"], stat["file_type"] = _access_type(
+                    stat.get("file_read_cnt", 0), stat.get("file_write_cnt", 0))
+            else:
+                dset = stat["datasets"][0]
+                access_type, _ = _access_type(dset.get("dataset_read_cnt", 0), dset.get("dataset_write_cnt", 0))
+                dset["access_type"] = "read_write" if access_type == "not_accessed" else access_type
+            merged.append(rec)
+    return merged
+
+# Columnar stat files (TRACKER_LOG_FORMAT=columnar), layout in src/core/dayu_colstat.h
+COLSTAT_MAGIC = b"DAYUCOL\0"
+COLSTAT_END_MAGIC = b"DAYUEND\0"
+COLSTAT_TYPES = {1: 'Q', 2: 'q', 3: 'd', 4: 'Q'}  # u64, i64, f64, string id
+
+class ColstatColumn:
+    """Cells of one column, read in place from the mapped chunks"""
+    def __init__(self, chunks, strings=None):
+        self.chunks = chunks
+        self.strings = strings
+        self.starts = []
+        n = 0
+        for c in chunks:
+            self.starts.append(n)
+            n += len(c)
+        self.rows = n
+
+    def __len__(self):
+        return self.rows
+
+    def __getitem__(self, row):
+        if row < 0:
+            row += self.rows
+        if row < 0 or row >= self.rows:
+            raise IndexError(row)
+        k = row // len(self.chunks[0])  # chunks are full except the last
+        v = self.chunks[k][row - self.starts[k]]
+        return self.strings[v] if self.strings is not None else v
+
+    def __iter__(self):
+        for c in self.chunks:
+            if self.strings is None:
+                yield from c
+            else:
+                for v in c:
+                    yield self.strings[v]
+
+def load_stat_columnar(stat_file):
+    """Map a .dcs stat file, returns {table: {column: ColstatColumn}}"""
+    with open(stat_file, "rb") as stream:
+        buf = mmap.mmap(stream.fileno(), 0, access=mmap.ACCESS_READ)
+    mv = memoryview(buf)
+    if bytes(mv[:8]) != COLSTAT_MAGIC or bytes(mv[-8:]) != COLSTAT_END_MAGIC:
+        raise ValueError(f"{stat_file} is not a complete columnar stat file")
+
+    off = struct.unpack_from("<Q", mv, len(mv) - 16)[0]
+    n_strings = struct.unpack_from("<Q", mv, off)[0]
+    str_off = struct.unpack_from(f"<{n_strings + 1}Q", mv, off + 8)
+    off += 8 * (n_strings + 2)
+    strings = [bytes(mv[off + str_off[i]:off + str_off[i + 1]]).decode() for i in range(n_strings)]
+    off += (str_off[n_strings] + 7) // 8 * 8
+
+    tables = {}
+    n_tables = struct.unpack_from("<Q", mv, off)[0]
+    off += 8
+    for _ in range(n_tables):
+        name_id, n_cols, n_rows = struct.unpack_from("<IIQ", mv, off)
+        off += 16
+        cols = {}
+        for _ in range(n_cols):
+            col_id, col_type, n_chunks, _reserved = struct.unpack_from("<IIII", mv, off)
+            off += 16
+            chunks = []
+            for _ in range(n_chunks):
+                chunk_off, rows = struct.unpack_from("<QQ", mv, off)
+                off += 16
+                chunks.append(mv[chunk_off:chunk_off + 8 * rows].cast(COLSTAT_TYPES[col_type]))
+            cols[strings[col_id]] = ColstatColumn(chunks, strings if col_type == 4 else None)
+        tables[strings[name_id]] = cols
+    return tables
+
 # Read in task_to_file mapping json file
 def load_task_file_map(stat_path, test_name,task_list):
     task_file_map = {}
@@ -2,6 +2,7 @@
 import networkx as nx
 from scipy.stats import rankdata
 import math
+import json
 import utils.stat_print as sp
 
 EDGE_COLOR_RGBA = {
@@ -348,3 +349,11 @@ def time_to_file_x_pos(G):
         if i == len(all_tasks) - 1:
             out_file_time_to_x(G,task)
 
+
+def load_sankey(sankey_json):
+    # Node and link dicts written by dayu-sankey, ready for go.Sankey(node=..., link=...)
+    with open(sankey_json, 'r') as stream:
+        sankey = json.load(stream)
+    node_dict_for_sankey = {k: sankey['node'][k] for k in ['label', 'color', 'x', 'y']}
+    link_dict_for_sankey = {k: sankey['link'][k] for k in ['source', 'target', 'value', 'label', 'color']}
+    return node_dict_for_sankey, link_dict_for_sankey
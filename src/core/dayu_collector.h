@@ -0,0 +1,47 @@
+#ifndef DAYU_COLLECTOR_H
+#define DAYU_COLLECTOR_H
+
+// Wire format between a stat sink and the node-local dayu-collector. A sink
+// that finds the collector socket at open sends its records there instead
+// of writing a per-process file; the collector appends them to one data
+// file per node and workflow, with an index of which byte ranges belong to
+// which stream.
+//
+// Every message is a dayu_msg_header_t followed by len payload bytes:
+//   DAYU_MSG_HELLO  uint32_t pid, then NUL-terminated workflow and stat path
+//   DAYU_MSG_DATA   whole JSON Lines records
+//   DAYU_MSG_END    empty, the stream closed normally
+//
+// The socket path is TRACKER_COLLECTOR, or DAYU_COLLECTOR_SOCKET formatted
+// with the uid when unset. TRACKER_COLLECTOR=off never connects.
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DAYU_COLLECTOR_ENV "TRACKER_COLLECTOR"
+#define DAYU_COLLECTOR_SOCKET "/tmp/dayu-collector-%u.sock"
+#define DAYU_COLLECTOR_MAGIC 0x55594144u    // "DAYU"
+#define DAYU_COLLECTOR_SEND_MS 1000         // a stalled collector is dropped after this
+#define DAYU_COLLECTOR_DATA_SUFFIX ".dayu"
+#define DAYU_COLLECTOR_INDEX_SUFFIX ".dayu.idx"
+
+typedef enum {
+    DAYU_MSG_HELLO = 1,
+    DAYU_MSG_DATA = 2,
+    DAYU_MSG_END = 3,
+} dayu_msg_type_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t type;                      // dayu_msg_type_t
+    uint64_t len;
+} dayu_msg_header_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DAYU_COLLECTOR_H */
@@ -0,0 +1,319 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include "dayu_colstat.h"
+#include "../utils/uthash/src/uthash.h"
+
+/* Columnar writer implementation start */
+typedef struct {
+    char* str;
+    uint32_t id;
+    UT_hash_handle hh;
+} dayu_col_str_t;
+
+typedef struct {
+    uint32_t name_id;
+    dayu_col_type_t type;
+    uint64_t* buf;                      // DAYU_COL_CHUNK_ROWS pending cells
+    dayu_col_chunk_ent_t* chunks;
+    uint32_t n_chunks;
+    uint32_t chunk_cap;
+} dayu_col_column_t;
+
+struct dayu_col_table_t {
+    dayu_col_writer_t* w;
+    uint32_t name_id;
+    int n_cols;
+    dayu_col_column_t* cols;
+    uint64_t n_rows;
+    uint32_t pending;                   // rows in the column buffers
+    dayu_col_table_t* next;
+};
+
+struct dayu_col_writer_t {
+    FILE* fh;
+    uint64_t pos;                       // end of the written data
+    int failed;
+    dayu_col_str_t* str_hash;
+    dayu_col_str_t** strs;              // by id
+    uint32_t n_strs;
+    uint32_t str_cap;
+    dayu_col_table_t* tables;           // in declaration order
+    dayu_col_table_t* tables_tail;
+    pthread_mutex_t mutex;
+};
+
+static void dayu_col_write(dayu_col_writer_t* w, const void* data, size_t len)
+{
+    if(w->failed || len == 0)
+        return;
+    if(fwrite(data, 1, len, w->fh) != len){
+        fprintf(stderr, "dayu_col_write(): write failed: %s\n", strerror(errno));
+        w->failed = 1;
+        return;
+    }
+    w->pos += len;
+}
+
+// Id of str in the string table, added on first use
+static uint32_t dayu_col_str_id(dayu_col_writer_t* w, const char* str)
+{
+    dayu_col_str_t* entry = NULL;
+
+    if(!str)
+        str = "";
+    HASH_FIND_STR(w->str_hash, str, entry);
+    if(entry)
+        return entry->id;
+
+    if(w->n_strs == w->str_cap){
+        uint32_t new_cap = w->str_cap ? w->str_cap * 2 : 256;
+        dayu_col_str_t** new_strs = (dayu_col_str_t**)realloc(w->strs, new_cap * sizeof(dayu_col_str_t*));
+        if(!new_strs){
+            fprintf(stderr, "dayu_col_str_id(): out of memory\n");
+            w->failed = 1;
+            return 0;
+        }
+        w->strs = new_strs;
+        w->str_cap = new_cap;
+    }
+    entry = (dayu_col_str_t*)calloc(1, sizeof(dayu_col_str_t));
+    if(entry)
+        entry->str = strdup(str);
+    if(!entry || !entry->str){
+        fprintf(stderr, "dayu_col_str_id(): out of memory\n");
+        free(entry);
+        w->failed = 1;
+        return 0;
+    }
+    entry->id = w->n_strs;
+    w->strs[w->n_strs++] = entry;
+    HASH_ADD_KEYPTR(hh, w->str_hash, entry->str, strlen(entry->str), entry);
+    return entry->id;
+}
+
+dayu_col_writer_t* dayu_col_create(const char* path)
+{
+    dayu_col_header_t header;
+    dayu_col_writer_t* w = (dayu_col_writer_t*)calloc(1, sizeof(dayu_col_writer_t));
+
+    if(!w){
+        fprintf(stderr, "dayu_col_create(): out of memory\n");
+        return NULL;
+    }
+    w->fh = fopen(path, "w");
+    if(!w->fh){
+        fprintf(stderr, "dayu_col_create(): failed to open %s: %s\n", path, strerror(errno));
+        free(w);
+        return NULL;
+    }
+    pthread_mutex_init(&w->mutex, NULL);
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, DAYU_COL_MAGIC, sizeof(header.magic));
+    header.version = DAYU_COL_VERSION;
+    dayu_col_write(w, &header, sizeof(header));
+    return w;
+}
+
+static void dayu_col_table_free(dayu_col_table_t* t)
+{
+    if(t->cols){
+        for(int c = 0; c < t->n_cols; c++){
+            free(t->cols[c].buf);
+            free(t->cols[c].chunks);
+        }
+    }
+    free(t->cols);
+    free(t);
+}
+
+// NULL when out of memory or the writer already failed, which then fails at close
+dayu_col_table_t* dayu_col_table(dayu_col_writer_t* w, const char* name, int n_cols,
+    const char* const* col_names, const dayu_col_type_t* col_types)
+{
+    dayu_col_table_t* t;
+    int c = 0;
+
+    if(!w)
+        return NULL;
+
+    t = (dayu_col_table_t*)calloc(1, sizeof(dayu_col_table_t));
+    if(!t){
+        fprintf(stderr, "dayu_col_table(): out of memory\n");
+        w->failed = 1;
+        return NULL;
+    }
+    t->w = w;
+    t->n_cols = n_cols;
+    t->cols = (dayu_col_column_t*)calloc(n_cols, sizeof(dayu_col_column_t));
+
+    pthread_mutex_lock(&w->mutex);
+    t->name_id = dayu_col_str_id(w, name);
+    for(; t->cols && c < n_cols; c++){
+        t->cols[c].name_id = dayu_col_str_id(w, col_names[c]);
+        t->cols[c].type = col_types[c];
+        t->cols[c].buf = (uint64_t*)malloc(DAYU_COL_CHUNK_ROWS * sizeof(uint64_t));
+        if(!t->cols[c].buf)
+            break;
+    }
+    if(c < n_cols || w->failed){
+        fprintf(stderr, "dayu_col_table(): failed to add table %s\n", name);
+        w->failed = 1;
+        pthread_mutex_unlock(&w->mutex);
+        dayu_col_table_free(t);
+        return NULL;
+    }
+    if(w->tables_tail)
+        w->tables_tail->next = t;
+    else
+        w->tables = t;
+    w->tables_tail = t;
+    pthread_mutex_unlock(&w->mutex);
+    return t;
+}
+
+// Write the pending rows of every column as one chunk each
+static void dayu_col_flush_table(dayu_col_table_t* t)
+{
+    dayu_col_writer_t* w = t->w;
+
+    if(t->pending == 0)
+        return;
+
+    for(int c = 0; c < t->n_cols; c++){
+        dayu_col_column_t* col = &t->cols[c];
+
+        if(col->n_chunks == col->chunk_cap){
+            uint32_t new_cap = col->chunk_cap ? col->chunk_cap * 2 : 4;
+            dayu_col_chunk_ent_t* new_chunks = (dayu_col_chunk_ent_t*)realloc(col->chunks,
+                new_cap * sizeof(dayu_col_chunk_ent_t));
+            if(!new_chunks){
+                fprintf(stderr, "dayu_col_flush_table(): out of memory\n");
+                w->failed = 1;
+                return;
+            }
+            col->chunks = new_chunks;
+            col->chunk_cap = new_cap;
+        }
+        col->chunks[col->n_chunks].offset = w->pos;
+        col->chunks[col->n_chunks].rows = t->pending;
+        col->n_chunks++;
+        dayu_col_write(w, col->buf, t->pending * sizeof(uint64_t));
+    }
+    t->pending = 0;
+}
+
+uint64_t dayu_col_append(dayu_col_table_t* t, const dayu_col_val_t* row)
+{
+    uint64_t idx;
+
+    if(!t)
+        return 0;
+
+    pthread_mutex_lock(&t->w->mutex);
+    for(int c = 0; c < t->n_cols; c++){
+        uint64_t cell;
+
+        switch(t->cols[c].type){
+            case DAYU_COL_STR:
+                cell = dayu_col_str_id(t->w, row[c].s);
+                break;
+            case DAYU_COL_I64:
+                memcpy(&cell, &row[c].i, sizeof(cell));
+                break;
+            case DAYU_COL_F64:
+                memcpy(&cell, &row[c].f, sizeof(cell));
+                break;
+            default:
+                cell = row[c].u;
+        }
+        t->cols[c].buf[t->pending] = cell;
+    }
+    idx = t->n_rows++;
+    if(++t->pending == DAYU_COL_CHUNK_ROWS)
+        dayu_col_flush_table(t);
+    pthread_mutex_unlock(&t->w->mutex);
+    return idx;
+}
+
+uint64_t dayu_col_rows(const dayu_col_table_t* t)
+{
+    return t ? t->n_rows : 0;
+}
+
+int dayu_col_close(dayu_col_writer_t* w)
+{
+    dayu_col_trailer_t trailer;
+    dayu_col_table_t *t, *t_next;
+    uint64_t footer_off, n, off = 0;
+    static const char pad[8] = {0};
+    int ret;
+
+    if(!w)
+        return -1;
+
+    pthread_mutex_lock(&w->mutex);
+    for(t = w->tables; t; t = t->next)
+        dayu_col_flush_table(t);
+
+    footer_off = w->pos;
+
+    // string table
+    n = w->n_strs;
+    dayu_col_write(w, &n, sizeof(n));
+    for(uint32_t s = 0; s < w->n_strs; s++){
+        dayu_col_write(w, &off, sizeof(off));
+        off += strlen(w->strs[s]->str);
+    }
+    dayu_col_write(w, &off, sizeof(off));
+    for(uint32_t s = 0; s < w->n_strs; s++)
+        dayu_col_write(w, w->strs[s]->str, strlen(w->strs[s]->str));
+    dayu_col_write(w, pad, (8 - off % 8) % 8);
+
+    // table index
+    n = 0;
+    for(t = w->tables; t; t = t->next)
+        n++;
+    dayu_col_write(w, &n, sizeof(n));
+    for(t = w->tables; t; t = t->next){
+        dayu_col_table_ent_t tent = { t->name_id, (uint32_t)t->n_cols, t->n_rows };
+
+        dayu_col_write(w, &tent, sizeof(tent));
+        for(int c = 0; c < t->n_cols; c++){
+            dayu_col_column_ent_t cent = { t->cols[c].name_id, (uint32_t)t->cols[c].type, t->cols[c].n_chunks, 0 };
+
+            dayu_col_write(w, &cent, sizeof(cent));
+            dayu_col_write(w, t->cols[c].chunks, t->cols[c].n_chunks * sizeof(dayu_col_chunk_ent_t));
+        }
+    }
+
+    memset(&trailer, 0, sizeof(trailer));
+    trailer.footer_off = footer_off;
+    memcpy(trailer.magic, DAYU_COL_END_MAGIC, sizeof(trailer.magic));
+    dayu_col_write(w, &trailer, sizeof(trailer));
+
+    ret = w->failed ? -1 : 0;
+    if(fclose(w->fh) != 0)
+        ret = -1;
+    pthread_mutex_unlock(&w->mutex);
+
+    // free everything
+    for(t = w->tables; t; t = t_next){
+        t_next = t->next;
+        dayu_col_table_free(t);
+    }
+    HASH_CLEAR(hh, w->str_hash);
+    for(uint32_t s = 0; s < w->n_strs; s++){
+        free(w->strs[s]->str);
+        free(w->strs[s]);
+    }
+    free(w->strs);
+    pthread_mutex_destroy(&w->mutex);
+    free(w);
+    return ret;
+}
+/* Columnar writer implementation end */
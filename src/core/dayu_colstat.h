@@ -0,0 +1,97 @@
+#ifndef DAYU_COLSTAT_H
+#define DAYU_COLSTAT_H
+
+// Columnar binary stat file. Each table is a set of typed columns written
+// as column chunks while rows arrive; a footer index at the end of the file
+// lists every table, column and chunk, so a reader maps the file and casts
+// chunks to arrays instead of parsing text.
+//
+// Layout (host byte order, every offset 8-byte aligned):
+//   dayu_col_header_t
+//   column chunks                     n_rows 8-byte values each
+//   footer:
+//     uint64_t n_strings
+//     uint64_t str_off[n_strings + 1] offsets into the string blob
+//     char     blob[str_off[n_strings]], padded to 8
+//     uint64_t n_tables
+//     per table:  dayu_col_table_ent_t
+//       per column: dayu_col_column_ent_t, dayu_col_chunk_ent_t[n_chunks]
+//   dayu_col_trailer_t
+//
+// String cells hold an index into the string table.
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DAYU_COL_MAGIC "DAYUCOL"        // header magic, 8 bytes with the NUL
+#define DAYU_COL_END_MAGIC "DAYUEND"    // trailer magic
+#define DAYU_COL_VERSION 1
+#define DAYU_COL_CHUNK_ROWS 4096        // rows buffered per column before a chunk is written
+#define DAYU_COL_SUFFIX ".dcs"
+
+typedef enum {
+    DAYU_COL_U64 = 1,
+    DAYU_COL_I64 = 2,
+    DAYU_COL_F64 = 3,
+    DAYU_COL_STR = 4,
+} dayu_col_type_t;
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+} dayu_col_header_t;
+
+typedef struct {
+    uint64_t footer_off;
+    char magic[8];
+} dayu_col_trailer_t;
+
+typedef struct {
+    uint32_t name_id;
+    uint32_t n_cols;
+    uint64_t n_rows;
+} dayu_col_table_ent_t;
+
+typedef struct {
+    uint32_t name_id;
+    uint32_t type;                      // dayu_col_type_t
+    uint32_t n_chunks;
+    uint32_t reserved;
+} dayu_col_column_ent_t;
+
+typedef struct {
+    uint64_t offset;
+    uint64_t rows;
+} dayu_col_chunk_ent_t;
+
+// One cell of a row, the member used follows the column type
+typedef union {
+    uint64_t u;
+    int64_t i;
+    double f;
+    const char* s;
+} dayu_col_val_t;
+
+typedef struct dayu_col_writer_t dayu_col_writer_t;
+typedef struct dayu_col_table_t dayu_col_table_t;
+
+/* Writer */
+dayu_col_writer_t* dayu_col_create(const char* path);
+// Tables are declared before or between rows, columns are fixed at declaration
+dayu_col_table_t* dayu_col_table(dayu_col_writer_t* w, const char* name, int n_cols,
+    const char* const* col_names, const dayu_col_type_t* col_types);
+// Append one row of n_cols cells, returns its row index in the table
+uint64_t dayu_col_append(dayu_col_table_t* t, const dayu_col_val_t* row);
+uint64_t dayu_col_rows(const dayu_col_table_t* t);
+// Write the remaining chunks and the footer, frees the writer
+int dayu_col_close(dayu_col_writer_t* w);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DAYU_COLSTAT_H */
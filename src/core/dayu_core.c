@@ -0,0 +1,1468 @@
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <zlib.h>
+#ifdef DAYU_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "dayu_core.h"
+#include "dayu_collector.h"
+#include "../utils/uthash/src/uthash.h"
+
+/* Clock implementation start */
+unsigned long dayu_time_usec(void)
+{
+    struct timeval tp;
+
+    gettimeofday(&tp, NULL);
+    return (unsigned long)((1000000 * tp.tv_sec) + tp.tv_usec);
+}
+/* Clock implementation end */
+
+
+/* Intern table implementation start */
+typedef struct {
+    char* str;
+    UT_hash_handle hh;
+} dayu_intern_t;
+
+static dayu_intern_t* DAYU_INTERN = NULL;
+static pthread_mutex_t DAYU_INTERN_MUTEX = PTHREAD_MUTEX_INITIALIZER;
+
+const char* dayu_intern(const char* str)
+{
+    dayu_intern_t* entry = NULL;
+
+    if(!str)
+        return NULL;
+
+    pthread_mutex_lock(&DAYU_INTERN_MUTEX);
+    HASH_FIND_STR(DAYU_INTERN, str, entry);
+    if(!entry){
+        entry = (dayu_intern_t*)calloc(1, sizeof(dayu_intern_t));
+        if(entry)
+            entry->str = strdup(str);
+        if(!entry || !entry->str){
+            fprintf(stderr, "dayu_intern(): out of memory\n");
+            free(entry);
+            pthread_mutex_unlock(&DAYU_INTERN_MUTEX);
+            return NULL;
+        }
+        HASH_ADD_KEYPTR(hh, DAYU_INTERN, entry->str, strlen(entry->str), entry);
+    }
+    pthread_mutex_unlock(&DAYU_INTERN_MUTEX);
+    return entry->str;
+}
+/* Intern table implementation end */
+
+
+/* Task name implementation start */
+static pthread_mutex_t DAYU_TASK_MUTEX = PTHREAD_MUTEX_INITIALIZER;
+static char* DAYU_TASK_NAME = NULL;     // task file contents, NULL until read
+static char* DAYU_TASK_PATH = NULL;
+static int DAYU_TASK_INIT = 0;
+static unsigned long DAYU_TASK_REFRESH = DAYU_TASK_REFRESH_MS;
+static unsigned long DAYU_TASK_NEXT_CHECK = 0;  // monotonic ms
+static struct stat DAYU_TASK_STAT;      // of the file the name was read from
+static int DAYU_TASK_WARNED = 0;
+
+// Coarse monotonic clock, read from the vDSO without a syscall
+static unsigned long dayu_mono_msec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return (unsigned long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void dayu_task_init(void)
+{
+    const char* dir = getenv("PATH_FOR_TASK_FILES");
+    const char* workflow = getenv("WORKFLOW_NAME");
+    const char* refresh = getenv("TRACKER_TASK_REFRESH_MS");
+
+    DAYU_TASK_INIT = 1;
+    if(refresh && *refresh)
+        DAYU_TASK_REFRESH = strtoul(refresh, NULL, 10);
+    if(!dir || !workflow){
+        fprintf(stderr, "dayu_task_name(): CURR_TASK, PATH_FOR_TASK_FILES or WORKFLOW_NAME not set\n");
+        return;
+    }
+    size_t len = strlen(dir) + strlen(workflow) + sizeof("/_vfd.curr_task");
+    DAYU_TASK_PATH = (char*)malloc(len);
+    if(DAYU_TASK_PATH)
+        snprintf(DAYU_TASK_PATH, len, "%s/%s_vfd.curr_task", dir, workflow);
+}
+
+// Whole task file read under a shared lock, NULL if it is locked by a
+// writer or cannot be read
+static char* dayu_task_file_read(const char* path)
+{
+    struct flock lock;
+    char* buf = NULL;
+    size_t len = 0, cap = 0;
+    ssize_t n;
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+
+    if(fd < 0)
+        return NULL;
+    memset(&lock, 0, sizeof(lock));
+    lock.l_type = F_RDLCK;
+    lock.l_whence = SEEK_SET;
+    if(fcntl(fd, F_SETLK, &lock) == -1){
+        close(fd);
+        return NULL;
+    }
+    for(;;){
+        if(len + 1 >= cap){
+            char* grown = (char*)realloc(buf, cap ? cap * 2 : 256);
+            if(!grown)
+                break;
+            buf = grown;
+            cap = cap ? cap * 2 : 256;
+        }
+        n = read(fd, buf + len, cap - len - 1);
+        if(n < 0 && errno == EINTR)
+            continue;
+        if(n <= 0)
+            break;
+        len += (size_t)n;
+    }
+    close(fd); // releases the lock
+    if(buf)
+        buf[len] = '\0';
+    return buf;
+}
+
+int dayu_task_name(char** name)
+{
+    const char* env = getenv("CURR_TASK");
+    struct stat st;
+    int found;
+
+    if(env){
+        *name = strdup(env);
+        return 1;
+    }
+
+    pthread_mutex_lock(&DAYU_TASK_MUTEX);
+    if(!DAYU_TASK_INIT)
+        dayu_task_init();
+    if(DAYU_TASK_PATH && dayu_mono_msec() >= DAYU_TASK_NEXT_CHECK){
+        DAYU_TASK_NEXT_CHECK = dayu_mono_msec() + DAYU_TASK_REFRESH;
+        if(stat(DAYU_TASK_PATH, &st) != 0){
+            // a vanished file keeps the last name read
+            if(!DAYU_TASK_WARNED++)
+                fprintf(stderr, "dayu_task_name(): cannot stat %s: %s\n", DAYU_TASK_PATH, strerror(errno));
+        } else if(!DAYU_TASK_NAME || st.st_ino != DAYU_TASK_STAT.st_ino || st.st_dev != DAYU_TASK_STAT.st_dev
+                  || st.st_size != DAYU_TASK_STAT.st_size || st.st_mtim.tv_sec != DAYU_TASK_STAT.st_mtim.tv_sec
+                  || st.st_mtim.tv_nsec != DAYU_TASK_STAT.st_mtim.tv_nsec){
+            char* read_name = dayu_task_file_read(DAYU_TASK_PATH);
+            if(read_name){
+                free(DAYU_TASK_NAME);
+                DAYU_TASK_NAME = read_name;
+                DAYU_TASK_STAT = st;
+                DAYU_TASK_WARNED = 0;
+            } else {
+                // locked by a writer, tried again on the next call
+                DAYU_TASK_NEXT_CHECK = 0;
+                if(!DAYU_TASK_WARNED++)
+                    fprintf(stderr, "dayu_task_name(): cannot read %s\n", DAYU_TASK_PATH);
+            }
+        }
+    }
+    found = DAYU_TASK_NAME != NULL;
+    *name = strdup(found ? DAYU_TASK_NAME : "");
+    pthread_mutex_unlock(&DAYU_TASK_MUTEX);
+    return found;
+}
+/* Task name implementation end */
+
+
+/* Per-thread context implementation start */
+static __thread char DAYU_CTX[DAYU_NAME_MAX];
+
+void dayu_ctx_set(const char* name)
+{
+    if(!name)
+        return;
+    // Only write if it is different from the current object
+    if(strcmp(DAYU_CTX, name) == 0)
+        return;
+    strncpy(DAYU_CTX, name, DAYU_NAME_MAX - 1);
+    DAYU_CTX[DAYU_NAME_MAX - 1] = '\0';
+}
+
+const char* dayu_ctx_get(void)
+{
+    return DAYU_CTX;
+}
+/* Per-thread context implementation end */
+
+
+/* Dataset registry implementation start */
+typedef struct {
+    uint64_t addr;
+    uint64_t end;
+    const char* dset_name;              // interned, NULL once replaced
+} dayu_extent_t;
+
+// Extents of one file. New extents go to a short sorted delta, merged into
+// the main array when it fills, so unsorted arrivals cost at most
+// DAYU_REGISTRY_DELTA moves each. Live extents never overlap: a new extent
+// replaces every one it overlaps (space freed and reallocated), removed from
+// the delta and marked dead in the main array until the next merge.
+typedef struct {
+    const char* file_key;               // interned file name
+    dayu_extent_t* extents;             // main, sorted by address
+    size_t cnt;
+    size_t cap;
+    size_t dead;                        // replaced extents still in the main array
+    dayu_extent_t* delta;               // sorted by address, DAYU_REGISTRY_DELTA entries
+    size_t delta_cnt;
+    UT_hash_handle hh;
+} dayu_file_extents_t;
+
+static dayu_file_extents_t* DAYU_REGISTRY = NULL;
+static size_t DAYU_REGISTRY_CNT = 0;
+static unsigned long DAYU_REGISTRY_DROPPED = 0;
+static pthread_rwlock_t DAYU_REGISTRY_LOCK = PTHREAD_RWLOCK_INITIALIZER;
+
+// First extent starting after addr
+static size_t dayu_extent_upper(const dayu_extent_t* extents, size_t cnt, uint64_t addr)
+{
+    size_t lo = 0, hi = cnt;
+
+    while(lo < hi){
+        size_t mid = lo + (hi - lo) / 2;
+        if(extents[mid].addr <= addr)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+// Merge the delta into the main array, dropping dead extents
+static int dayu_extent_merge(dayu_file_extents_t* file)
+{
+    dayu_extent_t* merged;
+    size_t i = 0, j = 0, n = 0;
+
+    if(file->delta_cnt == 0)
+        return 0;
+    merged = (dayu_extent_t*)malloc((file->cnt - file->dead + file->delta_cnt) * sizeof(dayu_extent_t));
+    if(!merged)
+        return -1;
+    while(i < file->cnt || j < file->delta_cnt){
+        if(j == file->delta_cnt || (i < file->cnt && file->extents[i].addr < file->delta[j].addr)){
+            if(file->extents[i].dset_name)
+                merged[n++] = file->extents[i];
+            i++;
+        } else {
+            merged[n++] = file->delta[j++];
+        }
+    }
+    free(file->extents);
+    file->extents = merged;
+    file->cnt = n;
+    file->cap = n;
+    file->dead = 0;
+    file->delta_cnt = 0;
+    return 0;
+}
+
+// Replace the extents overlapping [addr, end). Only the closest extent
+// starting below addr can reach into it, since live extents do not overlap.
+static void dayu_extent_evict(dayu_file_extents_t* file, uint64_t addr, uint64_t end)
+{
+    size_t pos, first, last;
+
+    pos = dayu_extent_upper(file->extents, file->cnt, addr);
+    if(pos > 0 && file->extents[pos - 1].dset_name && file->extents[pos - 1].end > addr){
+        file->extents[pos - 1].dset_name = NULL;
+        file->dead++;
+        DAYU_REGISTRY_CNT--;
+    }
+    for(; pos < file->cnt && file->extents[pos].addr < end; pos++){
+        if(file->extents[pos].dset_name){
+            file->extents[pos].dset_name = NULL;
+            file->dead++;
+            DAYU_REGISTRY_CNT--;
+        }
+    }
+
+    first = last = dayu_extent_upper(file->delta, file->delta_cnt, addr);
+    if(first > 0 && file->delta[first - 1].end > addr)
+        first--;
+    while(last < file->delta_cnt && file->delta[last].addr < end)
+        last++;
+    if(last > first){
+        memmove(&file->delta[first], &file->delta[last], (file->delta_cnt - last) * sizeof(dayu_extent_t));
+        file->delta_cnt -= last - first;
+        DAYU_REGISTRY_CNT -= last - first;
+    }
+}
+
+// The live extent holding addr in one sorted array, if any
+static const dayu_extent_t* dayu_extent_find(const dayu_extent_t* extents, size_t cnt, uint64_t addr)
+{
+    size_t pos = dayu_extent_upper(extents, cnt, addr);
+
+    if(pos > 0 && extents[pos - 1].dset_name && addr < extents[pos - 1].end)
+        return &extents[pos - 1];
+    return NULL;
+}
+
+void dayu_dset_extent_add(const char* file_name, uint64_t addr, uint64_t size, const char* dset_name)
+{
+    const char* file_key = dayu_intern(file_name);
+    const char* name = dayu_intern(dset_name);
+    dayu_file_extents_t* file = NULL;
+    size_t pos;
+
+    if(!file_key || !name || size == 0)
+        return;
+
+    pthread_rwlock_wrlock(&DAYU_REGISTRY_LOCK);
+    HASH_FIND_PTR(DAYU_REGISTRY, &file_key, file);
+    if(!file){
+        file = (dayu_file_extents_t*)calloc(1, sizeof(dayu_file_extents_t));
+        if(file)
+            file->delta = (dayu_extent_t*)malloc(DAYU_REGISTRY_DELTA * sizeof(dayu_extent_t));
+        if(!file || !file->delta){
+            free(file);
+            DAYU_REGISTRY_DROPPED++;
+            goto done;
+        }
+        file->file_key = file_key;
+        HASH_ADD_PTR(DAYU_REGISTRY, file_key, file);
+    }
+
+    // published again unchanged, e.g. by each reopen of the dataset
+    {
+        const dayu_extent_t* cur = dayu_extent_find(file->delta, file->delta_cnt, addr);
+        if(!cur)
+            cur = dayu_extent_find(file->extents, file->cnt, addr);
+        if(cur && cur->addr == addr && cur->end == addr + size && cur->dset_name == name)
+            goto done;
+    }
+    dayu_extent_evict(file, addr, addr + size);
+
+    if(DAYU_REGISTRY_CNT >= DAYU_REGISTRY_MAX){
+        DAYU_REGISTRY_DROPPED++;
+        goto done;
+    }
+    if(file->delta_cnt == DAYU_REGISTRY_DELTA){
+        if(dayu_extent_merge(file) < 0){
+            DAYU_REGISTRY_DROPPED++;
+            goto done;
+        }
+    }
+    pos = dayu_extent_upper(file->delta, file->delta_cnt, addr);
+    memmove(&file->delta[pos + 1], &file->delta[pos], (file->delta_cnt - pos) * sizeof(dayu_extent_t));
+    file->delta[pos].addr = addr;
+    file->delta[pos].end = addr + size;
+    file->delta[pos].dset_name = name;
+    file->delta_cnt++;
+    DAYU_REGISTRY_CNT++;
+
+done:
+    pthread_rwlock_unlock(&DAYU_REGISTRY_LOCK);
+}
+
+void dayu_dset_extent_drop(const char* file_name)
+{
+    const char* file_key = dayu_intern(file_name);
+    dayu_file_extents_t* file = NULL;
+
+    if(!file_key)
+        return;
+    pthread_rwlock_wrlock(&DAYU_REGISTRY_LOCK);
+    HASH_FIND_PTR(DAYU_REGISTRY, &file_key, file);
+    if(file){
+        HASH_DEL(DAYU_REGISTRY, file);
+        DAYU_REGISTRY_CNT -= file->cnt - file->dead + file->delta_cnt;
+        free(file->extents);
+        free(file->delta);
+        free(file);
+    }
+    pthread_rwlock_unlock(&DAYU_REGISTRY_LOCK);
+}
+
+const char* dayu_dset_at(const char* file_key, uint64_t addr)
+{
+    dayu_file_extents_t* file = NULL;
+    const dayu_extent_t* found = NULL;
+    const char* name = NULL;
+
+    if(!file_key)
+        return NULL;
+
+    pthread_rwlock_rdlock(&DAYU_REGISTRY_LOCK);
+    HASH_FIND_PTR(DAYU_REGISTRY, &file_key, file);
+    if(file){
+        // live extents do not overlap, at most one of the two holds addr;
+        // a dead one closest below addr means the live holder is in the delta
+        found = dayu_extent_find(file->delta, file->delta_cnt, addr);
+        if(!found)
+            found = dayu_extent_find(file->extents, file->cnt, addr);
+        if(found)
+            name = found->dset_name;
+    }
+    pthread_rwlock_unlock(&DAYU_REGISTRY_LOCK);
+    return name;
+}
+
+unsigned long dayu_dset_extent_dropped(void)
+{
+    return __atomic_load_n(&DAYU_REGISTRY_DROPPED, __ATOMIC_RELAXED);
+}
+/* Dataset registry implementation end */
+
+
+/* Output sink implementation start */
+typedef struct dayu_sink_path_t {
+    const char* path;           // interned
+    struct dayu_sink_path_t* next;
+} dayu_sink_path_t;
+
+static dayu_sink_path_t* DAYU_SINK_PATHS = NULL; // a re-initialized tracker appends instead of truncating
+static pthread_mutex_t DAYU_SINK_PATHS_MUTEX = PTHREAD_MUTEX_INITIALIZER;
+
+// 1 if path was opened by a sink earlier in this process
+static int dayu_sink_reopen(const char* path)
+{
+    const char* key = dayu_intern(path);
+    dayu_sink_path_t* entry;
+    int found = 0;
+
+    pthread_mutex_lock(&DAYU_SINK_PATHS_MUTEX);
+    for(entry = DAYU_SINK_PATHS; entry; entry = entry->next){
+        if(entry->path == key){
+            found = 1;
+            break;
+        }
+    }
+    if(!found && (entry = (dayu_sink_path_t*)calloc(1, sizeof(dayu_sink_path_t)))){
+        entry->path = key;
+        entry->next = DAYU_SINK_PATHS;
+        DAYU_SINK_PATHS = entry;
+    }
+    pthread_mutex_unlock(&DAYU_SINK_PATHS_MUTEX);
+    return found;
+}
+
+static unsigned long dayu_thread_cpu_usec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (unsigned long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int dayu_sink_codec_init(dayu_sink_t* sink)
+{
+    if(sink->codec == DAYU_SINK_GZIP){
+        z_stream* zs = (z_stream*)calloc(1, sizeof(z_stream));
+        // windowBits 15 + 16 writes a gzip header and trailer per member
+        if(!zs || deflateInit2(zs, sink->level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK){
+            free(zs);
+            return -1;
+        }
+        sink->codec_ctx = zs;
+    }
+#ifdef DAYU_HAVE_ZSTD
+    else if(sink->codec == DAYU_SINK_ZSTD){
+        sink->codec_ctx = ZSTD_createCCtx();
+        if(!sink->codec_ctx)
+            return -1;
+    }
+#endif
+    return 0;
+}
+
+static void dayu_sink_codec_free(dayu_sink_t* sink)
+{
+    if(!sink->codec_ctx)
+        return;
+    if(sink->codec == DAYU_SINK_GZIP){
+        deflateEnd((z_stream*)sink->codec_ctx);
+        free(sink->codec_ctx);
+    }
+#ifdef DAYU_HAVE_ZSTD
+    else if(sink->codec == DAYU_SINK_ZSTD)
+        ZSTD_freeCCtx((ZSTD_CCtx*)sink->codec_ctx);
+#endif
+    sink->codec_ctx = NULL;
+}
+
+// Compress one batch into sink->frame, returns the frame length or 0
+static size_t dayu_sink_compress(dayu_sink_t* sink, const char* data, size_t len)
+{
+    size_t bound = 0;
+
+    if(sink->codec == DAYU_SINK_GZIP)
+        bound = deflateBound((z_stream*)sink->codec_ctx, (uLong)len);
+#ifdef DAYU_HAVE_ZSTD
+    else if(sink->codec == DAYU_SINK_ZSTD)
+        bound = ZSTD_compressBound(len);
+#endif
+    if(bound > sink->frame_cap){
+        char* new_frame = (char*)realloc(sink->frame, bound);
+        if(!new_frame)
+            return 0;
+        sink->frame = new_frame;
+        sink->frame_cap = bound;
+    }
+
+    if(sink->codec == DAYU_SINK_GZIP){
+        z_stream* zs = (z_stream*)sink->codec_ctx;
+        size_t out_len;
+
+        zs->next_in = (Bytef*)data;
+        zs->avail_in = (uInt)len;
+        zs->next_out = (Bytef*)sink->frame;
+        zs->avail_out = (uInt)sink->frame_cap;
+        if(deflate(zs, Z_FINISH) != Z_STREAM_END){
+            deflateReset(zs);
+            return 0;
+        }
+        out_len = sink->frame_cap - zs->avail_out;
+        deflateReset(zs); // next batch starts a new member
+        return out_len;
+    }
+#ifdef DAYU_HAVE_ZSTD
+    if(sink->codec == DAYU_SINK_ZSTD){
+        size_t out_len = ZSTD_compressCCtx((ZSTD_CCtx*)sink->codec_ctx, sink->frame, sink->frame_cap,
+            data, len, sink->level);
+        return ZSTD_isError(out_len) ? 0 : out_len;
+    }
+#endif
+    return 0;
+}
+
+// Write all of buf to the non-blocking collector socket, waiting at most
+// DAYU_COLLECTOR_SEND_MS for each stall
+static int dayu_collector_write(int sock, const void* buf, size_t len)
+{
+    const char* p = (const char*)buf;
+
+    while(len > 0){
+        ssize_t n = send(sock, p, len, MSG_NOSIGNAL);
+        if(n > 0){
+            p += n;
+            len -= (size_t)n;
+            continue;
+        }
+        if(n < 0 && errno == EINTR)
+            continue;
+        if(n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)){
+            struct pollfd pfd = { sock, POLLOUT, 0 };
+            if(poll(&pfd, 1, DAYU_COLLECTOR_SEND_MS) > 0 && !(pfd.revents & (POLLERR | POLLHUP)))
+                continue;
+        }
+        return -1;
+    }
+    return 0;
+}
+
+static int dayu_collector_send(int sock, dayu_msg_type_t type, const void* payload, size_t len)
+{
+    dayu_msg_header_t header = { DAYU_COLLECTOR_MAGIC, (uint32_t)type, (uint64_t)len };
+
+    if(dayu_collector_write(sock, &header, sizeof(header)) != 0)
+        return -1;
+    return dayu_collector_write(sock, payload, len);
+}
+
+// Socket of the node's collector with the stream announced, -1 when there
+// is none listening
+static int dayu_collector_connect(const char* path)
+{
+    const char* env = getenv(DAYU_COLLECTOR_ENV);
+    const char* workflow = getenv("WORKFLOW_NAME");
+    struct sockaddr_un addr;
+    char* hello;
+    size_t hello_len;
+    uint32_t pid = (uint32_t)getpid();
+    int sock;
+
+    if(env && (strcmp(env, "off") == 0 || strcmp(env, "0") == 0))
+        return -1;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if(env && *env)
+        snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", env);
+    else
+        snprintf(addr.sun_path, sizeof(addr.sun_path), DAYU_COLLECTOR_SOCKET, (unsigned)getuid());
+    if(!workflow || !*workflow)
+        workflow = "workflow";
+
+    sock = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if(sock < 0)
+        return -1;
+    // a Unix socket connects at once or fails, a full backlog counts as absent
+    if(connect(sock, (struct sockaddr*)&addr, sizeof(addr)) != 0){
+        close(sock);
+        return -1;
+    }
+
+    hello_len = sizeof(pid) + strlen(workflow) + 1 + strlen(path) + 1;
+    hello = (char*)malloc(hello_len);
+    if(!hello){
+        close(sock);
+        return -1;
+    }
+    memcpy(hello, &pid, sizeof(pid));
+    strcpy(hello + sizeof(pid), workflow);
+    strcpy(hello + sizeof(pid) + strlen(workflow) + 1, path);
+    if(dayu_collector_send(sock, DAYU_MSG_HELLO, hello, hello_len) != 0){
+        close(sock);
+        sock = -1;
+    }
+    free(hello);
+    return sock;
+}
+
+// The collector stopped taking records, the rest of the stream goes to the
+// sink's own file. locked is set when the caller holds the mutex.
+static void dayu_sink_fallback(dayu_sink_t* sink, int locked)
+{
+    FILE* fh;
+
+    fprintf(stderr, "dayu_sink_emit(): collector gone, writing %s\n", sink->path);
+    fh = fopen(sink->path, dayu_sink_reopen(sink->path) ? "a" : "w");
+    if(!fh)
+        fprintf(stderr, "dayu_sink_emit(): failed to open %s: %s\n", sink->path, strerror(errno));
+    close(sink->sock);
+    if(!locked)
+        pthread_mutex_lock(&sink->mutex);
+    sink->fh = fh;
+    sink->sock = -1;
+    sink->to_collector = 0;
+    if(!locked)
+        pthread_mutex_unlock(&sink->mutex);
+}
+
+// Write one batch to the file. Only the writer thread, or the caller when
+// there is no writer, gets here; locked is set when it holds the mutex.
+static void dayu_sink_emit(dayu_sink_t* sink, const char* data, size_t len, int locked)
+{
+    if(len == 0)
+        return;
+
+    if(sink->to_collector){
+        if(dayu_collector_send(sink->sock, DAYU_MSG_DATA, data, len) == 0){
+            __atomic_fetch_add(&sink->raw_bytes, len, __ATOMIC_RELAXED);
+            __atomic_fetch_add(&sink->stored_bytes, len, __ATOMIC_RELAXED);
+            return;
+        }
+        dayu_sink_fallback(sink, locked);
+    }
+    if(!sink->fh)
+        return; // fallback file could not be opened, the batch is dropped
+
+    // stats are read by dayu_sink_codec_log() while the writer runs
+    __atomic_fetch_add(&sink->raw_bytes, len, __ATOMIC_RELAXED);
+    if(sink->codec != DAYU_SINK_PLAIN){
+        unsigned long start = dayu_thread_cpu_usec();
+        size_t frame_len = dayu_sink_compress(sink, data, len);
+
+        __atomic_fetch_add(&sink->codec_usec, dayu_thread_cpu_usec() - start, __ATOMIC_RELAXED);
+        if(frame_len == 0){
+            fprintf(stderr, "dayu_sink_emit(): compression failed, %zu bytes dropped\n", len);
+            return;
+        }
+        data = sink->frame;
+        len = frame_len;
+        __atomic_fetch_add(&sink->frames, 1, __ATOMIC_RELAXED);
+    }
+    fwrite(data, 1, len, sink->fh);
+    fflush(sink->fh);
+    __atomic_fetch_add(&sink->stored_bytes, len, __ATOMIC_RELAXED);
+}
+
+// Background writer: swaps the pending buffer out under the lock and
+// writes it without holding it, so producers never wait on the disk.
+static void* dayu_sink_writer(void* arg)
+{
+    dayu_sink_t* sink = (dayu_sink_t*)arg;
+    char* batch = NULL;
+    size_t batch_cap = 0;
+
+    pthread_mutex_lock(&sink->mutex);
+    for(;;){
+        while(!sink->stop && sink->buf_len < sink->flush_bytes){
+            struct timespec ts;
+            clock_gettime(CLOCK_REALTIME, &ts);
+            ts.tv_sec += DAYU_SINK_FLUSH_SEC;
+            if(pthread_cond_timedwait(&sink->cond, &sink->mutex, &ts) == ETIMEDOUT)
+                break;
+        }
+
+        if(sink->buf_len > 0){
+            char* pending = sink->buf;
+            size_t pending_cap = sink->buf_cap;
+            size_t pending_len = sink->buf_len;
+
+            sink->buf = batch;
+            sink->buf_cap = batch_cap;
+            sink->buf_len = 0;
+            batch = pending;
+            batch_cap = pending_cap;
+
+            pthread_mutex_unlock(&sink->mutex);
+            dayu_sink_emit(sink, batch, pending_len, 0);
+            pthread_mutex_lock(&sink->mutex);
+        }
+        else if(sink->stop)
+            break;
+    }
+    pthread_mutex_unlock(&sink->mutex);
+
+    free(batch);
+    return NULL;
+}
+
+// Append raw bytes to the pending buffer, called with the mutex held
+static int dayu_sink_append(dayu_sink_t* sink, const char* data, size_t len)
+{
+    if(sink->buf_len + len > sink->buf_cap){
+        size_t new_cap = sink->buf_cap ? sink->buf_cap : sink->flush_bytes;
+        while(sink->buf_len + len > new_cap)
+            new_cap *= 2;
+        char* new_buf = (char*)realloc(sink->buf, new_cap);
+        if(!new_buf)
+            return -1;
+        sink->buf = new_buf;
+        sink->buf_cap = new_cap;
+    }
+    memcpy(sink->buf + sink->buf_len, data, len);
+    sink->buf_len += len;
+    return 0;
+}
+
+int dayu_sink_open(dayu_sink_t* sink, const char* path)
+{
+    const char* fmt_env = getenv("TRACKER_LOG_FORMAT");
+    const char* flush_env = getenv("TRACKER_LOG_FLUSH_BYTES");
+    const char* codec_env = getenv("TRACKER_LOG_COMPRESS");
+    const char* level_env = getenv("TRACKER_LOG_COMPRESS_LEVEL");
+    char* full_path;
+
+    memset(sink, 0, sizeof(dayu_sink_t));
+    sink->sock = -1;
+    sink->jsonl = (fmt_env && strcmp(fmt_env, "jsonl") == 0);
+
+    sink->codec = DAYU_SINK_PLAIN;
+    if(codec_env && strcmp(codec_env, "gzip") == 0)
+        sink->codec = DAYU_SINK_GZIP;
+    else if(codec_env && strcmp(codec_env, "zstd") == 0){
+#ifdef DAYU_HAVE_ZSTD
+        sink->codec = DAYU_SINK_ZSTD;
+#else
+        fprintf(stderr, "dayu_sink_open(): built without zstd, using gzip\n");
+        sink->codec = DAYU_SINK_GZIP;
+#endif
+    }
+    if(sink->codec == DAYU_SINK_GZIP)
+        sink->level = 6; // zlib's default
+#ifdef DAYU_HAVE_ZSTD
+    else if(sink->codec == DAYU_SINK_ZSTD)
+        sink->level = ZSTD_CLEVEL_DEFAULT;
+#endif
+    if(level_env && *level_env)
+        sink->level = atoi(level_env);
+    if(sink->codec != DAYU_SINK_PLAIN && dayu_sink_codec_init(sink) != 0){
+        fprintf(stderr, "dayu_sink_open(): compressor init failed, writing plain text\n");
+        sink->codec = DAYU_SINK_PLAIN;
+    }
+
+    sink->flush_bytes = sink->codec == DAYU_SINK_PLAIN ? DAYU_SINK_FLUSH_BYTES : DAYU_SINK_ZFLUSH_BYTES;
+    if(flush_env && atol(flush_env) > 0)
+        sink->flush_bytes = (size_t)atol(flush_env);
+
+    // records are merged per node, the collector takes them as plain JSON Lines
+    sink->sock = dayu_collector_connect(path);
+    if(sink->sock >= 0){
+        dayu_sink_codec_free(sink);
+        sink->codec = DAYU_SINK_PLAIN;
+        sink->jsonl = 1;
+        sink->to_collector = 1;
+        sink->path = strdup(path);
+        if(!sink->path){
+            fprintf(stderr, "dayu_sink_open(): out of memory\n");
+            close(sink->sock);
+            return -1;
+        }
+    }
+    else {
+        full_path = (char*)malloc(strlen(path) + 5);
+        if(!full_path){
+            fprintf(stderr, "dayu_sink_open(): out of memory\n");
+            dayu_sink_codec_free(sink);
+            return -1;
+        }
+        strcpy(full_path, path);
+        if(sink->codec == DAYU_SINK_GZIP)
+            strcat(full_path, ".gz");
+        else if(sink->codec == DAYU_SINK_ZSTD)
+            strcat(full_path, ".zst");
+
+        sink->fh = fopen(full_path, dayu_sink_reopen(full_path) ? "a" : "w");
+        if(!sink->fh){
+            fprintf(stderr, "dayu_sink_open(): failed to open %s: %s\n", full_path, strerror(errno));
+            free(full_path);
+            dayu_sink_codec_free(sink);
+            return -1;
+        }
+        free(full_path);
+    }
+
+    // the array opens with the first batch, so compressed output starts with a frame
+    if(!sink->jsonl)
+        dayu_sink_append(sink, "[\n", 2);
+
+    pthread_mutex_init(&sink->mutex, NULL);
+    pthread_cond_init(&sink->cond, NULL);
+    sink->opened = 1;
+    if(pthread_create(&sink->writer, NULL, dayu_sink_writer, sink) == 0)
+        sink->running = 1;
+    else
+        fprintf(stderr, "dayu_sink_open(): no writer thread, logging inline\n");
+
+    return 0;
+}
+
+// Queue one complete JSON object. In JSON Lines mode the pretty-printed
+// record is folded onto a single line.
+void dayu_sink_put(dayu_sink_t* sink, const char* rec, size_t len)
+{
+    if(!sink->opened || !rec || len == 0)
+        return;
+
+    pthread_mutex_lock(&sink->mutex);
+    if(!sink->fh && !sink->to_collector){
+        pthread_mutex_unlock(&sink->mutex);
+        return;
+    }
+
+    if(sink->buf_len + len + 3 > sink->buf_cap){
+        size_t new_cap = sink->buf_cap ? sink->buf_cap : sink->flush_bytes;
+        while(sink->buf_len + len + 3 > new_cap)
+            new_cap *= 2;
+        char* new_buf = (char*)realloc(sink->buf, new_cap);
+        if(!new_buf){
+            fprintf(stderr, "dayu_sink_put(): out of memory, record dropped\n");
+            pthread_mutex_unlock(&sink->mutex);
+            return;
+        }
+        sink->buf = new_buf;
+        sink->buf_cap = new_cap;
+    }
+
+    if(sink->jsonl){
+        size_t i = 0;
+        while(i < len){
+            if(rec[i] == '\n'){
+                // drop the newline and the indentation that follows it
+                i++;
+                while(i < len && (rec[i] == ' ' || rec[i] == '\t'))
+                    i++;
+                continue;
+            }
+            sink->buf[sink->buf_len++] = rec[i++];
+        }
+        sink->buf[sink->buf_len++] = '\n';
+    }
+    else {
+        if(sink->records > 0){
+            sink->buf[sink->buf_len++] = ',';
+            sink->buf[sink->buf_len++] = '\n';
+        }
+        memcpy(sink->buf + sink->buf_len, rec, len);
+        sink->buf_len += len;
+    }
+    sink->records++;
+
+    if(!sink->running){
+        dayu_sink_emit(sink, sink->buf, sink->buf_len, 1);
+        sink->buf_len = 0;
+    }
+    else if(sink->buf_len >= sink->flush_bytes)
+        pthread_cond_signal(&sink->cond);
+
+    pthread_mutex_unlock(&sink->mutex);
+}
+
+// Records are formatted into an open_memstream() stream, then handed over.
+void dayu_sink_record_end(dayu_sink_t* sink, FILE* rec_stream, char** rec, size_t* rec_len)
+{
+    fclose(rec_stream);
+    dayu_sink_put(sink, *rec, *rec_len);
+    free(*rec);
+    *rec = NULL;
+    *rec_len = 0;
+}
+
+// Last record of a compressed file: what the compression cost and saved
+// for everything before it
+static void dayu_sink_codec_log(dayu_sink_t* sink)
+{
+    char* rec = NULL;
+    size_t rec_len = 0;
+    unsigned long raw, stored, usec, frames;
+    FILE* f;
+
+    raw = __atomic_load_n(&sink->raw_bytes, __ATOMIC_RELAXED);
+    stored = __atomic_load_n(&sink->stored_bytes, __ATOMIC_RELAXED);
+    usec = __atomic_load_n(&sink->codec_usec, __ATOMIC_RELAXED);
+    frames = __atomic_load_n(&sink->frames, __ATOMIC_RELAXED);
+
+    f = open_memstream(&rec, &rec_len);
+    fprintf(f, "{\n    \"Log-Sink\": {\n");
+    fprintf(f, "        \"codec\": \"%s\",\n", sink->codec == DAYU_SINK_GZIP ? "gzip" : "zstd");
+    fprintf(f, "        \"level\": %d,\n", sink->level);
+    fprintf(f, "        \"frames\": %lu,\n", frames);
+    fprintf(f, "        \"raw_bytes\": %lu,\n", raw);
+    fprintf(f, "        \"stored_bytes\": %lu,\n", stored);
+    fprintf(f, "        \"saved_bytes\": %ld,\n", (long)(raw - stored));
+    fprintf(f, "        \"ratio\": %.3f,\n", stored ? (double)raw / stored : 0.0);
+    fprintf(f, "        \"compress_cpu(us)\": %lu,\n", usec);
+    fprintf(f, "        \"cpu_us_per_saved_MB\": %.1f\n", raw > stored ? usec * 1048576.0 / (raw - stored) : 0.0);
+    fprintf(f, "    }\n}");
+    dayu_sink_record_end(sink, f, &rec, &rec_len);
+}
+
+// Drain the writer and close the array, no tail rewrite needed. The writer
+// is stopped even when the file is gone, e.g. a failed fallback open.
+void dayu_sink_close(dayu_sink_t* sink)
+{
+    if(!sink->opened)
+        return;
+
+    pthread_mutex_lock(&sink->mutex);
+    sink->stop = 1;
+    pthread_cond_signal(&sink->cond);
+    pthread_mutex_unlock(&sink->mutex);
+
+    if(sink->running)
+        pthread_join(sink->writer, NULL);
+    sink->running = 0;
+
+    // from here on records are written inline
+    dayu_sink_emit(sink, sink->buf, sink->buf_len, 0);
+    sink->buf_len = 0;
+    if(sink->codec != DAYU_SINK_PLAIN)
+        dayu_sink_codec_log(sink);
+    if(!sink->jsonl)
+        dayu_sink_emit(sink, "\n]\n", 3, 0);
+
+    if(sink->to_collector){
+        dayu_collector_send(sink->sock, DAYU_MSG_END, NULL, 0);
+        close(sink->sock);
+        sink->sock = -1;
+        sink->to_collector = 0;
+    }
+    if(sink->fh)
+        fclose(sink->fh);
+    sink->fh = NULL;
+    free(sink->path);
+    sink->path = NULL;
+    free(sink->buf);
+    sink->buf = NULL;
+    sink->buf_len = sink->buf_cap = 0;
+    dayu_sink_codec_free(sink);
+    free(sink->frame);
+    sink->frame = NULL;
+    sink->frame_cap = 0;
+
+    pthread_cond_destroy(&sink->cond);
+    pthread_mutex_destroy(&sink->mutex);
+    sink->opened = 0;
+}
+/* Output sink implementation end */
+
+
+/* Incremental flush implementation start */
+static unsigned long DAYU_FLUSH_SIGNALS = 0;
+static pthread_once_t DAYU_FLUSH_SIG_ONCE = PTHREAD_ONCE_INIT;
+
+static void dayu_flush_on_signal(int sig)
+{
+    (void)sig;
+    __atomic_add_fetch(&DAYU_FLUSH_SIGNALS, 1, __ATOMIC_RELAXED);
+}
+
+// Once per process for both plugins, a handler set by the application is kept
+static void dayu_flush_sig_install(void)
+{
+    struct sigaction old, sa;
+
+    if(sigaction(SIGUSR1, NULL, &old) != 0)
+        return;
+    if((old.sa_flags & SA_SIGINFO) || old.sa_handler != SIG_DFL){
+        fprintf(stderr, "dayu_flush_init(): SIGUSR1 is already handled, flush on signal disabled\n");
+        return;
+    }
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = dayu_flush_on_signal;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESTART;
+    if(sigaction(SIGUSR1, &sa, NULL) != 0)
+        fprintf(stderr, "dayu_flush_init(): sigaction failed: %s\n", strerror(errno));
+}
+
+void dayu_flush_init(dayu_flush_t* fl)
+{
+    const char* interval_env = getenv("TRACKER_FLUSH_INTERVAL");
+    const char* bytes_env = getenv("TRACKER_FLUSH_BYTES");
+    const char* signal_env = getenv("TRACKER_FLUSH_SIGNAL");
+
+    memset(fl, 0, sizeof(*fl));
+    if(interval_env && atof(interval_env) > 0)
+        fl->interval_usec = (unsigned long)(atof(interval_env) * 1000000);
+    if(bytes_env && strtoul(bytes_env, NULL, 10) > 0)
+        fl->max_bytes = strtoul(bytes_env, NULL, 10);
+    if(signal_env && strcmp(signal_env, "1") == 0){
+        pthread_once(&DAYU_FLUSH_SIG_ONCE, dayu_flush_sig_install);
+        fl->enabled = 1;
+    }
+    if(fl->interval_usec || fl->max_bytes)
+        fl->enabled = 1;
+    fl->last_usec = dayu_time_usec();
+    fl->signals_seen = __atomic_load_n(&DAYU_FLUSH_SIGNALS, __ATOMIC_RELAXED);
+}
+
+int dayu_flush_due(dayu_flush_t* fl, size_t held_bytes)
+{
+    if(!fl->enabled)
+        return 0;
+    if(fl->max_bytes && held_bytes >= fl->max_bytes)
+        return 1;
+    if(__atomic_load_n(&DAYU_FLUSH_SIGNALS, __ATOMIC_RELAXED) != fl->signals_seen)
+        return 1;
+    return fl->interval_usec && dayu_time_usec() - fl->last_usec >= fl->interval_usec;
+}
+
+unsigned long dayu_flush_done(dayu_flush_t* fl)
+{
+    fl->last_usec = dayu_time_usec();
+    fl->signals_seen = __atomic_load_n(&DAYU_FLUSH_SIGNALS, __ATOMIC_RELAXED);
+    return ++fl->seq;
+}
+/* Incremental flush implementation end */
+
+
+/* Memory budget implementation start */
+typedef struct {
+    unsigned long time;
+    unsigned long used;
+    const char* event;
+    const char* who;
+} dayu_mem_event_t;
+
+static const char* DAYU_MEM_LEVEL_NAME[] = {"ok", "coarsen", "sample", "spill"};
+static const char* DAYU_MEM_ACTION_NAME[DAYU_MEM_NACTIONS] = {"merged_ranges", "sampled_ranges",
+    "dropped_detail", "spills"};
+
+static unsigned long DAYU_MEM_BUDGET = 0;        // 0: unbounded, usage is still reported
+static unsigned long DAYU_MEM_AT[DAYU_MEM_SPILL + 1]; // usage where each level starts
+static long DAYU_MEM_USED = 0;
+static unsigned long DAYU_MEM_HWM = 0;
+static int DAYU_MEM_LEVEL = DAYU_MEM_OK;
+static unsigned long DAYU_MEM_ACTIONS[DAYU_MEM_NACTIONS];
+static dayu_mem_event_t DAYU_MEM_EVENTS[DAYU_MEM_EVENTS_MAX];
+static int DAYU_MEM_EVENT_CNT = 0;
+static unsigned long DAYU_MEM_EVENTS_DROPPED = 0;
+static pthread_mutex_t DAYU_MEM_MUTEX = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t DAYU_MEM_ONCE = PTHREAD_ONCE_INIT;
+
+// TRACKER_MEM_BUDGET in bytes, or with a K, M or G suffix
+static void dayu_mem_init(void)
+{
+    const char* budget_env = getenv("TRACKER_MEM_BUDGET");
+    char* end = NULL;
+    unsigned long budget;
+
+    if(!budget_env)
+        return;
+    budget = strtoul(budget_env, &end, 10);
+    switch(end ? *end : '\0'){
+        case 'g': case 'G': budget <<= 30; break;
+        case 'm': case 'M': budget <<= 20; break;
+        case 'k': case 'K': budget <<= 10; break;
+        default: break;
+    }
+    DAYU_MEM_BUDGET = budget;
+    DAYU_MEM_AT[DAYU_MEM_COARSEN] = budget / 100 * DAYU_MEM_COARSEN_PCT;
+    DAYU_MEM_AT[DAYU_MEM_SAMPLE] = budget / 100 * DAYU_MEM_SAMPLE_PCT;
+    DAYU_MEM_AT[DAYU_MEM_SPILL] = budget / 100 * DAYU_MEM_SPILL_PCT;
+}
+
+static void dayu_mem_event(const char* event, const char* who)
+{
+    pthread_mutex_lock(&DAYU_MEM_MUTEX);
+    if(DAYU_MEM_EVENT_CNT < DAYU_MEM_EVENTS_MAX){
+        dayu_mem_event_t* ev = &DAYU_MEM_EVENTS[DAYU_MEM_EVENT_CNT++];
+        ev->time = dayu_time_usec();
+        ev->used = (unsigned long)__atomic_load_n(&DAYU_MEM_USED, __ATOMIC_RELAXED);
+        ev->event = event;
+        ev->who = who;
+    } else {
+        DAYU_MEM_EVENTS_DROPPED++;
+    }
+    pthread_mutex_unlock(&DAYU_MEM_MUTEX);
+}
+
+void dayu_mem_charge(long bytes)
+{
+    long used = __atomic_add_fetch(&DAYU_MEM_USED, bytes, __ATOMIC_RELAXED);
+    unsigned long hwm = __atomic_load_n(&DAYU_MEM_HWM, __ATOMIC_RELAXED);
+
+    while(used > 0 && (unsigned long)used > hwm &&
+        !__atomic_compare_exchange_n(&DAYU_MEM_HWM, &hwm, (unsigned long)used, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+}
+
+dayu_mem_level_t dayu_mem_level(void)
+{
+    long used = __atomic_load_n(&DAYU_MEM_USED, __ATOMIC_RELAXED);
+    int level = DAYU_MEM_OK;
+
+    pthread_once(&DAYU_MEM_ONCE, dayu_mem_init);
+    if(DAYU_MEM_BUDGET == 0)
+        return DAYU_MEM_OK;
+    while(level < DAYU_MEM_SPILL && used >= (long)DAYU_MEM_AT[level + 1])
+        level++;
+    // level changes are rare, each one is reported
+    if(__atomic_exchange_n(&DAYU_MEM_LEVEL, level, __ATOMIC_RELAXED) != level)
+        dayu_mem_event(DAYU_MEM_LEVEL_NAME[level], "level");
+    return (dayu_mem_level_t)level;
+}
+
+unsigned long dayu_mem_used(void)
+{
+    long used = __atomic_load_n(&DAYU_MEM_USED, __ATOMIC_RELAXED);
+    return used > 0 ? (unsigned long)used : 0;
+}
+
+void dayu_mem_degraded(dayu_mem_action_t action, const char* who)
+{
+    if(__atomic_fetch_add(&DAYU_MEM_ACTIONS[action], 1, __ATOMIC_RELAXED) == 0 || action == DAYU_MEM_SPILLED)
+        dayu_mem_event(DAYU_MEM_ACTION_NAME[action], who);
+}
+
+void dayu_mem_log(dayu_sink_t* sink)
+{
+    char* rec = NULL;
+    size_t rec_len = 0;
+    FILE* f;
+
+    pthread_once(&DAYU_MEM_ONCE, dayu_mem_init);
+    f = open_memstream(&rec, &rec_len);
+    fprintf(f, "{\n    \"Memory-Budget\": {\n");
+    fprintf(f, "        \"budget\": %lu,\n", DAYU_MEM_BUDGET);
+    fprintf(f, "        \"used\": %lu,\n", dayu_mem_used());
+    fprintf(f, "        \"high_water\": %lu,\n", __atomic_load_n(&DAYU_MEM_HWM, __ATOMIC_RELAXED));
+    for(int a = 0; a < DAYU_MEM_NACTIONS; a++)
+        fprintf(f, "        \"%s\": %lu,\n", DAYU_MEM_ACTION_NAME[a], __atomic_load_n(&DAYU_MEM_ACTIONS[a], __ATOMIC_RELAXED));
+    fprintf(f, "        \"events\": [");
+    pthread_mutex_lock(&DAYU_MEM_MUTEX);
+    for(int e = 0; e < DAYU_MEM_EVENT_CNT; e++){
+        const dayu_mem_event_t* ev = &DAYU_MEM_EVENTS[e];
+        fprintf(f, "%s\n            {\"time(us)\": %lu, \"event\": \"%s\", \"by\": \"%s\", \"used\": %lu}",
+            e ? "," : "", ev->time, ev->event, ev->who, ev->used);
+    }
+    fprintf(f, "%s],\n", DAYU_MEM_EVENT_CNT ? "\n        " : "");
+    fprintf(f, "        \"events_dropped\": %lu\n", DAYU_MEM_EVENTS_DROPPED);
+    pthread_mutex_unlock(&DAYU_MEM_MUTEX);
+    fprintf(f, "    }\n}");
+    dayu_sink_record_end(sink, f, &rec, &rec_len);
+}
+
+void dayu_mem_log_col(dayu_col_writer_t* w)
+{
+    static const char* event_cols[] = {"time(us)", "event", "by", "used"};
+    static const dayu_col_type_t event_types[] = {DAYU_COL_U64, DAYU_COL_STR, DAYU_COL_STR, DAYU_COL_U64};
+    const char* budget_cols[DAYU_MEM_NACTIONS + 4];
+    dayu_col_type_t budget_types[DAYU_MEM_NACTIONS + 4];
+    dayu_col_val_t row[DAYU_MEM_NACTIONS + 4];
+    dayu_col_table_t* budget;
+    dayu_col_table_t* events;
+    int n = 0;
+
+    pthread_once(&DAYU_MEM_ONCE, dayu_mem_init);
+    budget_cols[n] = "budget";
+    row[n++].u = DAYU_MEM_BUDGET;
+    budget_cols[n] = "used";
+    row[n++].u = dayu_mem_used();
+    budget_cols[n] = "high_water";
+    row[n++].u = __atomic_load_n(&DAYU_MEM_HWM, __ATOMIC_RELAXED);
+    for(int a = 0; a < DAYU_MEM_NACTIONS; a++){
+        budget_cols[n] = DAYU_MEM_ACTION_NAME[a];
+        row[n++].u = __atomic_load_n(&DAYU_MEM_ACTIONS[a], __ATOMIC_RELAXED);
+    }
+    budget_cols[n++] = "events_dropped";
+    for(int c = 0; c < n; c++)
+        budget_types[c] = DAYU_COL_U64;
+
+    budget = dayu_col_table(w, "mem_budget", n, budget_cols, budget_types);
+    events = dayu_col_table(w, "mem_event", 4, event_cols, event_types);
+    if(!budget || !events)
+        return;
+
+    pthread_mutex_lock(&DAYU_MEM_MUTEX);
+    row[n - 1].u = DAYU_MEM_EVENTS_DROPPED;
+    dayu_col_append(budget, row);
+    for(int e = 0; e < DAYU_MEM_EVENT_CNT; e++){
+        const dayu_mem_event_t* ev = &DAYU_MEM_EVENTS[e];
+        dayu_col_val_t erow[4];
+
+        erow[0].u = ev->time;
+        erow[1].s = ev->event;
+        erow[2].s = ev->who;
+        erow[3].u = ev->used;
+        dayu_col_append(events, erow);
+    }
+    pthread_mutex_unlock(&DAYU_MEM_MUTEX);
+}
+/* Memory budget implementation end */
+
+
+/* Live stats implementation start */
+static dayu_live_region_t* DAYU_LIVE = NULL;
+static char DAYU_LIVE_SHM_NAME[64];
+static int DAYU_LIVE_INIT = 0;
+static pthread_mutex_t DAYU_LIVE_MUTEX = PTHREAD_MUTEX_INITIALIZER;
+
+// Last DAYU_LIVE_NAME - 1 bytes of src, the distinguishing end of a path
+static const char* dayu_live_tail(const char* src)
+{
+    size_t len = strlen(src);
+    return len >= DAYU_LIVE_NAME ? src + len - (DAYU_LIVE_NAME - 1) : src;
+}
+
+static void dayu_live_copy(char* dst, const char* src)
+{
+    strncpy(dst, dayu_live_tail(src), DAYU_LIVE_NAME - 1);
+    dst[DAYU_LIVE_NAME - 1] = '\0';
+}
+
+// FNV-1a of the full name, slots are matched on it rather than the tail
+static uint64_t dayu_live_hash(const char* src)
+{
+    uint64_t h = 0xcbf29ce484222325ull;
+
+    for(; *src; src++)
+        h = (h ^ (unsigned char)*src) * 0x100000001b3ull;
+    return h;
+}
+
+// A forked child leaves its parent's region alone and maps its own
+static void dayu_live_atfork_child(void)
+{
+    if(DAYU_LIVE)
+        munmap(DAYU_LIVE, sizeof(dayu_live_region_t));
+    DAYU_LIVE = NULL;
+    DAYU_LIVE_INIT = 0;
+    pthread_mutex_init(&DAYU_LIVE_MUTEX, NULL);
+}
+
+static void dayu_live_map(void)
+{
+    const char* env = getenv(DAYU_LIVE_ENV);
+    const char* workflow = getenv("WORKFLOW_NAME");
+    dayu_live_region_t* live;
+    int fd;
+
+    DAYU_LIVE_INIT = 1;
+    if(!env || !*env || strcmp(env, "0") == 0 || strcmp(env, "off") == 0)
+        return;
+    snprintf(DAYU_LIVE_SHM_NAME, sizeof(DAYU_LIVE_SHM_NAME), DAYU_LIVE_SHM, (unsigned)getuid(), (int)getpid());
+    fd = shm_open(DAYU_LIVE_SHM_NAME, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0){
+        fprintf(stderr, "dayu_live: cannot create %s: %s\n", DAYU_LIVE_SHM_NAME, strerror(errno));
+        return;
+    }
+    if(ftruncate(fd, sizeof(dayu_live_region_t)) != 0){
+        fprintf(stderr, "dayu_live: cannot size %s: %s\n", DAYU_LIVE_SHM_NAME, strerror(errno));
+        close(fd);
+        shm_unlink(DAYU_LIVE_SHM_NAME);
+        return;
+    }
+    live = (dayu_live_region_t*)mmap(NULL, sizeof(dayu_live_region_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if(live == MAP_FAILED){
+        fprintf(stderr, "dayu_live: cannot map %s: %s\n", DAYU_LIVE_SHM_NAME, strerror(errno));
+        shm_unlink(DAYU_LIVE_SHM_NAME);
+        return;
+    }
+
+    // zero filled by ftruncate, magic goes last so readers see a whole header
+    live->version = DAYU_LIVE_VERSION;
+    live->nfiles = DAYU_LIVE_FILES;
+    live->pid = (int32_t)getpid();
+    live->start_usec = dayu_time_usec();
+    dayu_live_copy(live->workflow, workflow ? workflow : "");
+    __atomic_store_n(&live->magic, DAYU_LIVE_MAGIC, __ATOMIC_RELEASE);
+    __atomic_store_n(&DAYU_LIVE, live, __ATOMIC_RELEASE);
+    pthread_atfork(NULL, NULL, dayu_live_atfork_child);
+}
+
+__attribute__((destructor))
+static void dayu_live_unmap(void)
+{
+    dayu_live_region_t* live = __atomic_exchange_n(&DAYU_LIVE, NULL, __ATOMIC_ACQ_REL);
+
+    if(!live)
+        return;
+    shm_unlink(DAYU_LIVE_SHM_NAME);
+    munmap(live, sizeof(dayu_live_region_t));
+}
+
+// Seqlock writer side, writers exclude each other on the odd count
+static uint32_t dayu_live_begin(dayu_live_file_t* f)
+{
+    uint32_t seq = __atomic_load_n(&f->seq, __ATOMIC_RELAXED);
+
+    for(;;){
+        if(!(seq & 1) && __atomic_compare_exchange_n(&f->seq, &seq, seq + 1, 1, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+            return seq + 1;
+        seq = __atomic_load_n(&f->seq, __ATOMIC_RELAXED);
+    }
+}
+
+static void dayu_live_end(dayu_live_file_t* f, uint32_t seq)
+{
+    __atomic_store_n(&f->seq, seq + 1, __ATOMIC_RELEASE);
+}
+
+int dayu_live_file_open(const char* file_name)
+{
+    dayu_live_region_t* live;
+    dayu_live_file_t* f;
+    char* task = NULL;
+    int slot = -1;
+    uint64_t hash;
+    uint32_t seq;
+
+    if(!file_name)
+        return -1;
+    pthread_mutex_lock(&DAYU_LIVE_MUTEX);
+    if(!DAYU_LIVE_INIT)
+        dayu_live_map();
+    live = DAYU_LIVE;
+    if(!live){
+        pthread_mutex_unlock(&DAYU_LIVE_MUTEX);
+        return -1;
+    }
+
+    // the other plugin may have the file open already, else take a free
+    // slot or the one closed longest ago
+    hash = dayu_live_hash(file_name);
+    for(int i = 0; i < DAYU_LIVE_FILES; i++){
+        f = &live->files[i];
+        if(f->state == DAYU_LIVE_OPEN && f->file_hash == hash && strcmp(f->file_name, dayu_live_tail(file_name)) == 0){
+            seq = dayu_live_begin(f);
+            f->opens++;
+            dayu_live_end(f, seq);
+            pthread_mutex_unlock(&DAYU_LIVE_MUTEX);
+            return i;
+        }
+        if(f->state == DAYU_LIVE_FREE && (slot < 0 || live->files[slot].state != DAYU_LIVE_FREE))
+            slot = i;
+        else if(f->state == DAYU_LIVE_CLOSED
+                && (slot < 0 || (live->files[slot].state == DAYU_LIVE_CLOSED
+                                 && f->close_usec < live->files[slot].close_usec)))
+            slot = i;
+    }
+    if(slot < 0){
+        live->files_dropped++;
+        pthread_mutex_unlock(&DAYU_LIVE_MUTEX);
+        return -1;
+    }
+
+    f = &live->files[slot];
+    dayu_task_name(&task);
+    seq = dayu_live_begin(f);
+    memset(f->io, 0, sizeof(f->io));
+    dayu_live_copy(f->file_name, file_name);
+    f->file_hash = hash;
+    f->dset_hash = 0;
+    snprintf(f->task_name, DAYU_LIVE_NAME, "%s-%d", task ? task : "", (int)getpid());
+    f->dset_name[0] = '\0';
+    f->state = DAYU_LIVE_OPEN;
+    f->opens = 1;
+    f->open_usec = dayu_time_usec();
+    f->close_usec = 0;
+    f->last_usec = 0;
+    dayu_live_end(f, seq);
+    pthread_mutex_unlock(&DAYU_LIVE_MUTEX);
+    free(task);
+    return slot;
+}
+
+void dayu_live_file_close(int slot)
+{
+    dayu_live_file_t* f;
+    uint32_t seq;
+
+    if(slot < 0 || slot >= DAYU_LIVE_FILES)
+        return;
+    pthread_mutex_lock(&DAYU_LIVE_MUTEX);
+    if(DAYU_LIVE){
+        f = &DAYU_LIVE->files[slot];
+        seq = dayu_live_begin(f);
+        if(f->opens > 0 && --f->opens == 0){
+            f->state = DAYU_LIVE_CLOSED;
+            f->close_usec = dayu_time_usec();
+        }
+        dayu_live_end(f, seq);
+    }
+    pthread_mutex_unlock(&DAYU_LIVE_MUTEX);
+}
+
+void dayu_live_io(int slot, int layer, int write, uint64_t bytes, unsigned long usec, const char* dset_name)
+{
+    dayu_live_region_t* live = __atomic_load_n(&DAYU_LIVE, __ATOMIC_ACQUIRE);
+    dayu_live_file_t* f;
+    dayu_live_io_t* io;
+    int bucket = usec ? 64 - __builtin_clzl(usec) : 0;
+    uint32_t seq;
+
+    if(!live || slot < 0 || slot >= DAYU_LIVE_FILES || layer < 0 || layer >= DAYU_LIVE_NLAYERS)
+        return;
+    if(bucket >= DAYU_LIVE_HIST)
+        bucket = DAYU_LIVE_HIST - 1;
+    f = &live->files[slot];
+    seq = dayu_live_begin(f);
+    io = &f->io[layer][write != 0];
+    io->ops++;
+    io->bytes += bytes;
+    io->usec += usec;
+    io->hist[bucket]++;
+    if(dset_name && *dset_name){
+        uint64_t hash = dayu_live_hash(dset_name);
+        if(f->dset_hash != hash){
+            dayu_live_copy(f->dset_name, dset_name);
+            f->dset_hash = hash;
+        }
+    }
+    f->last_usec = dayu_time_usec();
+    dayu_live_end(f, seq);
+}
+/* Live stats implementation end */
@@ -0,0 +1,189 @@
+#ifndef DAYU_CORE_H
+#define DAYU_CORE_H
+
+// Shared in-process core of the tracker. Both h5vol_tracker and
+// h5vfd_tracker link libdayu_core, so when the two plugins are loaded in
+// one process they see the same context and dataset registry through plain
+// function calls.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "dayu_live.h"
+#include "dayu_colstat.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DAYU_NAME_MAX 256               // longest object name kept in a context
+#define DAYU_REGISTRY_MAX (1 << 20)     // dataset extents kept in the registry
+#define DAYU_REGISTRY_DELTA 1024        // extents added per file before a merge
+#define DAYU_SINK_FLUSH_BYTES (64 * 1024) // default pending bytes before the writer is woken
+#define DAYU_SINK_FLUSH_SEC 1           // writer drains pending records at least this often
+#define DAYU_SINK_ZFLUSH_BYTES (1024 * 1024) // default when compressing, frame size drives the ratio
+
+/* Clock */
+// Wall clock in microseconds since the epoch, the time base of every record
+unsigned long dayu_time_usec(void);
+
+/* Intern table */
+// Stable copy of str, equal strings give the same pointer for the process
+// lifetime so they can be compared and hashed by address
+const char* dayu_intern(const char* str);
+
+/* Task name */
+// Name of the running task: CURR_TASK, or else the contents of
+// $PATH_FOR_TASK_FILES/<WORKFLOW_NAME>_vfd.curr_task. The file is read once
+// for both plugins and read again only when its inode, size or mtime
+// changed, checked with one stat() at most every TRACKER_TASK_REFRESH_MS.
+#define DAYU_TASK_REFRESH_MS 1000       // default, 0 checks on every call
+
+// Sets *name to a malloc'd copy, "" when no name is known, returns 1 if found
+int dayu_task_name(char** name);
+
+/* Per-thread context */
+// Object the calling thread is doing I/O for, set by the VOL and read by the
+// VFD on the same thread. "" on threads that never set one, whose I/O is
+// not charged to another thread's dataset.
+void dayu_ctx_set(const char* name);
+const char* dayu_ctx_get(void);
+
+/* Dataset registry */
+// Raw data extent [addr, addr + size) of a dataset in a file. A later extent
+// replaces every earlier one it overlaps (freed and reallocated space).
+void dayu_dset_extent_add(const char* file_name, uint64_t addr, uint64_t size, const char* dset_name);
+// Forget every extent of the file, once the VOL has closed it
+void dayu_dset_extent_drop(const char* file_name);
+// Dataset owning addr in the file, NULL if no published extent holds it.
+// file_key is dayu_intern(file_name), looked up once per file by the caller.
+const char* dayu_dset_at(const char* file_key, uint64_t addr);
+unsigned long dayu_dset_extent_dropped(void);
+
+/* Output sink */
+// Long-lived stat file. Records are batched in memory and written by a
+// background thread, separators are added by the sink so the file never
+// needs its tail rewritten. When compressing, each batch is written as a
+// self-contained gzip member or zstd frame, so a crash loses at most the
+// batch being written.
+// When a dayu-collector listens on the node (see dayu_collector.h), the
+// writer sends batches there instead, as JSON Lines and uncompressed. If
+// the collector goes away the sink falls back to its own file.
+#define DAYU_SINK_PLAIN 0
+#define DAYU_SINK_GZIP 1
+#define DAYU_SINK_ZSTD 2
+
+typedef struct dayu_sink_t {
+    FILE* fh;
+    int jsonl;                  // 1: one compact record per line, 0: JSON array
+    char* buf;                  // records waiting for the writer
+    size_t buf_len;
+    size_t buf_cap;
+    size_t flush_bytes;         // wake the writer once this much is pending
+    unsigned long records;      // records accepted so far
+    int opened;                 // mutex and cond set up, torn down by dayu_sink_close()
+    int running;                // writer thread is up, otherwise write inline
+    int stop;
+    pthread_t writer;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+
+    int codec;                  // DAYU_SINK_PLAIN, DAYU_SINK_GZIP or DAYU_SINK_ZSTD
+    int level;
+    void* codec_ctx;            // z_stream or ZSTD_CCtx, reused across frames
+    char* frame;                // compressed output of one batch
+    size_t frame_cap;
+    unsigned long frames;
+    unsigned long raw_bytes;    // bytes before compression
+    unsigned long stored_bytes; // bytes written to the file
+    unsigned long codec_usec;   // compression CPU time
+
+    int to_collector;           // batches go to sock, fh is opened on fallback (under mutex)
+    int sock;
+    char* path;                 // stat file to fall back to
+} dayu_sink_t;
+
+// Opens path, or path + ".gz"/".zst" when TRACKER_LOG_COMPRESS selects a codec,
+// or a stream to the node's collector when one is listening
+int dayu_sink_open(dayu_sink_t* sink, const char* path);
+void dayu_sink_put(dayu_sink_t* sink, const char* rec, size_t len);
+void dayu_sink_record_end(dayu_sink_t* sink, FILE* rec_stream, char** rec, size_t* rec_len);
+void dayu_sink_close(dayu_sink_t* sink);
+
+/* Incremental flush */
+// Long-running processes write the stats gathered since the last flush as
+// delta records and release them. A flush is due once TRACKER_FLUSH_INTERVAL
+// seconds passed, TRACKER_FLUSH_BYTES of detail are held, or SIGUSR1 arrived
+// (TRACKER_FLUSH_SIGNAL=1). Each plugin keeps its own policy and checks it
+// on its I/O path, the handler only counts signals.
+typedef struct dayu_flush_t {
+    int enabled;
+    unsigned long interval_usec;    // 0: no time trigger
+    size_t max_bytes;               // 0: no size trigger
+    unsigned long last_usec;        // time of the last flush
+    unsigned long signals_seen;     // SIGUSR1 count at the last flush
+    unsigned long seq;              // flushes done
+} dayu_flush_t;
+
+void dayu_flush_init(dayu_flush_t* fl);
+int dayu_flush_due(dayu_flush_t* fl, size_t held_bytes);
+// Marks a flush as done, returns its sequence number, the first is 1
+unsigned long dayu_flush_done(dayu_flush_t* fl);
+
+/* Memory budget */
+// Bytes held by the stat structures of both plugins. With TRACKER_MEM_BUDGET
+// set, detail is coarsened as the budget fills: page ranges are merged, then
+// sampled and new chunk/selection detail dropped, then the plugins spill
+// what they hold to the stat file. Tracker allocations never fail the
+// application, used can pass the budget while a spill is pending.
+#define DAYU_MEM_COARSEN_PCT 60
+#define DAYU_MEM_SAMPLE_PCT 80
+#define DAYU_MEM_SPILL_PCT 95
+#define DAYU_MEM_SAMPLE_EVERY 16        // one page range kept per this many when sampling
+#define DAYU_MEM_EVENTS_MAX 64          // degradation events kept for the report
+
+typedef enum {
+    DAYU_MEM_OK = 0,
+    DAYU_MEM_COARSEN,
+    DAYU_MEM_SAMPLE,
+    DAYU_MEM_SPILL,
+} dayu_mem_level_t;
+
+typedef enum {
+    DAYU_MEM_MERGED = 0,                // page range merged into the previous one
+    DAYU_MEM_SAMPLED,                   // page range counted but not kept
+    DAYU_MEM_DROPPED,                   // chunk or selection detail not kept
+    DAYU_MEM_SPILLED,                   // held stats written out early
+    DAYU_MEM_NACTIONS,
+} dayu_mem_action_t;
+
+// Negative bytes release
+void dayu_mem_charge(long bytes);
+dayu_mem_level_t dayu_mem_level(void);
+unsigned long dayu_mem_used(void);
+// Counts a degradation step, the first of each kind and every spill are
+// kept as events with their time
+void dayu_mem_degraded(dayu_mem_action_t action, const char* who);
+// "Memory-Budget" record: budget, usage, high-water mark and events
+void dayu_mem_log(dayu_sink_t* sink);
+// The same for a columnar stat file: a one-row mem_budget table with the
+// record's counters as columns, and the events as mem_event rows
+void dayu_mem_log_col(dayu_col_writer_t* w);
+
+/* Live stats */
+// With TRACKER_LIVE=1 the process publishes per-file counters in POSIX
+// shared memory for dayu-top, see dayu_live.h. The region is mapped at the
+// first file open, after that an update is a few stores into it.
+// Slot of file_name shared by both plugins, -1 when live stats are off or
+// every slot holds an open file
+int dayu_live_file_open(const char* file_name);
+void dayu_live_file_close(int slot);
+// One read or write on the slot's file, layer is a dayu_live_layer_t
+void dayu_live_io(int slot, int layer, int write, uint64_t bytes, unsigned long usec, const char* dset_name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DAYU_CORE_H */
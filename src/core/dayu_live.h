@@ -0,0 +1,80 @@
+#ifndef DAYU_LIVE_H
+#define DAYU_LIVE_H
+
+// Layout of the live stats region a tracked process publishes in POSIX
+// shared memory with TRACKER_LIVE=1, read by dayu-top. The region is
+// created at the first file open and removed when the process exits; a
+// region whose pid is gone was left by a crashed process.
+//
+// Each file slot is guarded by a seqlock: a writer makes seq odd, updates
+// the slot and makes it even again, a reader copies the slot and retries
+// while seq was odd or changed during the copy. Writers never block readers
+// and updates are plain stores, no syscalls.
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DAYU_LIVE_ENV "TRACKER_LIVE"
+#define DAYU_LIVE_SHM "/dayu-live-%u-%d"    // uid, pid
+#define DAYU_LIVE_SHM_PREFIX "dayu-live-"   // as listed in /dev/shm
+#define DAYU_LIVE_MAGIC 0x4556494c55594144ull // "DAYULIVE"
+#define DAYU_LIVE_VERSION 2
+#define DAYU_LIVE_FILES 64                  // files tracked at once, closed slots are reused
+#define DAYU_LIVE_NAME 128                  // longer names keep their tail, matched by hash
+#define DAYU_LIVE_HIST 24                   // latency buckets, b: [2^(b-1), 2^b) us, 0: under 1 us
+
+typedef enum {
+    DAYU_LIVE_FREE = 0,
+    DAYU_LIVE_OPEN = 1,
+    DAYU_LIVE_CLOSED = 2,
+} dayu_live_state_t;
+
+typedef enum {
+    DAYU_LIVE_VFD = 0,                  // POSIX reads and writes
+    DAYU_LIVE_VOL = 1,                  // dataset reads and writes
+    DAYU_LIVE_NLAYERS,
+} dayu_live_layer_t;
+
+typedef struct {
+    uint64_t ops;
+    uint64_t bytes;
+    uint64_t usec;
+    uint64_t hist[DAYU_LIVE_HIST];
+} dayu_live_io_t;
+
+typedef struct {
+    uint32_t seq;                       // odd while a writer updates the slot
+    uint32_t state;                     // dayu_live_state_t
+    uint32_t opens;                     // plugins holding the file open
+    uint32_t pad;
+    uint64_t file_hash;                 // of the full file name, tails may be shared
+    uint64_t dset_hash;                 // of the full dset_name
+    char file_name[DAYU_LIVE_NAME];
+    char task_name[DAYU_LIVE_NAME];
+    char dset_name[DAYU_LIVE_NAME];     // dataset of the last I/O
+    uint64_t open_usec;                 // us since the epoch
+    uint64_t close_usec;
+    uint64_t last_usec;                 // last I/O
+    dayu_live_io_t io[DAYU_LIVE_NLAYERS][2]; // [layer][0 read, 1 write]
+} dayu_live_file_t;
+
+typedef struct {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t nfiles;
+    int32_t pid;
+    uint32_t pad;
+    uint64_t start_usec;
+    uint64_t files_dropped;             // opens that found every slot open
+    char workflow[DAYU_LIVE_NAME];
+    dayu_live_file_t files[DAYU_LIVE_FILES];
+} dayu_live_region_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DAYU_LIVE_H */
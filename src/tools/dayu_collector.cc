@@ -0,0 +1,345 @@
+// dayu-collector: node-local merger of tracker stat streams. Tracker sinks
+// on this node connect to its Unix socket and stream their records; each
+// workflow gets one data file per node, <workflow>-<host>.dayu, and an
+// index, <workflow>-<host>.dayu.idx, in the directory of the stat files.
+//
+//   dayu-collector [-s socket] [-o dir]
+//
+// The index is JSON Lines, one line per stream opened, batch appended and
+// stream closed:
+//   {"stream": 1, "name": "1234-vfd_data_stat.json", "pid": 1234, "host": ..., "open_time(us)": ...}
+//   {"stream": 1, "off": 0, "len": 5120}
+//   {"stream": 1, "close_time(us)": ..., "complete": true}
+// A batch is whole JSON Lines records of its stream, and is in the data
+// file before its index line is written; a batch that could not be written
+// whole gets no index line and ends its stream. Workflow names with '/' or
+// ".." are refused.
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <string>
+#include <vector>
+#include <memory>
+#include <iostream>
+#include <unordered_map>
+
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "../core/dayu_collector.h"
+#include "dayu_stat_scan.hpp"
+
+namespace {
+
+volatile sig_atomic_t STOP = 0;
+
+void OnStop(int) { STOP = 1; }
+
+unsigned long TimeUsec() {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    return (unsigned long)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+// Data file and index of one workflow in one directory
+struct Output {
+    FILE* data = nullptr;
+    FILE* index = nullptr;
+    std::string base;                   // path without the suffixes
+    uint64_t off = 0;
+    unsigned long next_stream = 1;
+
+    ~Output() {
+        if (data)
+            fclose(data);
+        if (index)
+            fclose(index);
+    }
+};
+
+struct Client {
+    int fd = -1;
+    std::string in;                     // bytes of the message being read
+    Output* out = nullptr;              // set by HELLO
+    unsigned long stream = 0;
+};
+
+class Collector {
+public:
+    Collector(std::string out_dir, std::string host) : out_dir_(std::move(out_dir)), host_(std::move(host)) {}
+
+    void Accept(int listen_fd) {
+        for (;;) {
+            int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0)
+                return;
+            auto client = std::make_unique<Client>();
+            client->fd = fd;
+            clients_.push_back(std::move(client));
+        }
+    }
+
+    // false once the client is gone
+    bool Read(Client& c) {
+        char buf[65536];
+        for (;;) {
+            ssize_t n = read(c.fd, buf, sizeof(buf));
+            if (n > 0) {
+                c.in.append(buf, (size_t)n);
+                continue;
+            }
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                break;
+            Consume(c);
+            return false; // EOF or error
+        }
+        return Consume(c);
+    }
+
+    void Close(Client& c, bool complete) {
+        if (c.out) {
+            fprintf(c.out->index, "{\"stream\": %lu, \"close_time(us)\": %lu, \"complete\": %s}\n",
+                c.stream, TimeUsec(), complete ? "true" : "false");
+            fflush(c.out->index);
+        }
+        close(c.fd);
+        c.fd = -1;
+        c.out = nullptr;
+    }
+
+    std::vector<std::unique_ptr<Client>>& clients() { return clients_; }
+
+private:
+    std::string out_dir_;
+    std::string host_;
+    std::unordered_map<std::string, std::unique_ptr<Output>> outputs_;
+    std::vector<std::unique_ptr<Client>> clients_;
+
+    Output* OutputFor(const std::string& workflow, const std::string& stat_path) {
+        // the name comes from the client and ends up in a path
+        if (workflow.empty() || workflow.find('/') != std::string::npos || workflow.find("..") != std::string::npos) {
+            std::cerr << "rejecting a client with workflow name " << dayu::JsonStr(workflow) << std::endl;
+            return nullptr;
+        }
+        std::string dir = out_dir_;
+        if (dir.empty()) {
+            size_t slash = stat_path.rfind('/');
+            dir = slash == std::string::npos ? "." : stat_path.substr(0, slash);
+        }
+        std::string base = dir + "/" + workflow + "-" + host_;
+        auto it = outputs_.find(base);
+        if (it != outputs_.end())
+            return it->second.get();
+
+        auto out = std::make_unique<Output>();
+        out->base = base;
+        out->data = fopen((base + DAYU_COLLECTOR_DATA_SUFFIX).c_str(), "a");
+        out->index = fopen((base + DAYU_COLLECTOR_INDEX_SUFFIX).c_str(), "a");
+        if (!out->data || !out->index) {
+            std::cerr << "cannot open " << base << DAYU_COLLECTOR_DATA_SUFFIX << ": " << strerror(errno) << std::endl;
+            return nullptr;
+        }
+        // a collector restarted on the same node keeps appending
+        fseek(out->data, 0, SEEK_END);
+        out->off = (uint64_t)ftell(out->data);
+        out->next_stream = NextStream(base + DAYU_COLLECTOR_INDEX_SUFFIX);
+        return (outputs_[base] = std::move(out)).get();
+    }
+
+    // First stream id not used in an existing index
+    static unsigned long NextStream(const std::string& index_path) {
+        FILE* f = fopen(index_path.c_str(), "r");
+        unsigned long last = 0, id;
+        char line[4096];
+
+        if (!f)
+            return 1;
+        while (fgets(line, sizeof(line), f))
+            if (sscanf(line, "{\"stream\": %lu", &id) == 1 && id > last)
+                last = id;
+        fclose(f);
+        return last + 1;
+    }
+
+    // Handle every complete message in c.in, false on a protocol error
+    bool Consume(Client& c) {
+        size_t pos = 0;
+        bool ok = true;
+
+        while (c.in.size() - pos >= sizeof(dayu_msg_header_t)) {
+            dayu_msg_header_t header;
+            memcpy(&header, c.in.data() + pos, sizeof(header));
+            if (header.magic != DAYU_COLLECTOR_MAGIC) {
+                std::cerr << "dropping a client with a bad message header" << std::endl;
+                ok = false;
+                break;
+            }
+            if (c.in.size() - pos - sizeof(header) < header.len)
+                break;
+            const char* payload = c.in.data() + pos + sizeof(header);
+            pos += sizeof(header) + header.len;
+
+            if (header.type == DAYU_MSG_HELLO) {
+                ok = Hello(c, payload, header.len);
+            } else if (header.type == DAYU_MSG_DATA && c.out) {
+                if (fwrite(payload, 1, header.len, c.out->data) != header.len || fflush(c.out->data) != 0) {
+                    // a partial batch is left in the data file without an index line
+                    std::cerr << "short write to " << c.out->base << DAYU_COLLECTOR_DATA_SUFFIX << ": "
+                        << strerror(errno) << ", dropping stream " << c.stream << std::endl;
+                    clearerr(c.out->data);
+                    fseek(c.out->data, 0, SEEK_END);
+                    c.out->off = (uint64_t)ftell(c.out->data);
+                    ok = false;
+                    break;
+                }
+                fprintf(c.out->index, "{\"stream\": %lu, \"off\": %llu, \"len\": %llu}\n", c.stream,
+                    (unsigned long long)c.out->off, (unsigned long long)header.len);
+                fflush(c.out->index);
+                c.out->off += header.len;
+            } else if (header.type == DAYU_MSG_END) {
+                Close(c, true);
+                ok = false;
+            }
+            if (!ok)
+                break;
+        }
+        c.in.erase(0, pos);
+        return ok;
+    }
+
+    bool Hello(Client& c, const char* payload, uint64_t len) {
+        uint32_t pid;
+        if (len < sizeof(pid) + 2 || payload[len - 1] != '\0')
+            return false;
+        memcpy(&pid, payload, sizeof(pid));
+        std::string workflow = payload + sizeof(pid);
+        if (sizeof(pid) + workflow.size() + 1 >= len)
+            return false;
+        std::string stat_path = payload + sizeof(pid) + workflow.size() + 1;
+        std::string name = stat_path.substr(stat_path.rfind('/') + 1);
+
+        c.out = OutputFor(workflow, stat_path);
+        if (!c.out)
+            return false;
+        c.stream = c.out->next_stream++;
+        fprintf(c.out->index, "{\"stream\": %lu, \"name\": %s, \"pid\": %u, \"host\": %s, \"open_time(us)\": %lu}\n",
+            c.stream, dayu::JsonStr(name).c_str(), pid, dayu::JsonStr(host_).c_str(), TimeUsec());
+        fflush(c.out->index);
+        return true;
+    }
+};
+
+// Listening socket at path, replacing a stale one left by a dead collector
+int Listen(const std::string& path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "socket path too long: " << path << std::endl;
+        return -1;
+    }
+    strcpy(addr.sun_path, path.c_str());
+
+    int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (connect(probe, (struct sockaddr*)&addr, sizeof(addr)) == 0) {
+        std::cerr << "a collector already listens on " << path << std::endl;
+        close(probe);
+        return -1;
+    }
+    close(probe);
+    unlink(path.c_str());
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0 || bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, SOMAXCONN) != 0) {
+        std::cerr << "cannot listen on " << path << ": " << strerror(errno) << std::endl;
+        if (fd >= 0)
+            close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string sock_path;
+    std::string out_dir;
+    const char* env = getenv(DAYU_COLLECTOR_ENV);
+
+    if (env && *env && strcmp(env, "off") != 0 && strcmp(env, "0") != 0) {
+        sock_path = env;
+    } else {
+        char buf[108];
+        snprintf(buf, sizeof(buf), DAYU_COLLECTOR_SOCKET, (unsigned)getuid());
+        sock_path = buf;
+    }
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            sock_path = argv[++i];
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            out_dir = argv[++i];
+        } else {
+            std::cerr << "usage: " << argv[0] << " [-s socket] [-o dir]" << std::endl;
+            return 2;
+        }
+    }
+
+    char host[256] = "localhost";
+    gethostname(host, sizeof(host) - 1);
+
+    int listen_fd = Listen(sock_path);
+    if (listen_fd < 0)
+        return 1;
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = OnStop;
+    sigaction(SIGINT, &sa, nullptr);
+    sigaction(SIGTERM, &sa, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    Collector collector(out_dir, host);
+    std::vector<struct pollfd> pfds;
+    while (!STOP) {
+        auto& clients = collector.clients();
+        pfds.assign(1, {listen_fd, POLLIN, 0});
+        for (auto& c : clients)
+            pfds.push_back({c->fd, POLLIN, 0});
+
+        if (poll(pfds.data(), pfds.size(), -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            std::cerr << "poll failed: " << strerror(errno) << std::endl;
+            break;
+        }
+        for (size_t i = 1; i < pfds.size(); i++) {
+            Client& c = *clients[i - 1];
+            if (pfds[i].revents && !collector.Read(c) && c.fd >= 0)
+                collector.Close(c, false); // gone without END, the tracker died or fell back
+        }
+        for (size_t i = clients.size(); i-- > 0;)
+            if (clients[i]->fd < 0)
+                clients.erase(clients.begin() + i);
+        if (pfds[0].revents & POLLIN)
+            collector.Accept(listen_fd);
+    }
+
+    // streams still open are cut here, the trackers fall back to their own files
+    for (auto& c : collector.clients()) {
+        collector.Read(*c);
+        if (c->fd >= 0)
+            collector.Close(*c, false);
+    }
+    close(listen_fd);
+    unlink(sock_path.c_str());
+    return 0;
+}
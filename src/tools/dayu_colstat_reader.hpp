@@ -0,0 +1,198 @@
+#ifndef DAYU_COLSTAT_READER_HPP
+#define DAYU_COLSTAT_READER_HPP
+
+// Read-only view of a columnar stat file (see src/core/dayu_colstat.h).
+// The file is mapped, the footer index is walked once, and cells are read
+// in place from the column chunks.
+
+#include <cstdint>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "../core/dayu_colstat.h"
+
+namespace dayu {
+
+class ColColumn {
+public:
+    std::string name;
+    dayu_col_type_t type = DAYU_COL_U64;
+
+    uint64_t u64(uint64_t row) const { return *cell(row); }
+    int64_t i64(uint64_t row) const { int64_t v; std::memcpy(&v, cell(row), sizeof(v)); return v; }
+    double f64(uint64_t row) const { double v; std::memcpy(&v, cell(row), sizeof(v)); return v; }
+    uint64_t str_id(uint64_t row) const { return *cell(row); }
+
+private:
+    friend class ColFile;
+    struct Chunk {
+        uint64_t first_row;
+        uint64_t rows;
+        const uint64_t* data;
+    };
+    std::vector<Chunk> chunks_;
+    mutable size_t last_ = 0; // readers mostly walk rows in order
+
+    const uint64_t* cell(uint64_t row) const {
+        if (chunks_.empty())
+            throw std::out_of_range("column " + name + " is empty");
+        if (last_ >= chunks_.size() || row < chunks_[last_].first_row) {
+            last_ = 0;
+        }
+        while (last_ < chunks_.size() && row >= chunks_[last_].first_row + chunks_[last_].rows)
+            last_++;
+        if (last_ == chunks_.size())
+            throw std::out_of_range("row past the end of column " + name);
+        return chunks_[last_].data + (row - chunks_[last_].first_row);
+    }
+};
+
+class ColTable {
+public:
+    std::string name;
+    uint64_t rows = 0;
+    std::vector<ColColumn> columns;
+
+    const ColColumn& col(const std::string& col_name) const {
+        for (const ColColumn& c : columns)
+            if (c.name == col_name)
+                return c;
+        throw std::runtime_error("table " + name + " has no column " + col_name);
+    }
+    bool has(const std::string& col_name) const {
+        for (const ColColumn& c : columns)
+            if (c.name == col_name)
+                return true;
+        return false;
+    }
+};
+
+class ColFile {
+public:
+    explicit ColFile(const std::string& path) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("cannot open " + path + ": " + std::strerror(errno));
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(dayu_col_header_t) + sizeof(dayu_col_trailer_t)) {
+            close(fd);
+            throw std::runtime_error(path + ": too short for a columnar stat file");
+        }
+        size_ = (size_t)st.st_size;
+        void* addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (addr == MAP_FAILED)
+            throw std::runtime_error("cannot map " + path + ": " + std::strerror(errno));
+        base_ = (const char*)addr;
+        try {
+            parse(path);
+        } catch (...) {
+            munmap((void*)base_, size_);
+            throw;
+        }
+    }
+    ~ColFile() { munmap((void*)base_, size_); }
+    ColFile(const ColFile&) = delete;
+    ColFile& operator=(const ColFile&) = delete;
+
+    const std::string& str(uint64_t id) const {
+        if (id >= strings_.size())
+            throw std::out_of_range("string id out of range");
+        return strings_[id];
+    }
+    const ColTable* table(const std::string& name) const {
+        auto it = by_name_.find(name);
+        return it == by_name_.end() ? nullptr : &tables_[it->second];
+    }
+    const std::vector<ColTable>& tables() const { return tables_; }
+
+private:
+    const char* base_ = nullptr;
+    size_t size_ = 0;
+    std::vector<std::string> strings_;
+    std::vector<ColTable> tables_;
+    std::unordered_map<std::string, size_t> by_name_;
+
+    const void* at(uint64_t off, uint64_t len) const {
+        if (off > size_ || len > size_ - off)
+            throw std::runtime_error("footer points past the end of the file");
+        return base_ + off;
+    }
+    uint64_t u64_at(uint64_t& off) const {
+        uint64_t v;
+        std::memcpy(&v, at(off, sizeof(v)), sizeof(v));
+        off += sizeof(v);
+        return v;
+    }
+
+    void parse(const std::string& path) {
+        dayu_col_header_t header;
+        dayu_col_trailer_t trailer;
+        std::memcpy(&header, base_, sizeof(header));
+        std::memcpy(&trailer, base_ + size_ - sizeof(trailer), sizeof(trailer));
+        if (std::memcmp(header.magic, DAYU_COL_MAGIC, sizeof(header.magic)) != 0)
+            throw std::runtime_error(path + ": not a columnar stat file");
+        if (header.version != DAYU_COL_VERSION)
+            throw std::runtime_error(path + ": unsupported version " + std::to_string(header.version));
+        if (std::memcmp(trailer.magic, DAYU_COL_END_MAGIC, sizeof(trailer.magic)) != 0)
+            throw std::runtime_error(path + ": no footer, the writer did not finish");
+
+        uint64_t off = trailer.footer_off;
+        uint64_t n_strings = u64_at(off);
+        const uint64_t* str_off = (const uint64_t*)at(off, (n_strings + 1) * sizeof(uint64_t));
+        off += (n_strings + 1) * sizeof(uint64_t);
+        const char* blob = (const char*)at(off, str_off[n_strings]);
+        strings_.reserve(n_strings);
+        for (uint64_t s = 0; s < n_strings; s++) {
+            if (str_off[s + 1] < str_off[s] || str_off[s + 1] > str_off[n_strings])
+                throw std::runtime_error(path + ": corrupt string table");
+            strings_.emplace_back(blob + str_off[s], str_off[s + 1] - str_off[s]);
+        }
+        off += (str_off[n_strings] + 7) / 8 * 8;
+
+        uint64_t n_tables = u64_at(off);
+        for (uint64_t t = 0; t < n_tables; t++) {
+            dayu_col_table_ent_t tent;
+            std::memcpy(&tent, at(off, sizeof(tent)), sizeof(tent));
+            off += sizeof(tent);
+
+            ColTable table;
+            table.name = str(tent.name_id);
+            table.rows = tent.n_rows;
+            for (uint32_t c = 0; c < tent.n_cols; c++) {
+                dayu_col_column_ent_t cent;
+                std::memcpy(&cent, at(off, sizeof(cent)), sizeof(cent));
+                off += sizeof(cent);
+
+                ColColumn col;
+                col.name = str(cent.name_id);
+                col.type = (dayu_col_type_t)cent.type;
+                uint64_t first_row = 0;
+                for (uint32_t k = 0; k < cent.n_chunks; k++) {
+                    dayu_col_chunk_ent_t chunk;
+                    std::memcpy(&chunk, at(off, sizeof(chunk)), sizeof(chunk));
+                    off += sizeof(chunk);
+                    col.chunks_.push_back({first_row,
+                        chunk.rows, (const uint64_t*)at(chunk.offset, chunk.rows * sizeof(uint64_t))});
+                    first_row += chunk.rows;
+                }
+                table.columns.push_back(std::move(col));
+            }
+            by_name_[table.name] = tables_.size();
+            tables_.push_back(std::move(table));
+        }
+    }
+};
+
+} // namespace dayu
+
+#endif /* DAYU_COLSTAT_READER_HPP */
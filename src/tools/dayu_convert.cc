@@ -0,0 +1,256 @@
+// dayu-convert: stream a columnar stat file (.dcs) to the JSON schema of
+// vfd_data_stat.json, for tools that still read the JSON records.
+//
+//   dayu-convert [--jsonl] <in.dcs> [out.json | -]
+//
+// The output defaults to the input path with .json in place of .dcs.
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <iostream>
+
+#include "dayu_colstat_reader.hpp"
+
+namespace {
+
+void PutJsonStr(FILE* out, const std::string& s) {
+    fputc('"', out);
+    for (unsigned char ch : s) {
+        switch (ch) {
+            case '"': fputs("\\\"", out); break;
+            case '\\': fputs("\\\\", out); break;
+            case '\n': fputs("\\n", out); break;
+            case '\t': fputs("\\t", out); break;
+            case '\r': fputs("\\r", out); break;
+            default:
+                if (ch < 0x20)
+                    fprintf(out, "\\u%04x", ch);
+                else
+                    fputc(ch, out);
+        }
+    }
+    fputc('"', out);
+}
+
+void PutCell(FILE* out, const dayu::ColFile& cf, const dayu::ColColumn& col, uint64_t row) {
+    switch (col.type) {
+        case DAYU_COL_STR: PutJsonStr(out, cf.str(col.str_id(row))); break;
+        case DAYU_COL_I64: fprintf(out, "%lld", (long long)col.i64(row)); break;
+        case DAYU_COL_F64: fprintf(out, "%f", col.f64(row)); break;
+        default: fprintf(out, "%llu", (unsigned long long)col.u64(row));
+    }
+}
+
+// "read_ranges"/"write_ranges" keep the JSON shape {"<io_idx>": [start, end], ...}
+void PutRanges(FILE* out, const dayu::ColTable& ranges, uint64_t first, uint64_t cnt) {
+    const dayu::ColColumn& io_idx = ranges.col("io_idx");
+    const dayu::ColColumn& start = ranges.col("start_page");
+    const dayu::ColColumn& end = ranges.col("end_page");
+
+    fputc('{', out);
+    for (uint64_t r = first; r < first + cnt; r++) {
+        fprintf(out, "%s\"%lld\":[%llu,%llu]", r == first ? "" : ",", (long long)io_idx.i64(r),
+            (unsigned long long)start.u64(r), (unsigned long long)end.u64(r));
+    }
+    fputc('}', out);
+}
+
+void PutMemStat(FILE* out, const dayu::ColFile& cf, const dayu::ColTable& mem,
+                const dayu::ColTable& ranges, uint64_t m) {
+    uint64_t range_first = mem.col("range_first").u64(m);
+    uint64_t read_cnt = mem.col("read_range_cnt").u64(m);
+
+    PutJsonStr(out, cf.str(mem.col("mem_type").str_id(m)));
+    fprintf(out, ": {\"read_bytes\": %llu, \"read_cnt\": %lld, \"read_ranges\": ",
+        (unsigned long long)mem.col("read_bytes").u64(m), (long long)mem.col("read_cnt").i64(m));
+    PutRanges(out, ranges, range_first, read_cnt);
+    fprintf(out, ", \"write_bytes\": %llu, \"write_cnt\": %lld, \"write_ranges\": ",
+        (unsigned long long)mem.col("write_bytes").u64(m), (long long)mem.col("write_cnt").i64(m));
+    PutRanges(out, ranges, range_first + read_cnt, mem.col("write_range_cnt").u64(m));
+    fputc('}', out);
+}
+
+// "data" holds the raw data stat of each dataset, "metadata" the others
+void PutDsetSection(FILE* out, const dayu::ColFile& cf, const dayu::ColTable& dset,
+                    const dayu::ColTable& mem, const dayu::ColTable& ranges,
+                    uint64_t first, uint64_t cnt, bool raw) {
+    const dayu::ColColumn& mem_raw = mem.col("raw");
+
+    fprintf(out, "\"%s\": [{", raw ? "data" : "metadata");
+    for (uint64_t d = first; d < first + cnt; d++) {
+        uint64_t mem_first = dset.col("mem_first").u64(d);
+        uint64_t mem_cnt = dset.col("mem_cnt").u64(d);
+        bool put = false;
+
+        fputs(d == first ? "" : ", ", out);
+        PutJsonStr(out, cf.str(dset.col("dset_name").str_id(d)));
+        fputs(": {", out);
+        for (uint64_t m = mem_first; m < mem_first + mem_cnt; m++) {
+            if ((mem_raw.u64(m) != 0) != raw)
+                continue;
+            fputs(put ? ", " : "", out);
+            PutMemStat(out, cf, mem, ranges, m);
+            put = true;
+        }
+        fputc('}', out);
+    }
+    fputs("}]", out);
+}
+
+void PutFileRecord(FILE* out, const dayu::ColFile& cf, const dayu::ColTable& file,
+                   const dayu::ColTable& dset, const dayu::ColTable& mem,
+                   const dayu::ColTable& ranges, uint64_t f) {
+    static const char* scalar_cols[] = {"file_name", "task_name", "node_id", "open_time(us)", "close_time(us)"};
+    static const char* count_cols[] = {"file_no", "file_read_cnt", "file_write_cnt", "access_type",
+        "file_type", "io_bytes", "file_size"};
+
+    fprintf(out, "{\"file-%llu\": {", (unsigned long long)file.col("sorder_id").u64(f));
+    for (const char* name : scalar_cols) {
+        fprintf(out, "\"%s\": ", name);
+        PutCell(out, cf, file.col(name), f);
+        fputs(", ", out);
+    }
+    const std::string& intent = cf.str(file.col("file_intent").str_id(f));
+    fputs("\"file_intent\": [", out);
+    if (!intent.empty())
+        PutJsonStr(out, intent);
+    fputs("], ", out);
+    for (const char* name : count_cols) {
+        fprintf(out, "\"%s\": ", name);
+        PutCell(out, cf, file.col(name), f);
+        fputs(", ", out);
+    }
+    // written by incremental flushing only, files from older writers lack the columns
+    if (file.has("delta_seq") && file.col("delta_seq").u64(f) != 0) {
+        fprintf(out, "\"delta_seq\": %llu, \"final\": %s, ", (unsigned long long)file.col("delta_seq").u64(f),
+            file.col("delta_final").u64(f) ? "true" : "false");
+    }
+    fprintf(out, "\"raw_attribution\": {\"by_address\": %llu, \"by_context\": %llu, \"context_mismatch\": %llu}, ",
+        (unsigned long long)file.col("raw_attribution.by_address").u64(f),
+        (unsigned long long)file.col("raw_attribution.by_context").u64(f),
+        (unsigned long long)file.col("raw_attribution.context_mismatch").u64(f));
+    // already JSON text
+    fprintf(out, "\"page_buffer\": %s, ", cf.str(file.col("page_buffer").str_id(f)).c_str());
+
+    uint64_t dset_first = file.col("dset_first").u64(f);
+    uint64_t dset_cnt = file.col("dset_cnt").u64(f);
+    PutDsetSection(out, cf, dset, mem, ranges, dset_first, dset_cnt, true);
+    fputs(", ", out);
+    PutDsetSection(out, cf, dset, mem, ranges, dset_first, dset_cnt, false);
+    fputs("}, ", out);
+
+    // every "Task.<key>" column, in column order
+    fputs("\"Task\": {\"task_name\": ", out);
+    PutCell(out, cf, file.col("task_name"), f);
+    for (const dayu::ColColumn& col : file.columns) {
+        if (col.name.compare(0, 5, "Task.") != 0)
+            continue;
+        fputs(", ", out);
+        PutJsonStr(out, col.name.substr(5));
+        fputs(": ", out);
+        PutCell(out, cf, col, f);
+    }
+    fputs("}}", out);
+}
+
+// "Memory-Budget" record from the one-row mem_budget table and mem_event
+void PutMemBudget(FILE* out, const dayu::ColFile& cf, const dayu::ColTable& budget, const dayu::ColTable* events) {
+    fputs("{\"Memory-Budget\": {", out);
+    for (const dayu::ColColumn& col : budget.columns) {
+        if (col.name == "events_dropped")
+            continue;
+        PutJsonStr(out, col.name);
+        fputs(": ", out);
+        PutCell(out, cf, col, 0);
+        fputs(", ", out);
+    }
+    fputs("\"events\": [", out);
+    for (uint64_t e = 0; events && e < events->rows; e++) {
+        fputs(e ? ", {" : "{", out);
+        for (size_t c = 0; c < events->columns.size(); c++) {
+            fputs(c ? ", " : "", out);
+            PutJsonStr(out, events->columns[c].name);
+            fputs(": ", out);
+            PutCell(out, cf, events->columns[c], e);
+        }
+        fputc('}', out);
+    }
+    fputs("], \"events_dropped\": ", out);
+    PutCell(out, cf, budget.col("events_dropped"), 0);
+    fputs("}}", out);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool jsonl = false;
+    int argi = 1;
+
+    if (argi < argc && strcmp(argv[argi], "--jsonl") == 0) {
+        jsonl = true;
+        argi++;
+    }
+    if (argc - argi < 1 || argc - argi > 2) {
+        std::cerr << "usage: " << argv[0] << " [--jsonl] <in" << DAYU_COL_SUFFIX << "> [out.json | -]" << std::endl;
+        return 2;
+    }
+
+    std::string in_path = argv[argi];
+    std::string out_path;
+    if (argc - argi == 2) {
+        out_path = argv[argi + 1];
+    } else {
+        out_path = in_path;
+        size_t suffix = strlen(DAYU_COL_SUFFIX);
+        if (out_path.size() > suffix && out_path.compare(out_path.size() - suffix, suffix, DAYU_COL_SUFFIX) == 0)
+            out_path.resize(out_path.size() - suffix);
+        out_path += jsonl ? ".jsonl" : ".json";
+    }
+
+    try {
+        dayu::ColFile cf(in_path);
+        const dayu::ColTable* file = cf.table("vfd_file");
+        const dayu::ColTable* dset = cf.table("vfd_dset");
+        const dayu::ColTable* mem = cf.table("vfd_mem");
+        const dayu::ColTable* ranges = cf.table("vfd_range");
+        if (!file || !dset || !mem || !ranges) {
+            std::cerr << in_path << ": not a VFD stat file (missing vfd_* tables)" << std::endl;
+            return 1;
+        }
+
+        FILE* out = out_path == "-" ? stdout : fopen(out_path.c_str(), "w");
+        if (!out) {
+            std::cerr << "cannot open " << out_path << ": " << strerror(errno) << std::endl;
+            return 1;
+        }
+        if (!jsonl)
+            fputs("[", out);
+        for (uint64_t f = 0; f < file->rows; f++) {
+            if (!jsonl)
+                fputs(f ? ",\n" : "\n", out);
+            PutFileRecord(out, cf, *file, *dset, *mem, *ranges, f);
+            if (jsonl)
+                fputc('\n', out);
+        }
+        // last record, as in the JSON output; files from older writers lack it
+        const dayu::ColTable* budget = cf.table("mem_budget");
+        if (budget && budget->rows > 0) {
+            if (!jsonl)
+                fputs(file->rows ? ",\n" : "\n", out);
+            PutMemBudget(out, cf, *budget, cf.table("mem_event"));
+            if (jsonl)
+                fputc('\n', out);
+        }
+        if (!jsonl)
+            fputs("\n]\n", out);
+        if (out != stdout && fclose(out) != 0) {
+            std::cerr << "failed writing " << out_path << ": " << strerror(errno) << std::endl;
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,398 @@
+// dayu-deps: task -> file dependency graph of a workflow from its VFD stat
+// files, the native counterpart of flow_analysis/task_file_dep_extract.py.
+//
+//   dayu-deps [-j threads] [-o prefix] [--format json|csv|both] [--merge-pids] <stat dir | file>...
+//
+// Stat files are scanned in parallel and streamed record by record, each
+// file's records are folded into the shared graph once it is read, so
+// memory follows the number of tasks, files and datasets, not the input.
+// Writes <prefix>.json and/or <prefix>-{tasks,files,datasets,file_edges,
+// dataset_edges,dependencies}.csv, prefix defaults to dayu-deps.
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <map>
+#include <thread>
+#include <iostream>
+#include <algorithm>
+#include <unordered_map>
+
+#include "dayu_stat_scan.hpp"
+
+namespace {
+
+struct Span {
+    uint64_t start = UINT64_MAX;
+    uint64_t end = 0;
+
+    void Add(uint64_t s, uint64_t e) {
+        start = std::min(start, s);
+        end = std::max(end, e);
+    }
+    void Add(const Span& o) { Add(o.start, o.end); }
+};
+
+struct Flow {
+    uint64_t bytes = 0;
+    uint64_t ops = 0;
+    Span span;
+
+    void Add(const Flow& o) {
+        bytes += o.bytes;
+        ops += o.ops;
+        span.Add(o.span);
+    }
+};
+
+struct TaskStat {
+    Span span;
+    uint64_t read_bytes = 0;
+    uint64_t write_bytes = 0;
+};
+
+struct FileStat {
+    Span span;
+    uint64_t size = 0;
+};
+
+// (task, file, dataset, op), dataset is empty for file edges
+using EdgeKey = std::tuple<std::string, std::string, std::string, char>;
+
+struct Graph {
+    std::unordered_map<std::string, TaskStat> tasks;
+    std::unordered_map<std::string, FileStat> files;
+    std::map<EdgeKey, Flow> file_edges;
+    std::map<EdgeKey, Flow> dset_edges;
+
+    void Merge(Graph& o) {
+        for (auto& [name, t] : o.tasks) {
+            TaskStat& mine = tasks[name];
+            mine.span.Add(t.span);
+            mine.read_bytes += t.read_bytes;
+            mine.write_bytes += t.write_bytes;
+        }
+        for (auto& [name, f] : o.files) {
+            FileStat& mine = files[name];
+            mine.span.Add(f.span);
+            mine.size = std::max(mine.size, f.size);
+        }
+        for (auto& [key, flow] : o.file_edges)
+            file_edges[key].Add(flow);
+        for (auto& [key, flow] : o.dset_edges)
+            dset_edges[key].Add(flow);
+    }
+};
+
+bool MERGE_PIDS = false;
+
+// "openmm-40876" -> "openmm" with --merge-pids
+std::string TaskKey(const std::string& task_name) {
+    return MERGE_PIDS ? dayu::TaskBaseName(task_name) : task_name;
+}
+
+void AddRecord(Graph& g, const dayu::VfdFileRecord& rec) {
+    if (rec.file_type == "na" || rec.task_name.empty())
+        return;
+
+    std::string task = TaskKey(rec.task_name);
+    Flow rd, wr;
+    rd.ops = rec.file_read_cnt;
+    wr.ops = rec.file_write_cnt;
+    rd.span.Add(rec.open_time, rec.close_time);
+    wr.span = rd.span;
+
+    std::map<std::pair<std::string, char>, Flow> dsets;
+    for (const dayu::VfdMemStat& m : rec.mems) {
+        rd.bytes += m.read_bytes;
+        wr.bytes += m.write_bytes;
+        if (m.read_cnt) {
+            Flow& f = dsets[{m.dset_name, 'r'}];
+            f.bytes += m.read_bytes;
+            f.ops += m.read_cnt;
+            f.span = rd.span;
+        }
+        if (m.write_cnt) {
+            Flow& f = dsets[{m.dset_name, 'w'}];
+            f.bytes += m.write_bytes;
+            f.ops += m.write_cnt;
+            f.span = wr.span;
+        }
+    }
+
+    TaskStat& t = g.tasks[task];
+    t.span.Add(rd.span);
+    t.read_bytes += rd.bytes;
+    t.write_bytes += wr.bytes;
+    FileStat& f = g.files[rec.file_name];
+    f.span.Add(rd.span);
+    f.size = std::max(f.size, rec.file_size);
+
+    // a file opened without I/O still counts in the direction of its type
+    if (rd.ops || rd.bytes || rec.file_type == "input")
+        g.file_edges[{task, rec.file_name, "", 'r'}].Add(rd);
+    if (wr.ops || wr.bytes || rec.file_type == "output")
+        g.file_edges[{task, rec.file_name, "", 'w'}].Add(wr);
+    for (auto& [key, flow] : dsets)
+        g.dset_edges[{task, rec.file_name, key.first, key.second}].Add(flow);
+}
+
+struct Dependency {
+    uint32_t producer;
+    uint32_t consumer;
+    uint32_t file;
+    uint64_t bytes;                     // read by the consumer
+    Span span;                          // producer's first write to the consumer's last read
+};
+
+// Output ids and the derived producer -> consumer edges
+struct Numbered {
+    std::vector<std::string> tasks, files;
+    std::vector<std::pair<uint32_t, std::string>> dsets;
+    std::unordered_map<std::string, uint32_t> task_id, file_id;
+    std::map<std::pair<uint32_t, std::string>, uint32_t> dset_id;
+    std::vector<Dependency> deps;
+};
+
+Numbered Number(const Graph& g) {
+    Numbered n;
+
+    // tasks in start order, so ids follow the workflow
+    for (auto& [name, t] : g.tasks)
+        n.tasks.push_back(name);
+    std::sort(n.tasks.begin(), n.tasks.end(), [&g](const std::string& a, const std::string& b) {
+        uint64_t sa = g.tasks.at(a).span.start, sb = g.tasks.at(b).span.start;
+        return sa != sb ? sa < sb : a < b;
+    });
+    for (uint32_t i = 0; i < n.tasks.size(); i++)
+        n.task_id[n.tasks[i]] = i;
+    for (auto& [name, f] : g.files)
+        n.files.push_back(name);
+    std::sort(n.files.begin(), n.files.end());
+    for (uint32_t i = 0; i < n.files.size(); i++)
+        n.file_id[n.files[i]] = i;
+    for (auto& [key, flow] : g.dset_edges) {
+        std::pair<uint32_t, std::string> dk(n.file_id[std::get<1>(key)], std::get<2>(key));
+        if (n.dset_id.emplace(dk, 0).second)
+            n.dsets.push_back(dk);
+    }
+    std::sort(n.dsets.begin(), n.dsets.end());
+    for (uint32_t i = 0; i < n.dsets.size(); i++)
+        n.dset_id[n.dsets[i]] = i;
+
+    // a task reading a file depends on every other task that began writing
+    // it before the read finished
+    std::vector<std::vector<std::pair<uint32_t, const Flow*>>> writers(n.files.size()), readers(n.files.size());
+    for (auto& [key, flow] : g.file_edges) {
+        uint32_t fid = n.file_id[std::get<1>(key)];
+        (std::get<3>(key) == 'w' ? writers : readers)[fid].emplace_back(n.task_id[std::get<0>(key)], &flow);
+    }
+    for (uint32_t fid = 0; fid < n.files.size(); fid++) {
+        for (auto& [w, wflow] : writers[fid]) {
+            for (auto& [r, rflow] : readers[fid]) {
+                if (w == r || wflow->span.start > rflow->span.end)
+                    continue;
+                Dependency d{w, r, fid, rflow->bytes, {}};
+                d.span.Add(wflow->span.start, rflow->span.end);
+                n.deps.push_back(d);
+            }
+        }
+    }
+    std::sort(n.deps.begin(), n.deps.end(), [](const Dependency& a, const Dependency& b) {
+        return std::tie(a.producer, a.consumer, a.file) < std::tie(b.producer, b.consumer, b.file);
+    });
+    return n;
+}
+
+std::string CsvStr(const std::string& s) {
+    if (s.find_first_of(",\"\n") == std::string::npos)
+        return s;
+    std::string out = "\"";
+    for (char ch : s) {
+        if (ch == '"')
+            out += '"';
+        out += ch;
+    }
+    return out + "\"";
+}
+
+const char* OpName(char op) { return op == 'r' ? "read" : "write"; }
+
+// One element per line, so the file greps and diffs well
+void WriteJson(FILE* out, const Graph& g, const Numbered& n) {
+    fputs("{\"tasks\": [", out);
+    for (uint32_t i = 0; i < n.tasks.size(); i++) {
+        const TaskStat& t = g.tasks.at(n.tasks[i]);
+        fprintf(out, "%s\n{\"id\": %u, \"name\": %s, \"start(us)\": %llu, \"end(us)\": %llu, "
+            "\"read_bytes\": %llu, \"write_bytes\": %llu}", i ? "," : "", i, dayu::JsonStr(n.tasks[i]).c_str(),
+            (unsigned long long)t.span.start, (unsigned long long)t.span.end,
+            (unsigned long long)t.read_bytes, (unsigned long long)t.write_bytes);
+    }
+    fputs("],\n\"files\": [", out);
+    for (uint32_t i = 0; i < n.files.size(); i++) {
+        const FileStat& f = g.files.at(n.files[i]);
+        fprintf(out, "%s\n{\"id\": %u, \"name\": %s, \"size\": %llu, \"start(us)\": %llu, \"end(us)\": %llu}",
+            i ? "," : "", i, dayu::JsonStr(n.files[i]).c_str(), (unsigned long long)f.size,
+            (unsigned long long)f.span.start, (unsigned long long)f.span.end);
+    }
+    fputs("],\n\"datasets\": [", out);
+    for (uint32_t i = 0; i < n.dsets.size(); i++)
+        fprintf(out, "%s\n{\"id\": %u, \"file\": %u, \"name\": %s}", i ? "," : "", i, n.dsets[i].first,
+            dayu::JsonStr(n.dsets[i].second).c_str());
+    fputs("],\n\"file_edges\": [", out);
+    bool first = true;
+    for (auto& [key, flow] : g.file_edges) {
+        fprintf(out, "%s\n{\"task\": %u, \"file\": %u, \"op\": \"%s\", \"bytes\": %llu, \"ops\": %llu, "
+            "\"start(us)\": %llu, \"end(us)\": %llu}", first ? "" : ",", n.task_id.at(std::get<0>(key)),
+            n.file_id.at(std::get<1>(key)), OpName(std::get<3>(key)), (unsigned long long)flow.bytes,
+            (unsigned long long)flow.ops, (unsigned long long)flow.span.start, (unsigned long long)flow.span.end);
+        first = false;
+    }
+    fputs("],\n\"dataset_edges\": [", out);
+    first = true;
+    for (auto& [key, flow] : g.dset_edges) {
+        uint32_t did = n.dset_id.at({n.file_id.at(std::get<1>(key)), std::get<2>(key)});
+        fprintf(out, "%s\n{\"task\": %u, \"dataset\": %u, \"op\": \"%s\", \"bytes\": %llu, \"ops\": %llu}",
+            first ? "" : ",", n.task_id.at(std::get<0>(key)), did, OpName(std::get<3>(key)),
+            (unsigned long long)flow.bytes, (unsigned long long)flow.ops);
+        first = false;
+    }
+    fputs("],\n\"dependencies\": [", out);
+    for (size_t i = 0; i < n.deps.size(); i++) {
+        const Dependency& d = n.deps[i];
+        fprintf(out, "%s\n{\"producer\": %u, \"consumer\": %u, \"file\": %u, \"bytes\": %llu, "
+            "\"start(us)\": %llu, \"end(us)\": %llu}", i ? "," : "", d.producer, d.consumer, d.file,
+            (unsigned long long)d.bytes, (unsigned long long)d.span.start, (unsigned long long)d.span.end);
+    }
+    fputs("]}\n", out);
+}
+
+FILE* OpenOut(const std::string& path) {
+    FILE* out = fopen(path.c_str(), "w");
+    if (!out)
+        std::cerr << "cannot open " << path << ": " << strerror(errno) << std::endl;
+    return out;
+}
+
+bool WriteCsv(const std::string& prefix, const Graph& g, const Numbered& n) {
+    FILE* out;
+
+    if (!(out = OpenOut(prefix + "-tasks.csv")))
+        return false;
+    fputs("id,name,start_us,end_us,read_bytes,write_bytes\n", out);
+    for (uint32_t i = 0; i < n.tasks.size(); i++) {
+        const TaskStat& t = g.tasks.at(n.tasks[i]);
+        fprintf(out, "%u,%s,%llu,%llu,%llu,%llu\n", i, CsvStr(n.tasks[i]).c_str(), (unsigned long long)t.span.start,
+            (unsigned long long)t.span.end, (unsigned long long)t.read_bytes, (unsigned long long)t.write_bytes);
+    }
+    fclose(out);
+
+    if (!(out = OpenOut(prefix + "-files.csv")))
+        return false;
+    fputs("id,name,size,start_us,end_us\n", out);
+    for (uint32_t i = 0; i < n.files.size(); i++) {
+        const FileStat& f = g.files.at(n.files[i]);
+        fprintf(out, "%u,%s,%llu,%llu,%llu\n", i, CsvStr(n.files[i]).c_str(), (unsigned long long)f.size,
+            (unsigned long long)f.span.start, (unsigned long long)f.span.end);
+    }
+    fclose(out);
+
+    if (!(out = OpenOut(prefix + "-datasets.csv")))
+        return false;
+    fputs("id,file,name\n", out);
+    for (uint32_t i = 0; i < n.dsets.size(); i++)
+        fprintf(out, "%u,%u,%s\n", i, n.dsets[i].first, CsvStr(n.dsets[i].second).c_str());
+    fclose(out);
+
+    if (!(out = OpenOut(prefix + "-file_edges.csv")))
+        return false;
+    fputs("task,file,op,bytes,ops,start_us,end_us\n", out);
+    for (auto& [key, flow] : g.file_edges)
+        fprintf(out, "%u,%u,%s,%llu,%llu,%llu,%llu\n", n.task_id.at(std::get<0>(key)), n.file_id.at(std::get<1>(key)),
+            OpName(std::get<3>(key)), (unsigned long long)flow.bytes, (unsigned long long)flow.ops,
+            (unsigned long long)flow.span.start, (unsigned long long)flow.span.end);
+    fclose(out);
+
+    if (!(out = OpenOut(prefix + "-dataset_edges.csv")))
+        return false;
+    fputs("task,dataset,op,bytes,ops\n", out);
+    for (auto& [key, flow] : g.dset_edges)
+        fprintf(out, "%u,%u,%s,%llu,%llu\n", n.task_id.at(std::get<0>(key)),
+            n.dset_id.at({n.file_id.at(std::get<1>(key)), std::get<2>(key)}), OpName(std::get<3>(key)),
+            (unsigned long long)flow.bytes, (unsigned long long)flow.ops);
+    fclose(out);
+
+    if (!(out = OpenOut(prefix + "-dependencies.csv")))
+        return false;
+    fputs("producer,consumer,file,bytes,start_us,end_us\n", out);
+    for (const Dependency& d : n.deps)
+        fprintf(out, "%u,%u,%u,%llu,%llu,%llu\n", d.producer, d.consumer, d.file, (unsigned long long)d.bytes,
+            (unsigned long long)d.span.start, (unsigned long long)d.span.end);
+    fclose(out);
+    return true;
+}
+
+void Usage(const char* prog) {
+    std::cerr << "usage: " << prog << " [-j threads] [-o prefix] [--format json|csv|both] [--merge-pids]"
+        " <stat dir | file>..." << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string prefix = "dayu-deps";
+    std::string format = "both";
+    std::vector<std::string> inputs;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            threads = std::max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            prefix = argv[++i];
+        } else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            format = argv[++i];
+        } else if (strcmp(argv[i], "--merge-pids") == 0) {
+            MERGE_PIDS = true;
+        } else if (argv[i][0] == '-') {
+            Usage(argv[0]);
+            return 2;
+        } else {
+            inputs.push_back(argv[i]);
+        }
+    }
+    if (inputs.empty() || (format != "json" && format != "csv" && format != "both")) {
+        Usage(argv[0]);
+        return 2;
+    }
+
+    std::vector<std::string> files = dayu::FindVfdStatFiles(inputs);
+    if (files.empty()) {
+        std::cerr << "no VFD stat files found" << std::endl;
+        return 1;
+    }
+    Graph graph;
+    size_t failed = dayu::ScanVfdStatFiles<Graph>(files, {}, threads, AddRecord,
+        [&graph](Graph& local) { graph.Merge(local); });
+
+    Numbered n = Number(graph);
+    if (format != "csv") {
+        FILE* out = OpenOut(prefix + ".json");
+        if (!out)
+            return 1;
+        WriteJson(out, graph, n);
+        if (fclose(out) != 0) {
+            std::cerr << "failed writing " << prefix << ".json" << std::endl;
+            return 1;
+        }
+    }
+    if (format != "json" && !WriteCsv(prefix, graph, n))
+        return 1;
+
+    std::cerr << files.size() << " stat files (" << failed << " with errors): " << n.tasks.size() << " tasks, "
+        << n.files.size() << " files, " << n.dsets.size() << " datasets, " << n.deps.size() << " dependencies"
+        << std::endl;
+    return 0;
+}
@@ -0,0 +1,663 @@
+// dayu-sankey: ready-to-render Sankey node and link lists of a workflow from
+// its VFD stat files, the native counterpart of the graph building in
+// flow_analysis/utils/{vfd_stat2graph,full_stat2graph,vfd_graph2sankey}.py.
+//
+//   dayu-sankey [-j threads] [-o prefix] [--levels io,dataset,file,stage]
+//               [--task-order task_order_list.json] [--addr-buckets n]
+//               [--merge-pids] [--linear] <stat dir | file>...
+//
+// One parallel pass over the stat files feeds every level; each level is
+// written as <prefix>-<level>.json, prefix defaults to dayu-sankey:
+//   stage    stage -> files written by a stage -> stages reading them
+//   file     task -> file -> task
+//   dataset  task -> dataset -> file -> dataset -> task
+//   io       as dataset, with file address ranges between dataset and file
+// Node and link lists are laid out as plotly's go.Sankey takes them, with x/y
+// positions already computed, see load_sankey() in vfd_graph2sankey.py.
+
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <thread>
+#include <iostream>
+#include <algorithm>
+#include <unordered_map>
+
+#include "dayu_stat_scan.hpp"
+
+namespace {
+
+constexpr uint64_t kNoPage = UINT64_MAX; // I/O of a record without page ranges
+
+struct Flow {
+    uint64_t bytes = 0;
+    uint64_t ops = 0;
+    uint64_t data_bytes = 0;
+    uint64_t data_ops = 0;
+    uint64_t meta_bytes = 0;
+    uint64_t meta_ops = 0;
+
+    void Add(bool raw, uint64_t b, uint64_t n) {
+        bytes += b;
+        ops += n;
+        (raw ? data_bytes : meta_bytes) += b;
+        (raw ? data_ops : meta_ops) += n;
+    }
+    void Add(const Flow& o) {
+        bytes += o.bytes;
+        ops += o.ops;
+        data_bytes += o.data_bytes;
+        data_ops += o.data_ops;
+        meta_bytes += o.meta_bytes;
+        meta_ops += o.meta_ops;
+    }
+};
+
+struct TaskStat {
+    std::string base;                   // task name without pid, picks the stage
+    uint64_t start = UINT64_MAX;
+};
+
+// (task, file, op)
+using FileEdgeKey = std::tuple<std::string, std::string, char>;
+// (task, file, dataset, op)
+using DsetEdgeKey = std::tuple<std::string, std::string, std::string, char>;
+// (task base, file, dataset, op, first page of the I/O)
+using IoKey = std::tuple<std::string, std::string, std::string, char, uint64_t>;
+
+struct Graph {
+    std::unordered_map<std::string, TaskStat> tasks;
+    std::unordered_map<std::string, uint64_t> files; // first open
+    std::map<FileEdgeKey, Flow> file_edges;
+    std::map<DsetEdgeKey, Flow> dset_edges;
+    std::map<IoKey, Flow> io_edges;
+
+    void Merge(Graph& o) {
+        for (auto& [name, t] : o.tasks) {
+            TaskStat& mine = tasks[name];
+            mine.base = t.base;
+            mine.start = std::min(mine.start, t.start);
+        }
+        for (auto& [name, start] : o.files) {
+            auto it = files.emplace(name, start).first;
+            it->second = std::min(it->second, start);
+        }
+        for (auto& [key, flow] : o.file_edges)
+            file_edges[key].Add(flow);
+        for (auto& [key, flow] : o.dset_edges)
+            dset_edges[key].Add(flow);
+        for (auto& [key, flow] : o.io_edges)
+            io_edges[key].Add(flow);
+    }
+};
+
+bool MERGE_PIDS = false;
+bool WANT_IO = false;
+std::map<std::string, int> TASK_ORDER;  // task base -> stage, from --task-order
+
+// Page ranges of one memory type and direction share its bytes evenly
+void AddIo(Graph& g, const std::string& base, const dayu::VfdFileRecord& rec, const dayu::VfdMemStat& m, bool write) {
+    uint64_t bytes = write ? m.write_bytes : m.read_bytes;
+    uint64_t cnt = write ? m.write_cnt : m.read_cnt;
+    std::vector<uint64_t> pages;
+    for (const dayu::VfdRange& r : m.ranges)
+        if (r.write == write)
+            pages.push_back(r.start_page);
+    if (pages.empty()) {
+        g.io_edges[{base, rec.file_name, m.dset_name, write ? 'w' : 'r', kNoPage}].Add(m.raw, bytes, cnt);
+        return;
+    }
+    // counts stay exact when the tracker kept only some of the ranges
+    uint64_t share = bytes / pages.size(), ops = cnt / pages.size();
+    for (size_t i = 0; i < pages.size(); i++) {
+        uint64_t b = share + (i == 0 ? bytes % pages.size() : 0);
+        uint64_t n = ops + (i == 0 ? cnt % pages.size() : 0);
+        g.io_edges[{base, rec.file_name, m.dset_name, write ? 'w' : 'r', pages[i]}].Add(m.raw, b, n);
+    }
+}
+
+void AddRecord(Graph& g, const dayu::VfdFileRecord& rec) {
+    if (rec.file_type == "na" || rec.task_name.empty())
+        return;
+    std::string base = dayu::TaskBaseName(rec.task_name);
+    if (!TASK_ORDER.empty() && !TASK_ORDER.count(base))
+        return; // not a stage of the workflow, as in full_stat2graph.py
+
+    std::string task = MERGE_PIDS ? base : rec.task_name;
+    TaskStat& t = g.tasks[task];
+    t.base = base;
+    t.start = std::min(t.start, rec.open_time);
+    auto fit = g.files.emplace(rec.file_name, rec.open_time).first;
+    fit->second = std::min(fit->second, rec.open_time);
+
+    Flow rd, wr;
+    for (const dayu::VfdMemStat& m : rec.mems) {
+        if (m.read_cnt) {
+            rd.Add(m.raw, m.read_bytes, m.read_cnt);
+            g.dset_edges[{task, rec.file_name, m.dset_name, 'r'}].Add(m.raw, m.read_bytes, m.read_cnt);
+            if (WANT_IO)
+                AddIo(g, base, rec, m, false);
+        }
+        if (m.write_cnt) {
+            wr.Add(m.raw, m.write_bytes, m.write_cnt);
+            g.dset_edges[{task, rec.file_name, m.dset_name, 'w'}].Add(m.raw, m.write_bytes, m.write_cnt);
+            if (WANT_IO)
+                AddIo(g, base, rec, m, true);
+        }
+    }
+    // a file opened without I/O still shows in the direction of its type
+    if (rd.ops || rec.file_type == "input")
+        g.file_edges[{task, rec.file_name, 'r'}].Add(rd);
+    if (wr.ops || rec.file_type == "output")
+        g.file_edges[{task, rec.file_name, 'w'}].Add(wr);
+}
+
+// Stage of each task base: the task order list, or else the order the
+// first task of each base started in
+std::vector<std::string> Stages(const Graph& g, std::map<std::string, int>& stage_of) {
+    std::vector<std::string> names;
+    if (!TASK_ORDER.empty()) {
+        for (auto& [base, order] : TASK_ORDER) {
+            if ((size_t)order >= names.size())
+                names.resize(order + 1);
+            names[order] = base;
+        }
+        stage_of = TASK_ORDER;
+        return names;
+    }
+    std::map<std::string, uint64_t> first;
+    for (auto& [name, t] : g.tasks) {
+        auto it = first.emplace(t.base, t.start).first;
+        it->second = std::min(it->second, t.start);
+    }
+    std::vector<std::pair<uint64_t, std::string>> order;
+    for (auto& [base, start] : first)
+        order.emplace_back(start, base);
+    std::sort(order.begin(), order.end());
+    for (auto& [start, base] : order) {
+        stage_of[base] = (int)names.size();
+        names.push_back(base);
+    }
+    return names;
+}
+
+struct Node {
+    std::string label;
+    const char* type;
+    int col;
+    uint64_t first;                     // orders the nodes of a column
+};
+
+// One level: nodes keyed by a string unique in the level, links by (source, target, op)
+class Level {
+public:
+    explicit Level(std::string name) : name_(std::move(name)) {}
+
+    uint32_t Add(const std::string& key, const std::string& label, const char* type, int col, uint64_t first) {
+        auto [it, added] = index_.emplace(key, (uint32_t)nodes_.size());
+        if (added)
+            nodes_.push_back({label, type, col, first});
+        else
+            nodes_[it->second].first = std::min(nodes_[it->second].first, first);
+        return it->second;
+    }
+
+    void Link(uint32_t source, uint32_t target, char op, const Flow& flow) {
+        links_[{source, target, op}].Add(flow);
+    }
+
+    const std::string& name() const { return name_; }
+    const std::vector<Node>& nodes() const { return nodes_; }
+    const std::map<std::tuple<uint32_t, uint32_t, char>, Flow>& links() const { return links_; }
+
+private:
+    std::string name_;
+    std::vector<Node> nodes_;
+    std::unordered_map<std::string, uint32_t> index_;
+    std::map<std::tuple<uint32_t, uint32_t, char>, Flow> links_;
+};
+
+std::string BaseName(const std::string& path) {
+    size_t slash = path.rfind('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+// Everything the levels need besides the graph
+struct Layout {
+    std::vector<std::string> stages;
+    std::map<std::string, int> stage_of;            // task base -> stage
+    std::map<std::string, int> write_stage;         // file -> first stage writing it
+    std::map<std::string, int> read_stage;          // file -> first stage reading it
+    std::map<std::string, std::pair<uint64_t, uint64_t>> pages; // file -> first pages of its I/O, min and max
+    int buckets = 4;
+
+    int TaskStage(const Graph& g, const std::string& task) const { return stage_of.at(g.tasks.at(task).base); }
+
+    // files come after the stage writing them, or before the stage reading
+    // them; a level has cols columns per stage
+    int FileCol(const std::string& file, int cols) const {
+        auto it = write_stage.find(file);
+        if (it != write_stage.end())
+            return cols * (it->second + 1);
+        return cols * read_stage.at(file);
+    }
+};
+
+Layout MakeLayout(const Graph& g, int buckets) {
+    Layout l;
+    l.buckets = buckets;
+    l.stages = Stages(g, l.stage_of);
+    for (auto& [key, flow] : g.file_edges) {
+        int s = l.stage_of.at(g.tasks.at(std::get<0>(key)).base);
+        auto& m = std::get<2>(key) == 'w' ? l.write_stage : l.read_stage;
+        auto it = m.emplace(std::get<1>(key), s).first;
+        it->second = std::min(it->second, s);
+    }
+    for (auto& [key, flow] : g.io_edges) {
+        uint64_t page = std::get<4>(key);
+        if (page == kNoPage)
+            continue;
+        auto it = l.pages.emplace(std::get<1>(key), std::make_pair(page, page)).first;
+        it->second.first = std::min(it->second.first, page);
+        it->second.second = std::max(it->second.second, page);
+    }
+    return l;
+}
+
+uint32_t TaskNode(Level& lv, const Graph& g, const Layout& l, const std::string& task, int cols) {
+    int s = l.TaskStage(g, task);
+    return lv.Add("t:" + task, task, "task", cols * s + cols / 2, g.tasks.at(task).start);
+}
+
+uint32_t FileNode(Level& lv, const Graph& g, const Layout& l, const std::string& file, int cols) {
+    return lv.Add("f:" + file, BaseName(file), "file", l.FileCol(file, cols), g.files.at(file));
+}
+
+// "{dset}-{stage}-R" / "-W" as in full_stat2graph.py, the "file" dataset is
+// the file's groups and attributes
+uint32_t DsetNode(Level& lv, const std::string& dset, int stage, char op, int col, uint64_t first) {
+    std::string key = dset + "-" + std::to_string(stage) + (op == 'r' ? "-R" : "-W");
+    if (dset == "file")
+        return lv.Add("d:" + key, "File-Metadata-" + std::to_string(stage), "group/attr", col, first);
+    return lv.Add("d:" + key, key, "dataset", col, first);
+}
+
+Level StageLevel(const Graph& g, const Layout& l) {
+    Level lv("stage");
+    for (auto& [key, flow] : g.file_edges) {
+        const std::string& file = std::get<1>(key);
+        int s = l.TaskStage(g, std::get<0>(key));
+        uint64_t start = g.tasks.at(std::get<0>(key)).start;
+        uint32_t stage = lv.Add("s:" + std::to_string(s), l.stages[s], "task", 2 * s + 1, start);
+
+        // a stage's outputs are one node, files nobody writes are grouped by
+        // the first stage reading them
+        auto ws = l.write_stage.find(file);
+        uint32_t group = ws != l.write_stage.end()
+            ? lv.Add("o:" + std::to_string(ws->second), l.stages[ws->second] + " output", "file", 2 * ws->second + 2,
+                  g.files.at(file))
+            : lv.Add("i:" + std::to_string(l.read_stage.at(file)), l.stages[l.read_stage.at(file)] + " input", "file",
+                  2 * l.read_stage.at(file), g.files.at(file));
+        if (std::get<2>(key) == 'w')
+            lv.Link(stage, group, 'w', flow);
+        else
+            lv.Link(group, stage, 'r', flow);
+    }
+    return lv;
+}
+
+Level FileLevel(const Graph& g, const Layout& l) {
+    Level lv("file");
+    for (auto& [key, flow] : g.file_edges) {
+        uint32_t task = TaskNode(lv, g, l, std::get<0>(key), 2);
+        uint32_t file = FileNode(lv, g, l, std::get<1>(key), 2);
+        if (std::get<2>(key) == 'w')
+            lv.Link(task, file, 'w', flow);
+        else
+            lv.Link(file, task, 'r', flow);
+    }
+    return lv;
+}
+
+// Dataset and io levels: read as file -> [addr] -> dataset -> task, write as
+// task -> dataset -> [addr] -> file; cols columns per stage
+void DsetLinks(Level& lv, const Graph& g, const Layout& l, int cols, bool file_links) {
+    for (auto& [key, flow] : g.dset_edges) {
+        auto& [task_name, file_name, dset_name, op] = key;
+        int s = l.TaskStage(g, task_name);
+        uint64_t start = g.tasks.at(task_name).start;
+        uint32_t task = TaskNode(lv, g, l, task_name, cols);
+        uint32_t dset = DsetNode(lv, dset_name, s, op, cols * s + cols / 2 + (op == 'r' ? -1 : 1), start);
+        if (op == 'w')
+            lv.Link(task, dset, 'w', flow);
+        else
+            lv.Link(dset, task, 'r', flow);
+        if (!file_links)
+            continue;
+        uint32_t file = FileNode(lv, g, l, file_name, cols);
+        if (op == 'w')
+            lv.Link(dset, file, 'w', flow);
+        else
+            lv.Link(file, dset, 'r', flow);
+    }
+}
+
+Level DatasetLevel(const Graph& g, const Layout& l) {
+    Level lv("dataset");
+    DsetLinks(lv, g, l, 4, true);
+    return lv;
+}
+
+Level IoLevel(const Graph& g, const Layout& l) {
+    Level lv("io");
+    DsetLinks(lv, g, l, 6, false);
+
+    // stage of each task base, and first start for node order
+    std::map<std::string, uint64_t> base_start;
+    for (auto& [name, t] : g.tasks) {
+        auto it = base_start.emplace(t.base, t.start).first;
+        it->second = std::min(it->second, t.start);
+    }
+    for (auto& [key, flow] : g.io_edges) {
+        auto& [base, file_name, dset_name, op, page] = key;
+        int s = l.stage_of.at(base);
+        uint64_t start = base_start.at(base);
+        uint32_t dset = DsetNode(lv, dset_name, s, op, 6 * s + 3 + (op == 'r' ? -1 : 1), start);
+        uint32_t file = FileNode(lv, g, l, file_name, 6);
+        if (page == kNoPage) {
+            if (op == 'w')
+                lv.Link(dset, file, 'w', flow);
+            else
+                lv.Link(file, dset, 'r', flow);
+            continue;
+        }
+
+        // buckets of the file's page span, "[first-last)" as add_page_nodes() labels them
+        auto [lo, hi] = l.pages.at(file_name);
+        uint64_t span = hi - lo + 1;
+        uint64_t width = (span + l.buckets - 1) / l.buckets;
+        uint64_t b = (page - lo) / width;
+        uint64_t first = lo + b * width, last = std::min(hi + 1, first + width);
+        std::string label = BaseName(file_name) + " [" + std::to_string(first) + "-" + std::to_string(last) + ")";
+        uint32_t addr = lv.Add("a:" + file_name + ":" + std::to_string(b) + ":" + std::to_string(s) + op, label,
+            "addr", op == 'w' ? 6 * s + 5 : 6 * s + 1, first);
+        if (op == 'w') {
+            lv.Link(dset, addr, 'w', flow);
+            lv.Link(addr, file, 'w', flow);
+        } else {
+            lv.Link(file, addr, 'r', flow);
+            lv.Link(addr, dset, 'r', flow);
+        }
+    }
+    return lv;
+}
+
+// Node colors and link colors of vfd_graph2sankey.py
+const char* NodeColor(const char* type) {
+    if (strcmp(type, "task") == 0)
+        return "Red";
+    if (strcmp(type, "dataset") == 0)
+        return "Gold";
+    if (strcmp(type, "group/attr") == 0)
+        return "Yellow";
+    if (strcmp(type, "file") == 0)
+        return "MediumBlue";
+    if (strcmp(type, "addr") == 0)
+        return "RoyalBlue";
+    return "grey";
+}
+
+// stat_print.humansize()
+std::string HumanSize(double n) {
+    static const char* suffixes[] = {"B", "KB", "MB", "GB", "TB", "PB"};
+    if (n == 0)
+        return "0";
+    int i = 0;
+    while (n >= 1000 && i < 5) {
+        n /= 1000;
+        i++;
+    }
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.2f", n);
+    std::string s = buf;
+    s.erase(s.find_last_not_of('0') + 1);
+    if (s.back() == '.')
+        s.pop_back();
+    return s + " " + suffixes[i];
+}
+
+// Hover text of get_links_for_sankey()
+std::string LinkLabel(const Flow& f, char op) {
+    auto avg = [](uint64_t b, uint64_t n) { return n ? HumanSize((double)b / n) : std::string("0"); };
+    return "Access Volume : " + HumanSize((double)f.bytes) + " <br />Access Count : " + std::to_string(f.ops)
+        + " <br />Average Access Size : " + avg(f.bytes, f.ops ? f.ops : 1)
+        + " <br />HDF5 Data Access Count : " + std::to_string(f.data_ops)
+        + " <br />Average HDF5 Data Access Size : " + avg(f.data_bytes, f.data_ops)
+        + " <br />HDF5 Metadata Access Count : " + std::to_string(f.meta_ops)
+        + " <br />Average HDF5 Metadata Access Size : " + avg(f.meta_bytes, f.meta_ops)
+        + " <br />Operation : " + (op == 'r' ? "read" : "write");
+}
+
+template <typename T, typename Fn>
+void JsonArray(FILE* out, const char* name, const std::vector<T>& items, Fn fmt, bool last = false) {
+    fprintf(out, "  %s: [", dayu::JsonStr(name).c_str());
+    for (size_t i = 0; i < items.size(); i++) {
+        if (i)
+            fputs(", ", out);
+        fmt(items[i]);
+    }
+    fputs(last ? "]\n" : "],\n", out);
+}
+
+// x is the column and y the rank in the column, both scaled to 0.01..1 as
+// get_xy_position() does
+bool WriteLevel(const std::string& path, const Level& lv, const std::vector<std::string>& stages, bool linear) {
+    const std::vector<Node>& nodes = lv.nodes();
+    std::vector<double> x(nodes.size()), y(nodes.size());
+    std::map<int, std::vector<uint32_t>> cols;
+    for (uint32_t i = 0; i < nodes.size(); i++)
+        cols[nodes[i].col].push_back(i);
+    int min_col = cols.empty() ? 0 : cols.begin()->first;
+    int max_col = cols.empty() ? 0 : cols.rbegin()->first;
+    size_t max_rank = 0;
+    for (auto& [col, ids] : cols) {
+        std::sort(ids.begin(), ids.end(), [&nodes](uint32_t a, uint32_t b) {
+            return std::tie(nodes[a].first, nodes[a].label) < std::tie(nodes[b].first, nodes[b].label);
+        });
+        max_rank = std::max(max_rank, ids.size() - 1);
+    }
+    for (auto& [col, ids] : cols) {
+        for (size_t r = 0; r < ids.size(); r++) {
+            x[ids[r]] = 0.01 + 0.99 * (col - min_col) / std::max(1, max_col - min_col);
+            y[ids[r]] = 0.01 + 0.99 * r / std::max<size_t>(1, max_rank);
+        }
+    }
+
+    FILE* out = fopen(path.c_str(), "w");
+    if (!out) {
+        std::cerr << "cannot open " << path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    std::vector<uint32_t> ids(nodes.size());
+    for (uint32_t i = 0; i < ids.size(); i++)
+        ids[i] = i;
+    fprintf(out, "{\"level\": %s,\n", dayu::JsonStr(lv.name()).c_str());
+    JsonArray(out, "stages", stages, [out](const std::string& s) { fputs(dayu::JsonStr(s).c_str(), out); });
+    fputs("\"node\": {\n", out);
+    JsonArray(out, "label", ids, [&](uint32_t i) { fputs(dayu::JsonStr(nodes[i].label).c_str(), out); });
+    JsonArray(out, "type", ids, [&](uint32_t i) { fprintf(out, "\"%s\"", nodes[i].type); });
+    JsonArray(out, "color", ids, [&](uint32_t i) { fprintf(out, "\"%s\"", NodeColor(nodes[i].type)); });
+    JsonArray(out, "x", ids, [&](uint32_t i) { fprintf(out, "%.4f", x[i]); });
+    JsonArray(out, "y", ids, [&](uint32_t i) { fprintf(out, "%.4f", y[i]); }, true);
+    fputs("},\n\"link\": {\n", out);
+
+    std::vector<std::pair<std::tuple<uint32_t, uint32_t, char>, Flow>> links(lv.links().begin(), lv.links().end());
+    using L = std::pair<std::tuple<uint32_t, uint32_t, char>, Flow>;
+    JsonArray(out, "source", links, [out](const L& l) { fprintf(out, "%u", std::get<0>(l.first)); });
+    JsonArray(out, "target", links, [out](const L& l) { fprintf(out, "%u", std::get<1>(l.first)); });
+    // get_links_for_sankey(val_sqrt=True) draws the fourth root of the bytes
+    JsonArray(out, "value", links, [out, linear](const L& l) {
+        double v = l.second.bytes ? (linear ? (double)l.second.bytes : std::sqrt(std::sqrt((double)l.second.bytes))) : 1;
+        fprintf(out, "%.6g", v);
+    });
+    JsonArray(out, "label", links, [out](const L& l) {
+        fputs(dayu::JsonStr(LinkLabel(l.second, std::get<2>(l.first))).c_str(), out);
+    });
+    JsonArray(out, "color", links, [out](const L& l) {
+        fputs(l.second.bytes ? "\"rgba(150, 190, 220, 0.2)\"" : "\"rgba(180, 180, 180, 0.2)\"", out);
+    });
+    JsonArray(out, "op", links, [out](const L& l) {
+        fputs(std::get<2>(l.first) == 'r' ? "\"read\"" : "\"write\"", out);
+    });
+    JsonArray(out, "bytes", links, [out](const L& l) { fprintf(out, "%llu", (unsigned long long)l.second.bytes); });
+    JsonArray(out, "ops", links, [out](const L& l) { fprintf(out, "%llu", (unsigned long long)l.second.ops); });
+    JsonArray(out, "data_bytes", links, [out](const L& l) {
+        fprintf(out, "%llu", (unsigned long long)l.second.data_bytes);
+    });
+    JsonArray(out, "data_ops", links, [out](const L& l) {
+        fprintf(out, "%llu", (unsigned long long)l.second.data_ops);
+    });
+    JsonArray(out, "metadata_bytes", links, [out](const L& l) {
+        fprintf(out, "%llu", (unsigned long long)l.second.meta_bytes);
+    });
+    JsonArray(out, "metadata_ops", links, [out](const L& l) {
+        fprintf(out, "%llu", (unsigned long long)l.second.meta_ops);
+    }, true);
+    fputs("}}\n", out);
+    if (fclose(out) != 0) {
+        std::cerr << "failed writing " << path << std::endl;
+        return false;
+    }
+    std::cerr << path << ": " << nodes.size() << " nodes, " << links.size() << " links" << std::endl;
+    return true;
+}
+
+// task_order_list.json, {"0": "openmm", "1": "aggregate", ...}
+bool LoadTaskOrder(const std::string& path) {
+    try {
+        dayu::JsonPull jp(path);
+        dayu::JsonPull::Tok t = jp.next();
+        if (t != dayu::JsonPull::kObjBegin)
+            throw std::runtime_error(path + ": not a JSON object");
+        while ((t = jp.next()) == dayu::JsonPull::kKey) {
+            int order = atoi(jp.text().c_str());
+            std::string base = jp.NextStr();
+            if (order >= 0 && !base.empty())
+                TASK_ORDER[base] = order;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void Usage(const char* prog) {
+    std::cerr << "usage: " << prog << " [-j threads] [-o prefix] [--levels io,dataset,file,stage]"
+        " [--task-order task_order_list.json] [--addr-buckets n] [--merge-pids] [--linear]"
+        " <stat dir | file>..." << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string prefix = "dayu-sankey";
+    std::string task_order;
+    int buckets = 4;
+    bool linear = false;
+    std::set<std::string> levels = {"io", "dataset", "file", "stage"};
+    std::vector<std::string> inputs;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            threads = std::max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            prefix = argv[++i];
+        } else if (strcmp(argv[i], "--levels") == 0 && i + 1 < argc) {
+            levels.clear();
+            std::string list = argv[++i];
+            for (size_t pos = 0; pos <= list.size();) {
+                size_t comma = list.find(',', pos);
+                if (comma == std::string::npos)
+                    comma = list.size();
+                levels.insert(list.substr(pos, comma - pos));
+                pos = comma + 1;
+            }
+        } else if (strcmp(argv[i], "--task-order") == 0 && i + 1 < argc) {
+            task_order = argv[++i];
+        } else if (strcmp(argv[i], "--addr-buckets") == 0 && i + 1 < argc) {
+            buckets = std::max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--merge-pids") == 0) {
+            MERGE_PIDS = true;
+        } else if (strcmp(argv[i], "--linear") == 0) {
+            linear = true;
+        } else if (argv[i][0] == '-') {
+            Usage(argv[0]);
+            return 2;
+        } else {
+            inputs.push_back(argv[i]);
+        }
+    }
+    for (const std::string& lv : levels) {
+        if (lv != "io" && lv != "dataset" && lv != "file" && lv != "stage") {
+            std::cerr << "unknown level " << lv << std::endl;
+            Usage(argv[0]);
+            return 2;
+        }
+    }
+    if (inputs.empty() || levels.empty()) {
+        Usage(argv[0]);
+        return 2;
+    }
+    WANT_IO = levels.count("io") > 0;
+
+    // like load_task_order_list(), a stat directory may hold its own list
+    if (task_order.empty()) {
+        for (const std::string& in : inputs) {
+            std::error_code ec;
+            if (std::filesystem::exists(in + "/task_order_list.json", ec)) {
+                task_order = in + "/task_order_list.json";
+                break;
+            }
+        }
+    }
+    if (!task_order.empty() && !LoadTaskOrder(task_order))
+        return 1;
+
+    std::vector<std::string> files = dayu::FindVfdStatFiles(inputs);
+    if (files.empty()) {
+        std::cerr << "no VFD stat files found" << std::endl;
+        return 1;
+    }
+    Graph graph;
+    dayu::ScanOptions opt;
+    opt.ranges = WANT_IO;
+    size_t failed = dayu::ScanVfdStatFiles<Graph>(files, opt, threads, AddRecord,
+        [&graph](Graph& local) { graph.Merge(local); });
+    if (graph.tasks.empty()) {
+        std::cerr << "no task file records found" << (TASK_ORDER.empty() ? "" : " for the task order list")
+            << std::endl;
+        return 1;
+    }
+
+    Layout layout = MakeLayout(graph, buckets);
+    bool ok = true;
+    if (levels.count("stage"))
+        ok &= WriteLevel(prefix + "-stage.json", StageLevel(graph, layout), layout.stages, linear);
+    if (levels.count("file"))
+        ok &= WriteLevel(prefix + "-file.json", FileLevel(graph, layout), layout.stages, linear);
+    if (levels.count("dataset"))
+        ok &= WriteLevel(prefix + "-dataset.json", DatasetLevel(graph, layout), layout.stages, linear);
+    if (levels.count("io"))
+        ok &= WriteLevel(prefix + "-io.json", IoLevel(graph, layout), layout.stages, linear);
+
+    std::cerr << files.size() << " stat files (" << failed << " with errors): " << graph.tasks.size()
+        << " tasks, " << graph.files.size() << " files, " << layout.stages.size() << " stages" << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,552 @@
+#ifndef DAYU_STAT_SCAN_HPP
+#define DAYU_STAT_SCAN_HPP
+
+// Streaming scan of VFD stat files for the offline tools. JSON stat files
+// (array or JSON Lines, plain or gzip), dayu-collector node files and
+// columnar files are read record by record; each VFD file record is handed
+// to a callback and dropped, so memory stays bounded by one record whatever
+// the input size. Page ranges are skipped unless asked for.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <filesystem>
+#include <stdexcept>
+
+#include <zlib.h>
+
+#include "../core/dayu_collector.h"
+#include "dayu_colstat_reader.hpp"
+
+namespace dayu {
+
+// Pull tokenizer over a gzread() stream, which reads plain files as is.
+// Commas and colons are separators only, a string followed by ':' is a key.
+class JsonPull {
+public:
+    enum Tok { kEnd, kObjBegin, kObjEnd, kArrBegin, kArrEnd, kKey, kStr, kNum, kTrue, kFalse, kNull };
+
+    explicit JsonPull(const std::string& path) : path_(path) {
+        gz_ = gzopen(path.c_str(), "rb");
+        if (!gz_)
+            throw std::runtime_error("cannot open " + path);
+        gzbuffer(gz_, 1 << 18);
+    }
+    ~JsonPull() { gzclose(gz_); }
+    JsonPull(const JsonPull&) = delete;
+    JsonPull& operator=(const JsonPull&) = delete;
+
+    Tok next() {
+        int ch;
+        for (;;) {
+            ch = get();
+            if (ch == ',' || ch == ':' || ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t')
+                continue;
+            break;
+        }
+        switch (ch) {
+            case -1: return kEnd;
+            case '{': return kObjBegin;
+            case '}': return kObjEnd;
+            case '[': return kArrBegin;
+            case ']': return kArrEnd;
+            case '"':
+                ReadString();
+                for (ch = peek(); ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t'; ch = peek())
+                    get();
+                return ch == ':' ? kKey : kStr;
+            case 't': Expect("rue"); return kTrue;
+            case 'f': Expect("alse"); return kFalse;
+            case 'n': Expect("ull"); return kNull;
+            default:
+                if (ch == '-' || (ch >= '0' && ch <= '9')) {
+                    text_.assign(1, (char)ch);
+                    for (ch = peek(); ch == '-' || ch == '+' || ch == '.' || ch == 'e' || ch == 'E'
+                            || (ch >= '0' && ch <= '9'); ch = peek())
+                        text_ += (char)get();
+                    return kNum;
+                }
+                throw std::runtime_error(path_ + ": unexpected character in JSON");
+        }
+    }
+
+    // Key or string text, or the digits of a number
+    const std::string& text() const { return text_; }
+    double num() const { return strtod(text_.c_str(), nullptr); }
+    uint64_t u64() const {
+        double v = num();
+        return v > 0 ? (uint64_t)v : 0;
+    }
+
+    // Skip the rest of a value whose first token was tok
+    void skip(Tok tok) {
+        int depth = (tok == kObjBegin || tok == kArrBegin) ? 1 : 0;
+        while (depth > 0) {
+            Tok t = next();
+            if (t == kObjBegin || t == kArrBegin)
+                depth++;
+            else if (t == kObjEnd || t == kArrEnd)
+                depth--;
+            else if (t == kEnd)
+                throw std::runtime_error(path_ + ": truncated JSON");
+        }
+    }
+
+    // Number value of the next token, 0 for anything else (skipped)
+    uint64_t NextU64() {
+        Tok t = next();
+        if (t == kNum)
+            return u64();
+        skip(t);
+        return 0;
+    }
+    std::string NextStr() {
+        Tok t = next();
+        if (t == kStr)
+            return text_;
+        skip(t);
+        return "";
+    }
+
+private:
+    std::string path_;
+    gzFile gz_ = nullptr;
+    std::vector<char> buf_ = std::vector<char>(1 << 16);
+    size_t pos_ = 0;
+    size_t len_ = 0;
+    std::string text_;
+
+    int peek() {
+        if (pos_ == len_) {
+            int n = gzread(gz_, buf_.data(), (unsigned)buf_.size());
+            if (n <= 0) // a gzip member cut short by a crash ends the input
+                return -1;
+            pos_ = 0;
+            len_ = (size_t)n;
+        }
+        return (unsigned char)buf_[pos_];
+    }
+    int get() {
+        int ch = peek();
+        if (ch >= 0)
+            pos_++;
+        return ch;
+    }
+    void Expect(const char* rest) {
+        for (; *rest; rest++)
+            if (get() != *rest)
+                throw std::runtime_error(path_ + ": bad JSON literal");
+    }
+    void PutUtf8(unsigned cp) {
+        if (cp < 0x80) {
+            text_ += (char)cp;
+        } else if (cp < 0x800) {
+            text_ += (char)(0xc0 | (cp >> 6));
+            text_ += (char)(0x80 | (cp & 0x3f));
+        } else if (cp < 0x10000) {
+            text_ += (char)(0xe0 | (cp >> 12));
+            text_ += (char)(0x80 | ((cp >> 6) & 0x3f));
+            text_ += (char)(0x80 | (cp & 0x3f));
+        } else {
+            text_ += (char)(0xf0 | (cp >> 18));
+            text_ += (char)(0x80 | ((cp >> 12) & 0x3f));
+            text_ += (char)(0x80 | ((cp >> 6) & 0x3f));
+            text_ += (char)(0x80 | (cp & 0x3f));
+        }
+    }
+    unsigned Hex4() {
+        char hex[5] = {0};
+        for (int i = 0; i < 4; i++)
+            hex[i] = (char)get();
+        return (unsigned)strtoul(hex, nullptr, 16);
+    }
+    void ReadString() {
+        text_.clear();
+        for (;;) {
+            int ch = get();
+            if (ch < 0)
+                throw std::runtime_error(path_ + ": unterminated JSON string");
+            if (ch == '"')
+                return;
+            if (ch != '\\') {
+                text_ += (char)ch;
+                continue;
+            }
+            ch = get();
+            switch (ch) {
+                case 'n': text_ += '\n'; break;
+                case 't': text_ += '\t'; break;
+                case 'r': text_ += '\r'; break;
+                case 'b': text_ += '\b'; break;
+                case 'f': text_ += '\f'; break;
+                case 'u': {
+                    unsigned cp = Hex4();
+                    if (cp >= 0xd800 && cp < 0xdc00 && get() == '\\' && get() == 'u')
+                        cp = 0x10000 + ((cp - 0xd800) << 10) + (Hex4() - 0xdc00);
+                    PutUtf8(cp);
+                    break;
+                }
+                default: text_ += (char)ch; // '"', '\\' and '/'
+            }
+        }
+    }
+};
+
+// One page range of a memory-type stat, io_idx orders the file's I/O
+struct VfdRange {
+    int64_t io_idx;
+    uint64_t start_page;
+    uint64_t end_page;
+    bool write;
+};
+
+// One memory type of one dataset in a file record
+struct VfdMemStat {
+    std::string dset_name;
+    std::string mem_type;
+    bool raw = false;                   // "data" section, "metadata" otherwise
+    uint64_t read_bytes = 0;
+    uint64_t read_cnt = 0;
+    uint64_t write_bytes = 0;
+    uint64_t write_cnt = 0;
+    std::vector<VfdRange> ranges;       // only with ScanOptions::ranges
+};
+
+// One VFD file record, a whole file or one delta of it
+struct VfdFileRecord {
+    std::string task_name;
+    std::string file_name;
+    std::string file_type;              // input, output, input-output or na
+    uint64_t open_time = 0;             // us since the epoch
+    uint64_t close_time = 0;
+    uint64_t file_read_cnt = 0;
+    uint64_t file_write_cnt = 0;
+    uint64_t io_bytes = 0;
+    uint64_t file_size = 0;
+    std::vector<VfdMemStat> mems;
+};
+
+struct ScanOptions {
+    bool ranges = false;
+};
+
+using VfdRecordFn = std::function<void(const VfdFileRecord&)>;
+
+namespace detail {
+
+inline void ScanRanges(JsonPull& jp, bool write, std::vector<VfdRange>* out) {
+    JsonPull::Tok t = jp.next();
+    if (t != JsonPull::kObjBegin || !out) {
+        jp.skip(t);
+        return;
+    }
+    while ((t = jp.next()) == JsonPull::kKey) {
+        int64_t io_idx = strtoll(jp.text().c_str(), nullptr, 10);
+        t = jp.next();
+        if (t != JsonPull::kArrBegin) {
+            jp.skip(t);
+            continue;
+        }
+        uint64_t start = jp.NextU64();
+        uint64_t end = jp.NextU64();
+        jp.skip(JsonPull::kArrBegin); // the closing ']'
+        out->push_back({io_idx, start, end, write});
+    }
+}
+
+// "data" / "metadata": [{dset_name: {mem_type: {...}}}]
+inline void ScanDsetSection(JsonPull& jp, bool raw, const ScanOptions& opt, VfdFileRecord& rec) {
+    JsonPull::Tok t = jp.next();
+    if (t != JsonPull::kArrBegin) {
+        jp.skip(t);
+        return;
+    }
+    while ((t = jp.next()) == JsonPull::kObjBegin) {
+        while ((t = jp.next()) == JsonPull::kKey) {
+            std::string dset_name = jp.text();
+            if ((t = jp.next()) != JsonPull::kObjBegin) {
+                jp.skip(t);
+                continue;
+            }
+            while ((t = jp.next()) == JsonPull::kKey) {
+                VfdMemStat mem;
+                mem.dset_name = dset_name;
+                mem.mem_type = jp.text();
+                mem.raw = raw;
+                if ((t = jp.next()) != JsonPull::kObjBegin) {
+                    jp.skip(t);
+                    continue;
+                }
+                while ((t = jp.next()) == JsonPull::kKey) {
+                    const std::string& key = jp.text();
+                    if (key == "read_bytes")
+                        mem.read_bytes = jp.NextU64();
+                    else if (key == "read_cnt")
+                        mem.read_cnt = jp.NextU64();
+                    else if (key == "write_bytes")
+                        mem.write_bytes = jp.NextU64();
+                    else if (key == "write_cnt")
+                        mem.write_cnt = jp.NextU64();
+                    else if (key == "read_ranges" || key == "write_ranges")
+                        ScanRanges(jp, key[0] == 'w', opt.ranges ? &mem.ranges : nullptr);
+                    else
+                        jp.skip(jp.next());
+                }
+                rec.mems.push_back(std::move(mem));
+            }
+        }
+    }
+    if (t != JsonPull::kArrEnd)
+        jp.skip(t);
+}
+
+inline void ScanFileRecord(JsonPull& jp, const ScanOptions& opt, VfdFileRecord& rec) {
+    JsonPull::Tok t;
+    while ((t = jp.next()) == JsonPull::kKey) {
+        const std::string& key = jp.text();
+        if (key == "task_name")
+            rec.task_name = jp.NextStr();
+        else if (key == "file_name")
+            rec.file_name = jp.NextStr();
+        else if (key == "file_type")
+            rec.file_type = jp.NextStr();
+        else if (key == "open_time(us)")
+            rec.open_time = jp.NextU64();
+        else if (key == "close_time(us)")
+            rec.close_time = jp.NextU64();
+        else if (key == "file_read_cnt")
+            rec.file_read_cnt = jp.NextU64();
+        else if (key == "file_write_cnt")
+            rec.file_write_cnt = jp.NextU64();
+        else if (key == "io_bytes")
+            rec.io_bytes = jp.NextU64();
+        else if (key == "file_size")
+            rec.file_size = jp.NextU64();
+        else if (key == "data" || key == "metadata")
+            ScanDsetSection(jp, key == "data", opt, rec);
+        else
+            jp.skip(jp.next());
+    }
+}
+
+inline void ScanJson(const std::string& path, const ScanOptions& opt, const VfdRecordFn& fn) {
+    JsonPull jp(path);
+    JsonPull::Tok t;
+
+    // records are the objects at the top level, or inside the top-level array
+    while ((t = jp.next()) != JsonPull::kEnd) {
+        if (t == JsonPull::kArrBegin || t == JsonPull::kArrEnd)
+            continue;
+        if (t != JsonPull::kObjBegin) {
+            jp.skip(t);
+            continue;
+        }
+        VfdFileRecord rec;
+        bool is_file = false;
+        while ((t = jp.next()) == JsonPull::kKey) {
+            bool file_key = jp.text().compare(0, 5, "file-") == 0;
+            t = jp.next();
+            if (file_key && t == JsonPull::kObjBegin) {
+                ScanFileRecord(jp, opt, rec);
+                is_file = true;
+            } else {
+                jp.skip(t);
+            }
+        }
+        // VOL file records in collector files have no task or file type
+        if (is_file && !rec.file_type.empty())
+            fn(rec);
+    }
+}
+
+inline std::string ColStr(const ColFile& cf, const ColTable& t, const char* col, uint64_t row) {
+    const ColColumn& c = t.col(col);
+    return c.type == DAYU_COL_STR ? cf.str(c.str_id(row)) : std::to_string(c.u64(row));
+}
+
+inline uint64_t ColU64(const ColTable& t, const char* col, uint64_t row) {
+    const ColColumn& c = t.col(col);
+    return c.type == DAYU_COL_F64 ? (uint64_t)c.f64(row) : c.u64(row);
+}
+
+inline void ScanColumnar(const std::string& path, const ScanOptions& opt, const VfdRecordFn& fn) {
+    ColFile cf(path);
+    const ColTable* file = cf.table("vfd_file");
+    const ColTable* dset = cf.table("vfd_dset");
+    const ColTable* mem = cf.table("vfd_mem");
+    const ColTable* ranges = cf.table("vfd_range");
+    if (!file || !dset || !mem || !ranges)
+        throw std::runtime_error(path + ": not a VFD stat file");
+
+    for (uint64_t f = 0; f < file->rows; f++) {
+        VfdFileRecord rec;
+        rec.task_name = ColStr(cf, *file, "task_name", f);
+        rec.file_name = ColStr(cf, *file, "file_name", f);
+        rec.file_type = ColStr(cf, *file, "file_type", f);
+        rec.open_time = ColU64(*file, "open_time(us)", f);
+        rec.close_time = ColU64(*file, "close_time(us)", f);
+        rec.file_read_cnt = ColU64(*file, "file_read_cnt", f);
+        rec.file_write_cnt = ColU64(*file, "file_write_cnt", f);
+        rec.io_bytes = ColU64(*file, "io_bytes", f);
+        rec.file_size = ColU64(*file, "file_size", f);
+
+        uint64_t dset_first = file->col("dset_first").u64(f);
+        uint64_t dset_cnt = file->col("dset_cnt").u64(f);
+        for (uint64_t d = dset_first; d < dset_first + dset_cnt; d++) {
+            uint64_t mem_first = dset->col("mem_first").u64(d);
+            uint64_t mem_cnt = dset->col("mem_cnt").u64(d);
+            for (uint64_t m = mem_first; m < mem_first + mem_cnt; m++) {
+                VfdMemStat ms;
+                ms.dset_name = cf.str(dset->col("dset_name").str_id(d));
+                ms.mem_type = cf.str(mem->col("mem_type").str_id(m));
+                ms.raw = mem->col("raw").u64(m) != 0;
+                ms.read_bytes = mem->col("read_bytes").u64(m);
+                ms.read_cnt = (uint64_t)mem->col("read_cnt").i64(m);
+                ms.write_bytes = mem->col("write_bytes").u64(m);
+                ms.write_cnt = (uint64_t)mem->col("write_cnt").i64(m);
+                if (opt.ranges) {
+                    uint64_t first = mem->col("range_first").u64(m);
+                    uint64_t n_read = mem->col("read_range_cnt").u64(m);
+                    uint64_t n_all = n_read + mem->col("write_range_cnt").u64(m);
+                    for (uint64_t r = first; r < first + n_all; r++)
+                        ms.ranges.push_back({ranges->col("io_idx").i64(r), ranges->col("start_page").u64(r),
+                            ranges->col("end_page").u64(r), r >= first + n_read});
+                }
+                rec.mems.push_back(std::move(ms));
+            }
+        }
+        fn(rec);
+    }
+}
+
+inline bool EndsWith(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+} // namespace detail
+
+// Task name without its pid suffix, "openmm-40876" -> "openmm"
+inline std::string TaskBaseName(const std::string& task_name) {
+    size_t dash = task_name.rfind('-');
+    if (dash == std::string::npos || dash + 1 == task_name.size()
+        || task_name.find_first_not_of("0123456789", dash + 1) != std::string::npos)
+        return task_name;
+    return task_name.substr(0, dash);
+}
+
+// Every VFD file record of a stat file, in file order
+inline void ScanVfdStat(const std::string& path, const ScanOptions& opt, const VfdRecordFn& fn) {
+    if (detail::EndsWith(path, DAYU_COL_SUFFIX))
+        detail::ScanColumnar(path, opt, fn);
+    else
+        detail::ScanJson(path, opt, fn);
+}
+
+// Quoted and escaped for the tools' JSON output
+inline std::string JsonStr(const std::string& s) {
+    std::string out = "\"";
+    for (unsigned char ch : s) {
+        if (ch == '"' || ch == '\\') {
+            out += '\\';
+            out += (char)ch;
+        } else if (ch < 0x20) {
+            char esc[8];
+            snprintf(esc, sizeof(esc), "\\u%04x", ch);
+            out += esc;
+        } else {
+            out += (char)ch;
+        }
+    }
+    return out + "\"";
+}
+
+// VFD stat files under each path: <pid>-vfd_data_stat.json[.gz], .jsonl,
+// .dcs, and collector node files (.dayu), which hold VOL records too.
+// zstd files are reported and left out, `zstd -d` them first.
+inline std::vector<std::string> FindVfdStatFiles(const std::vector<std::string>& paths) {
+    namespace fs = std::filesystem;
+    std::vector<std::string> found;
+
+    auto consider = [&found](const fs::path& p, bool named) {
+        std::string name = p.filename().string();
+        if (detail::EndsWith(name, ".zst")) {
+            fprintf(stderr, "skipping %s, decompress zstd stat files first\n", p.c_str());
+            return;
+        }
+        if (detail::EndsWith(name, DAYU_COLLECTOR_DATA_SUFFIX)
+            || (name.find("vfd") != std::string::npos
+                && (name.find(".json") != std::string::npos || detail::EndsWith(name, DAYU_COL_SUFFIX)))
+            || named)
+            found.push_back(p.string());
+    };
+    for (const std::string& path : paths) {
+        std::error_code ec;
+        if (fs::is_directory(path, ec)) {
+            for (auto it = fs::recursive_directory_iterator(path, ec); it != fs::recursive_directory_iterator();
+                 it.increment(ec)) {
+                if (ec)
+                    break;
+                if (it->is_regular_file(ec))
+                    consider(it->path(), false);
+            }
+        } else {
+            consider(path, true);
+        }
+    }
+    return found;
+}
+
+// Scan files on up to `threads` workers, large files first so one big file
+// does not start last. Each file's records go to add() on a fresh Partial,
+// which merge() then takes under a lock. Records before a scan error are
+// kept; returns the number of files with errors.
+template <typename Partial, typename AddFn, typename MergeFn>
+size_t ScanVfdStatFiles(std::vector<std::string> files, const ScanOptions& opt, unsigned threads,
+                        AddFn add, MergeFn merge) {
+    std::vector<std::pair<uintmax_t, std::string>> by_size;
+    for (std::string& f : files) {
+        std::error_code ec;
+        by_size.emplace_back(std::filesystem::file_size(f, ec), std::move(f));
+    }
+    std::sort(by_size.begin(), by_size.end(), std::greater<>());
+
+    std::mutex merge_mutex;
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> failed{0};
+    std::vector<std::thread> workers;
+    for (unsigned w = 0; w < std::min<size_t>(threads, by_size.size()); w++) {
+        workers.emplace_back([&]() {
+            for (size_t i; (i = next.fetch_add(1)) < by_size.size();) {
+                Partial local;
+                try {
+                    ScanVfdStat(by_size[i].second, opt, [&local, &add](const VfdFileRecord& rec) {
+                        add(local, rec);
+                    });
+                } catch (const std::exception& e) {
+                    std::lock_guard<std::mutex> lock(merge_mutex);
+                    std::cerr << e.what() << ", records before the error are kept" << std::endl;
+                    failed++;
+                }
+                std::lock_guard<std::mutex> lock(merge_mutex);
+                merge(local);
+            }
+        });
+    }
+    for (std::thread& t : workers)
+        t.join();
+    return failed;
+}
+
+} // namespace dayu
+
+#endif /* DAYU_STAT_SCAN_HPP */
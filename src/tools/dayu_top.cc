@@ -0,0 +1,399 @@
+// dayu-top: live per-task and per-file I/O rates of the tracked processes on
+// this node, read from the shared memory regions they publish with
+// TRACKER_LIVE=1 (see src/core/dayu_live.h).
+//
+//   dayu-top [-d seconds] [-n rows] [-i iterations] [-b] [-a] [--clean]
+//
+// Regions are mapped read-only and sampled every -d seconds (default 2);
+// rates are the difference of two samples. -b prints plain frames instead
+// of redrawing the terminal, -i stops after that many frames, -a includes
+// other users' regions and --clean removes regions left by exited
+// processes and quits.
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <ctime>
+#include <string>
+#include <vector>
+#include <map>
+#include <iostream>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+#include "../core/dayu_live.h"
+
+namespace {
+
+volatile sig_atomic_t STOP = 0;
+
+void OnStop(int) { STOP = 1; }
+
+unsigned long TimeUsec() {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    return (unsigned long)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+struct Region {
+    std::string shm;                    // name under /dev/shm
+    const dayu_live_region_t* live = nullptr;
+};
+
+// One file slot as seen in a sample
+struct Slot {
+    int pid;
+    int index;
+    dayu_live_file_t f;
+};
+
+struct Rate {
+    double read = 0;                    // bytes/s, VFD
+    double write = 0;
+    double iops = 0;                    // VFD reads and writes
+    double dsets = 0;                   // VOL dataset reads and writes
+    uint64_t ops = 0;                   // VFD ops in the interval
+    uint64_t usec = 0;
+    uint64_t hist[DAYU_LIVE_HIST] = {};
+};
+
+void Usage(const char* prog) {
+    std::cerr << "usage: " << prog << " [-d seconds] [-n rows] [-i iterations] [-b] [-a] [--clean]" << std::endl;
+}
+
+bool Alive(int pid) {
+    return kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+// Regions in /dev/shm, of this user unless all_users
+std::vector<std::string> ListRegions(bool all_users) {
+    std::vector<std::string> names;
+    std::string prefix = DAYU_LIVE_SHM_PREFIX;
+
+    if (!all_users)
+        prefix += std::to_string((unsigned)getuid()) + "-";
+    DIR* dir = opendir("/dev/shm");
+    if (!dir)
+        return names;
+    while (struct dirent* ent = readdir(dir)) {
+        if (strncmp(ent->d_name, prefix.c_str(), prefix.size()) == 0)
+            names.push_back(ent->d_name);
+    }
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+// Null while the region is not yet sized and filled in, or from another
+// version; a tracker killed before sizing it leaves it empty
+const dayu_live_region_t* MapRegion(const std::string& name) {
+    struct stat st;
+    int fd = shm_open(("/" + name).c_str(), O_RDONLY, 0);
+    if (fd < 0)
+        return nullptr;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(dayu_live_region_t)) {
+        close(fd);
+        return nullptr;
+    }
+    void* addr = mmap(nullptr, sizeof(dayu_live_region_t), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED)
+        return nullptr;
+    auto live = (const dayu_live_region_t*)addr;
+    if (__atomic_load_n(&live->magic, __ATOMIC_ACQUIRE) != DAYU_LIVE_MAGIC || live->version != DAYU_LIVE_VERSION
+        || live->nfiles != DAYU_LIVE_FILES) {
+        munmap(addr, sizeof(dayu_live_region_t));
+        return nullptr;
+    }
+    return live;
+}
+
+// Keep the mapped regions in step with /dev/shm
+void Refresh(std::map<std::string, Region>& regions, bool all_users) {
+    std::vector<std::string> names = ListRegions(all_users);
+    for (auto it = regions.begin(); it != regions.end();) {
+        if (!std::binary_search(names.begin(), names.end(), it->first)) {
+            if (it->second.live)
+                munmap((void*)it->second.live, sizeof(dayu_live_region_t));
+            it = regions.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (auto& name : names) {
+        Region& r = regions[name];
+        if (!r.live) {
+            r.shm = name;
+            r.live = MapRegion(name);   // retried next frame while the header is being filled
+        }
+    }
+}
+
+// Seqlock reader side, false when writers kept the slot busy
+bool ReadSlot(const dayu_live_file_t* src, dayu_live_file_t* dst) {
+    for (int tries = 0; tries < 1000; tries++) {
+        uint32_t seq = __atomic_load_n(&src->seq, __ATOMIC_ACQUIRE);
+        if (seq & 1)
+            continue;
+        memcpy(dst, src, sizeof(*dst));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&src->seq, __ATOMIC_RELAXED) == seq)
+            return true;
+    }
+    return false;
+}
+
+std::vector<Slot> Sample(const std::map<std::string, Region>& regions) {
+    std::vector<Slot> slots;
+    for (auto& kv : regions) {
+        const dayu_live_region_t* live = kv.second.live;
+        if (!live)
+            continue;
+        for (int i = 0; i < DAYU_LIVE_FILES; i++) {
+            if (__atomic_load_n(&live->files[i].state, __ATOMIC_RELAXED) == DAYU_LIVE_FREE)
+                continue;
+            Slot s;
+            s.pid = live->pid;
+            s.index = i;
+            if (ReadSlot(&live->files[i], &s.f) && s.f.state != DAYU_LIVE_FREE)
+                slots.push_back(s);
+        }
+    }
+    return slots;
+}
+
+// Rate of one slot between two samples, prev is null for a file opened
+// during the interval
+Rate SlotRate(const dayu_live_file_t& cur, const dayu_live_file_t* prev, double sec) {
+    Rate r;
+    for (int rw = 0; rw < 2; rw++) {
+        const dayu_live_io_t& vfd = cur.io[DAYU_LIVE_VFD][rw];
+        const dayu_live_io_t& vol = cur.io[DAYU_LIVE_VOL][rw];
+        const dayu_live_io_t* pvfd = prev ? &prev->io[DAYU_LIVE_VFD][rw] : nullptr;
+        const dayu_live_io_t* pvol = prev ? &prev->io[DAYU_LIVE_VOL][rw] : nullptr;
+        uint64_t bytes = vfd.bytes - (pvfd ? pvfd->bytes : 0);
+        uint64_t ops = vfd.ops - (pvfd ? pvfd->ops : 0);
+
+        (rw ? r.write : r.read) = bytes / sec;
+        r.iops += ops / sec;
+        r.dsets += (vol.ops - (pvol ? pvol->ops : 0)) / sec;
+        r.ops += ops;
+        r.usec += vfd.usec - (pvfd ? pvfd->usec : 0);
+        for (int b = 0; b < DAYU_LIVE_HIST; b++)
+            r.hist[b] += vfd.hist[b] - (pvfd ? pvfd->hist[b] : 0);
+    }
+    return r;
+}
+
+void Add(Rate& sum, const Rate& r) {
+    sum.read += r.read;
+    sum.write += r.write;
+    sum.iops += r.iops;
+    sum.dsets += r.dsets;
+    sum.ops += r.ops;
+    sum.usec += r.usec;
+    for (int b = 0; b < DAYU_LIVE_HIST; b++)
+        sum.hist[b] += r.hist[b];
+}
+
+// Upper bound of the bucket holding the 99th percentile, in us
+uint64_t P99(const Rate& r) {
+    uint64_t seen = 0;
+    for (int b = 0; b < DAYU_LIVE_HIST; b++) {
+        seen += r.hist[b];
+        if (seen * 100 >= r.ops * 99)
+            return 1ull << b;
+    }
+    return 1ull << (DAYU_LIVE_HIST - 1);
+}
+
+std::string HumanRate(double n) {
+    static const char* suffixes[] = {"B", "KB", "MB", "GB", "TB"};
+    int i = 0;
+    while (n >= 1000 && i < 4) {
+        n /= 1000;
+        i++;
+    }
+    char buf[32];
+    snprintf(buf, sizeof(buf), i ? "%.1f %s" : "%.0f %s", n, suffixes[i]);
+    return buf;
+}
+
+// Last width characters, the distinguishing end of a path
+std::string Tail(const char* s, size_t width) {
+    size_t len = strlen(s);
+    return len > width ? "~" + std::string(s + len - (width - 1)) : std::string(s);
+}
+
+// since_usec is when prev was sampled
+void PrintFrame(const std::map<std::string, Region>& regions, const std::vector<Slot>& cur,
+                const std::vector<Slot>& prev, unsigned long since_usec, double sec, size_t rows, bool batch) {
+    std::map<std::pair<int, int>, const Slot*> before;
+    for (auto& s : prev)
+        before[{s.pid, s.index}] = &s;
+
+    struct Row {
+        const Slot* slot;
+        Rate rate;
+    };
+    std::vector<Row> files;
+    std::map<std::string, std::pair<Rate, int>> tasks;
+    int nproc = 0, exited = 0, nopen = 0;
+    uint64_t dropped = 0;
+
+    for (auto& kv : regions) {
+        if (!kv.second.live)
+            continue;
+        nproc++;
+        if (!Alive(kv.second.live->pid))
+            exited++;
+        dropped += kv.second.live->files_dropped;
+    }
+    for (auto& s : cur) {
+        auto it = before.find({s.pid, s.index});
+        const dayu_live_file_t* p = nullptr;
+        if (it != before.end() && it->second->f.open_usec == s.f.open_usec)
+            p = &it->second->f;
+        if (s.f.state == DAYU_LIVE_OPEN)
+            nopen++;
+        // closed before this interval, nothing new to show
+        if (s.f.state == DAYU_LIVE_CLOSED && (p == nullptr || p->state == DAYU_LIVE_CLOSED))
+            continue;
+        // region mapped after the last sample, no baseline yet
+        if (p == nullptr && s.f.open_usec < since_usec)
+            continue;
+        Row row{&s, SlotRate(s.f, p, sec)};
+        auto& task = tasks[s.f.task_name];
+        Add(task.first, row.rate);
+        task.second++;
+        files.push_back(row);
+    }
+    std::sort(files.begin(), files.end(), [](const Row& a, const Row& b) {
+        return a.rate.read + a.rate.write > b.rate.read + b.rate.write;
+    });
+    std::vector<std::pair<std::string, std::pair<Rate, int>>> task_rows(tasks.begin(), tasks.end());
+    std::sort(task_rows.begin(), task_rows.end(), [](const auto& a, const auto& b) {
+        return a.second.first.read + a.second.first.write > b.second.first.read + b.second.first.write;
+    });
+
+    char stamp[32];
+    time_t now = time(nullptr);
+    strftime(stamp, sizeof(stamp), "%H:%M:%S", localtime(&now));
+    if (!batch)
+        printf("\033[H\033[2J");
+    printf("dayu-top - %s  processes %d", stamp, nproc);
+    if (exited)
+        printf(" (%d exited)", exited);
+    printf("  files open %d  interval %.1f s", nopen, sec);
+    if (dropped)
+        printf("  untracked opens %lu", (unsigned long)dropped);
+    printf("\n\n%-32s %5s %10s %10s %8s %8s\n", "TASK", "FILES", "READ/s", "WRITE/s", "IOPS", "DSET/s");
+    for (auto& t : task_rows) {
+        const Rate& r = t.second.first;
+        printf("%-32s %5d %10s %10s %8.0f %8.0f\n", Tail(t.first.c_str(), 32).c_str(), t.second.second,
+               HumanRate(r.read).c_str(), HumanRate(r.write).c_str(), r.iops, r.dsets);
+    }
+    printf("\n%-36s %-20s %-20s %10s %10s %8s %8s %8s\n", "FILE", "TASK", "DATASET", "READ/s", "WRITE/s", "IOPS",
+           "AVG_US", "P99_US");
+    for (size_t i = 0; i < files.size() && i < rows; i++) {
+        const dayu_live_file_t& f = files[i].slot->f;
+        const Rate& r = files[i].rate;
+        std::string file = Tail(f.file_name, 36);
+        if (f.state == DAYU_LIVE_CLOSED)
+            file = Tail(f.file_name, 27) + " (closed)";
+        printf("%-36s %-20s %-20s %10s %10s %8.0f %8.0f %8lu\n", file.c_str(), Tail(f.task_name, 20).c_str(),
+               Tail(f.dset_name, 20).c_str(), HumanRate(r.read).c_str(), HumanRate(r.write).c_str(), r.iops,
+               r.ops ? (double)r.usec / r.ops : 0.0, r.ops ? (unsigned long)P99(r) : 0ul);
+    }
+    if (files.size() > rows)
+        printf("... %zu more\n", files.size() - rows);
+    printf("\n");
+    fflush(stdout);
+}
+
+// Remove regions of processes that exited without unlinking them
+int Clean(bool all_users) {
+    int removed = 0;
+    for (auto& name : ListRegions(all_users)) {
+        // pid from the name, an empty region left mid-creation has no header
+        size_t dash = name.rfind('-');
+        int pid = dash == std::string::npos ? 0 : atoi(name.c_str() + dash + 1);
+        if (pid <= 0 || Alive(pid))
+            continue;
+        if (shm_unlink(("/" + name).c_str()) == 0) {
+            removed++;
+        } else {
+            std::cerr << "dayu-top: cannot remove " << name << ": " << strerror(errno) << std::endl;
+        }
+    }
+    std::cout << "removed " << removed << " region(s) of exited processes" << std::endl;
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    double interval = 2;
+    size_t rows = 20;
+    long iterations = 0;
+    bool batch = !isatty(STDOUT_FILENO);
+    bool all_users = false;
+    bool clean = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            interval = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            rows = (size_t)atol(argv[++i]);
+        } else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) {
+            iterations = atol(argv[++i]);
+        } else if (strcmp(argv[i], "-b") == 0) {
+            batch = true;
+        } else if (strcmp(argv[i], "-a") == 0) {
+            all_users = true;
+        } else if (strcmp(argv[i], "--clean") == 0) {
+            clean = true;
+        } else {
+            Usage(argv[0]);
+            return 2;
+        }
+    }
+    if (interval <= 0) {
+        Usage(argv[0]);
+        return 2;
+    }
+    if (clean)
+        return Clean(all_users);
+
+    signal(SIGINT, OnStop);
+    signal(SIGTERM, OnStop);
+
+    std::map<std::string, Region> regions;
+    Refresh(regions, all_users);
+    std::vector<Slot> prev = Sample(regions);
+    unsigned long last = TimeUsec();
+
+    for (long frame = 0; !STOP && (iterations <= 0 || frame < iterations); frame++) {
+        struct timespec ts = {(time_t)interval, (long)((interval - (time_t)interval) * 1e9)};
+        while (nanosleep(&ts, &ts) != 0 && !STOP) {
+        }
+        if (STOP)
+            break;
+        unsigned long now = TimeUsec();
+        std::vector<Slot> cur = Sample(regions);
+        PrintFrame(regions, cur, prev, last, (now - last) / 1e6, rows, batch);
+        prev.swap(cur);
+        last = now;
+        // files of new processes get rates from the frame after they are seen
+        Refresh(regions, all_users);
+    }
+    return 0;
+}
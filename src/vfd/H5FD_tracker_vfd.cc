@@ -612,6 +612,7 @@ static herr_t H5FD__tracker_vfd_close(H5FD_t *_file) {
   /* custom VFD code start */
 
   DumpJsonFileStat(TKR_HELPER_VFD, file->vfd_file_info);
+  dayu_live_file_close(file->vfd_file_info->live_slot);
   rmVFDFileNode(TKR_HELPER_VFD, _file);
   /* custom VFD code end */
 
@@ -977,7 +978,7 @@ static herr_t H5FD__tracker_vfd_read(H5FD_t *_file, H5FD_mem_t type,
 
 #ifdef ACCESS_STAT
   /* custom VFD code start */
-  VFD_ACCESS_IDX++;
+  TKR_ADD(VFD_ACCESS_IDX, 1);
   // check if VFD_ACCESS_IDX is every ACCESS_INX_SKIP'th access
   // if(VFD_ACCESS_IDX % ACCESS_INX_SKIP == 0 || VFD_ACCESS_IDX == 1)
 
@@ -1113,7 +1114,7 @@ static herr_t H5FD__tracker_vfd_write(H5FD_t *_file, H5FD_mem_t type,
 
 #ifdef ACCESS_STAT
   /* custom VFD code start */
-  VFD_ACCESS_IDX++;
+  TKR_ADD(VFD_ACCESS_IDX, 1);
   // check if VFD_ACCESS_IDX is every 10th access
   // if(VFD_ACCESS_IDX % ACCESS_INX_SKIP == 0 || VFD_ACCESS_IDX == 1)
   updateReadWriteInfo("H5FD__tracker_vfd_write", file->filename, file->my_fapl_id ,_file,
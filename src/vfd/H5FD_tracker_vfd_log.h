@@ -39,6 +39,9 @@
 #include <fcntl.h>
 #include <iostream>
 #include <map>
+#include <set>
+#include <unordered_map>
+#include <algorithm>
 
 // #include <mpi.h>
 
@@ -47,6 +50,7 @@
 #include "H5FD_tracker_vfd.h"     /* Tracker VFD file driver     */
 #include "H5FD_tracker_vfd_err.h" /* Error handling         */
 #include "../vol/tracker_vol_types.h" /* Connecting to vol */
+#include "../core/dayu_colstat.h" /* Columnar stat output */
 #include "../utils/debug/timer.h" /* for recording time */
 
 
@@ -95,6 +99,14 @@
 #define MAX_CONF_STR_LENGTH 128
 #define H5FD_MAX_FILENAME_LEN 1024 // same as H5FD_MAX_FILENAME_LEN
 #define VFD_STAT_FILE_NAME "vfd_data_stat.json"
+#define VFD_COLSTAT_FILE_NAME "vfd_data_stat" DAYU_COL_SUFFIX
+
+// Page buffer sizing simulation (SHARDS sampled reuse distance)
+#define PAGEBUF_SIM_MAX_SAMPLES 8192       // sampled pages kept per stream
+#define PAGEBUF_SIM_HASH_MOD (1UL << 24)   // SHARDS hash space
+#define PAGEBUF_SIM_BUCKETS 48             // log2 reuse distance buckets
+#define PAGEBUF_SIM_TARGET_HIT 0.9
+#define PAGEBUF_SIM_MIN_GAIN 0.01          // curve is flat below this gain
 
 
 /************/
@@ -130,9 +142,16 @@ std::string read_func = "H5FD__tracker_vfd_read";
 std::string write_func = "H5FD__tracker_vfd_write";
 #define ACCESS_INX_SKIP 5
 
-// // Declare the shared memory region
-// #define SHM_NAME "/tracker_shm"
-// #define SHM_SIZE 256
+/* VFD uses vars*/
+unsigned long VFD_ACCESS_IDX;
+unsigned long TOTAL_VFD_READ;
+unsigned long TOTAL_VFD_WRITE;
+
+unsigned long START_ADDR;
+unsigned long END_ADDR;
+unsigned long ACC_SIZE;
+unsigned long START_PAGE;
+unsigned long END_PAGE;
 
 typedef struct VFDTrackerHelper {
     /* VFDTrackerHelper properties */
@@ -148,6 +167,18 @@ typedef struct VFDTrackerHelper {
     vfd_file_tkr_info_t* vfd_opened_files;//linkedlist,
     size_t tracker_vfd_page_size;
 
+    /* columnar stat output, col_writer is nullptr when writing JSON */
+    dayu_col_writer_t* col_writer;
+    dayu_col_table_t* col_file;
+    dayu_col_table_t* col_dset;
+    dayu_col_table_t* col_mem;
+    dayu_col_table_t* col_range;
+
+    dayu_sink_t log_sink; // JSON records, written by a background thread
+
+    dayu_flush_t flush;   // incremental flush policy
+    size_t flush_held;    // page range bytes held since the last flush
+
 } vfd_tkr_helper_t;
 
 static vfd_tkr_helper_t* TKR_HELPER_VFD = nullptr;
@@ -182,14 +213,34 @@ struct h5_dset_info_t {
     h5_mem_stat_t * h5_super; // H5FD_MEM_SUPER 
     h5_mem_stat_t * h5_btree; // H5FD_MEM_BTREE
     h5_mem_stat_t * h5_lheap; // H5FD_MEM_LHEAP
+    h5_mem_stat_t * h5_gheap; // H5FD_MEM_GHEAP, vlen data and references
+    h5_mem_stat_t * h5_default; // H5FD_MEM_DEFAULT
+    h5_mem_stat_t * h5_other; // H5FD_MEM_NTYPES, H5FD_MEM_NOLIST and unknown types
 
-    /* beloe types not added 
-    H5FD_MEM_DEFAULT, 
-    H5FD_MEM_GHEAP, 
-    H5FD_MEM_NTYPES, 
-    H5FD_MEM_NOLIST
-    */
+};
+
+/* One-pass LRU reuse distance of a page stream, bounded by a
+ * fixed-size SHARDS sample: a page is tracked only while
+ * hash(page) % PAGEBUF_SIM_HASH_MOD < threshold, and the threshold
+ * drops to the largest tracked hash when the sample set is full.
+ * Distances are scaled by 1/rate, references weighted by 1/rate. */
+struct reuse_sample_t {
+    uint64_t hash;
+    uint32_t ts; // position in the fenwick tree
+};
 
+struct reuse_sim_t {
+    std::unordered_map<size_t, reuse_sample_t> pages;
+    std::set<std::pair<uint64_t, size_t>> by_hash; // eviction order
+    std::vector<uint32_t> fenwick; // live last-access timestamps
+    uint32_t next_ts;
+    uint64_t threshold;
+    size_t max_samples;
+    size_t refs;          // every page reference seen
+    size_t sampled_refs;
+    double weighted_refs;
+    double cold;          // first references, miss at any size
+    double hist[PAGEBUF_SIM_BUCKETS]; // bucket 0: d == 0, b: d in [2^(b-1), 2^b)
 };
 
 typedef std::map<std::string, h5_dset_info_t*> DsetInfoMap;
@@ -211,6 +262,16 @@ struct H5FD_tkr_file_info_t { // used by VFD
     size_t io_bytes;
 
     DsetInfoMap h5_dset_info_map;
+    reuse_sim_t* meta_reuse; // all metadata mem types
+    reuse_sim_t* raw_reuse;  // H5FD_MEM_DRAW
+
+    const char* core_file_key;      // interned file name, key in the core dataset registry
+    size_t amap_raw_hits;           // raw I/O attributed by address
+    size_t amap_raw_misses;         // raw I/O left to the context string
+    size_t amap_ctx_differs;        // address and context string disagreed
+
+    unsigned long delta_seq;        // delta records written, 0 without incremental flushing
+    int live_slot;                  // slot in the live stats region, -1 when not published
     
     int ref_cnt;
     double open_time;
@@ -262,7 +323,7 @@ typedef struct H5FD_tracker_vfd_t {
 
 /* function prototypes*/
 std::string getFileIntentFlagsStr(unsigned int flags);
-void UpdateDsetStat(int rw, size_t start_page, 
+void UpdateDsetStat(int rw, haddr_t addr, size_t start_page,
   size_t end_page, size_t access_size, H5FD_mem_t type, vfd_file_tkr_info_t * info);
 void HelperUpdateMemTypeStat(int rw, size_t start_page, 
   size_t end_page, size_t access_size, h5_mem_stat_t* mem_stat);
@@ -282,13 +343,24 @@ void OpenCloseInfoPrint(const char* func_name, void * obj, const char * file_nam
 
 
 
-void DumpJsonFileStat(vfd_tkr_helper_t* helper, const vfd_file_tkr_info_t* info);
+reuse_sim_t* newReuseSim();
+void ReuseSimAccess(reuse_sim_t* sim, size_t start_page, size_t end_page);
+double ReuseSimHitRate(const reuse_sim_t* sim, size_t cache_pages);
+size_t ReuseSimPick(const reuse_sim_t* sim, double target);
+void DumpJsonPageBufValue(FILE* f, const vfd_file_tkr_info_t* info);
+void DumpJsonPageBufStat(FILE* f, const vfd_file_tkr_info_t* info);
+
+void DumpJsonFileStat(vfd_tkr_helper_t* helper, const vfd_file_tkr_info_t* info, bool delta = false);
 void DumpJsonDsetStat(FILE* f, const vfd_file_tkr_info_t* info);
 void DumpJsonMemStat(FILE* f, const h5_mem_stat_t* mem_stat);
+void ColStatInit(vfd_tkr_helper_t* helper, const char* file_path);
+void DumpColFileStat(vfd_tkr_helper_t* helper, const vfd_file_tkr_info_t* info, bool delta);
+void FlushVFDFileStats(vfd_tkr_helper_t* helper);
 
 void parseEnvironmentVariable(char* file_path);
 vfd_tkr_helper_t * vfdTkrHelperInit( char* file_path, size_t page_size, hbool_t logStat);
 void freeFileInfo(vfd_file_tkr_info_t* info);
+void freeDsetInfo(h5_dset_info_t* dset_info);
 vfd_file_tkr_info_t* newVFDFileInfo(const char* fname, unsigned long file_no);
 vfd_file_tkr_info_t* addVFDFileNode(vfd_tkr_helper_t * helper, const char* file_name, void * obj);
 int rmVFDFileNode(vfd_tkr_helper_t* helper, H5FD_t *_file);
@@ -324,68 +396,16 @@ bool extractPipeHandle(const std::string& commandLine, int& pipeHandle) {
     return false;
 }
 
-bool getCurrentTaskFromFile(std::string& curr_task) {
-    // Get environment variables
-    const char* path_for_task_files = std::getenv("PATH_FOR_TASK_FILES");
-    const char* workflow_name = std::getenv("WORKFLOW_NAME");
-
-    if (path_for_task_files && workflow_name) {
-        // Construct the full file path
-        std::string file_path = std::string(path_for_task_files) + "/" + std::string(workflow_name) + "_vfd.curr_task";
-
-        // Open the file with exclusive lock
-        int fd = open(file_path.c_str(), O_RDONLY);
-        if (fd != -1) {
-            struct flock lock;
-            lock.l_type = F_RDLCK;
-            lock.l_start = 0;
-            lock.l_whence = SEEK_SET;
-            lock.l_len = 0;
-
-            // Attempt to obtain a shared lock on the file
-            if (fcntl(fd, F_SETLK, &lock) != -1) {
-                // Read the file content into a string
-                std::ifstream file_stream(file_path);
-                if (file_stream) {
-                    std::stringstream buffer;
-                    buffer << file_stream.rdbuf();
-                    curr_task = buffer.str();
-
-                    close(fd);  // Release the lock
-                    return true;
-                } else {
-                    printf("H5FD_tracker_vfd_log.h: getCurrentTaskFromFile() Failed to read file: %s\n", file_path.c_str());
-                }
-            } else {
-                printf("H5FD_tracker_vfd_log.h: getCurrentTaskFromFile() Failed to obtain lock on file: %s\n", file_path.c_str());
-            }
-            close(fd);
-        } else {
-            printf("H5FD_tracker_vfd_log.h: getCurrentTaskFromFile() Failed to open file: %s - %s\n", file_path.c_str(), strerror(errno));
-        }
-    } else {
-        printf("H5FD_tracker_vfd_log.h: getCurrentTaskFromFile() Missing environment variables: PATH_FOR_TASK_FILES and/or WORKFLOW_NAME\n");
-    }
-
-    return false;
-}
-
+// Cached in libdayu_core and shared with the VOL, the task file is only
+// read again when it changes
 std::string getTaskName() {
-    // Check if the environment variable CURR_TASK is set
-    const char* curr_task_env = std::getenv("CURR_TASK");
-    
-    if (curr_task_env) {
-        return std::string(curr_task_env) + "-" + std::to_string(getpid());
-    } else {
-        // If CURR_TASK is not set, try reading it from a file
-        std::string curr_task;
-        if (getCurrentTaskFromFile(curr_task)) {
-            return curr_task + "-" + std::to_string(getpid());
-        } else {
-            // If both methods fail, return an empty string
-            return "";
-        }
-    }
+    char* curr_task = NULL;
+    std::string task_name;
+
+    if (dayu_task_name(&curr_task))
+        task_name = std::string(curr_task) + "-" + std::to_string(getpid());
+    free(curr_task);
+    return task_name;
 }
 
 // Function to get the full command line for a given PID
@@ -598,28 +618,18 @@ void DumpJsonDsetStat(FILE* f, const vfd_file_tkr_info_t* info) {
   // Print the dataset info map
   for (auto const& [dset_name, dset_info] : info->h5_dset_info_map) {
       fprintf(f, "\t\t\t\"%s\": {\n", dset_name.c_str());
+      const h5_mem_stat_t* meta_stats[] = {dset_info->h5_ohdr, dset_info->h5_super,
+          dset_info->h5_btree, dset_info->h5_lheap, dset_info->h5_gheap,
+          dset_info->h5_default, dset_info->h5_other};
       int prevs = 0;
-      if (dset_info->h5_ohdr != nullptr) {
-          DumpJsonMemStat(f, dset_info->h5_ohdr);
-          prevs = 1;
-      }
-      if (dset_info->h5_super != nullptr) {
-          if (prevs == 1)
-              fprintf(f, "\t\t\t\t,\n");
-          DumpJsonMemStat(f, dset_info->h5_super);
-          prevs = 1;
-      }
-      if (dset_info->h5_btree != nullptr) {
+      for (const h5_mem_stat_t* mem_stat : meta_stats) {
+          if (mem_stat == nullptr)
+              continue;
           if (prevs == 1)
               fprintf(f, "\t\t\t\t,\n");
-          DumpJsonMemStat(f, dset_info->h5_btree);
+          DumpJsonMemStat(f, mem_stat);
           prevs = 1;
       }
-      if (dset_info->h5_lheap != nullptr) {
-          if (prevs == 1)
-              fprintf(f, "\t\t\t\t,\n");
-          DumpJsonMemStat(f, dset_info->h5_lheap);
-      }
       // If dset_name is the last element, do not write comma
       if( dset_name != info->h5_dset_info_map.rbegin()->first){
         fprintf(f, "\t\t\t},\n");
@@ -631,6 +641,61 @@ void DumpJsonDsetStat(FILE* f, const vfd_file_tkr_info_t* info) {
   fprintf(f, "\t\t}]\n");
 }
 
+static void DumpJsonReuseSim(FILE* f, const reuse_sim_t* sim, size_t page_size) {
+    if (sim == nullptr || sim->weighted_refs == 0) {
+        fprintf(f, "null");
+        return;
+    }
+    int top = 0;
+    for (int b = 0; b < PAGEBUF_SIM_BUCKETS; b++)
+        if (sim->hist[b] > 0)
+            top = b;
+
+    fprintf(f, "{\"page_refs\": %zu, \"sampled_refs\": %zu, ", sim->refs, sim->sampled_refs);
+    fprintf(f, "\"sample_rate\": %.6f, ", (double)sim->threshold / PAGEBUF_SIM_HASH_MOD);
+    fprintf(f, "\"hit_rate_curve\": [");
+    for (int k = 0; k <= top; k++) {
+        fprintf(f, "%s[%zu, %.4f]", k ? ", " : "", ((size_t)1 << k) * page_size,
+            ReuseSimHitRate(sim, (size_t)1 << k));
+    }
+    fprintf(f, "]}");
+}
+
+// Reuse-distance curves of metadata and raw pages and the
+// H5Pset_page_buffer_size() values they suggest
+void DumpJsonPageBufValue(FILE* f, const vfd_file_tkr_info_t* info) {
+    const char* target_env = std::getenv("TRACKER_PAGEBUF_TARGET");
+    double target = PAGEBUF_SIM_TARGET_HIT;
+    size_t page_size = info->adaptor_page_size;
+
+    if (target_env && atof(target_env) > 0)
+        target = atof(target_env);
+
+    fprintf(f, "{\"page_size\": %zu, \"target_hit_rate\": %.2f, ", page_size, target);
+    fprintf(f, "\"metadata\": ");
+    DumpJsonReuseSim(f, info->meta_reuse, page_size);
+    fprintf(f, ", \"raw\": ");
+    DumpJsonReuseSim(f, info->raw_reuse, page_size);
+
+    size_t meta_pages = ReuseSimPick(info->meta_reuse, target);
+    size_t raw_pages = ReuseSimPick(info->raw_reuse, target);
+    size_t total = meta_pages + raw_pages;
+    if (total == 0) {
+        fprintf(f, ", \"recommend\": null}");
+        return;
+    }
+    // Guaranteed shares, the rest of the buffer is used on demand
+    fprintf(f, ", \"recommend\": {\"buf_size\": %zu, \"min_meta_perc\": %zu, \"min_raw_perc\": %zu, ",
+        total * page_size, meta_pages * 100 / total, raw_pages * 100 / total);
+    fprintf(f, "\"meta_hit_rate\": %.4f, \"raw_hit_rate\": %.4f}}",
+        ReuseSimHitRate(info->meta_reuse, meta_pages), ReuseSimHitRate(info->raw_reuse, raw_pages));
+}
+
+void DumpJsonPageBufStat(FILE* f, const vfd_file_tkr_info_t* info) {
+    fprintf(f, "\t\t\"page_buffer\": ");
+    DumpJsonPageBufValue(f, info);
+    fprintf(f, ",\n");
+}
 
 
 
@@ -665,6 +730,44 @@ std::string getFileIntentFlagsStr(unsigned int flags) {
 
 
 
+// Append a page range, coarser as the tracker memory budget fills: a range
+// touching the previous one is merged into it, then only one range in
+// DAYU_MEM_SAMPLE_EVERY is kept. Counts and bytes stay exact.
+static void AppendPageRange(page_range_t** head, page_range_t** tail, int cnt,
+  size_t start_page, size_t end_page)
+{
+    dayu_mem_level_t level = dayu_mem_level();
+
+    if (level >= DAYU_MEM_COARSEN && *tail != nullptr
+        && start_page <= (*tail)->end_page + 1 && end_page + 1 >= (*tail)->start_page) {
+        (*tail)->start_page = std::min((*tail)->start_page, start_page);
+        (*tail)->end_page = std::max((*tail)->end_page, end_page);
+        dayu_mem_degraded(DAYU_MEM_MERGED, "vfd");
+        return;
+    }
+    if (level >= DAYU_MEM_SAMPLE && cnt % DAYU_MEM_SAMPLE_EVERY != 0) {
+        dayu_mem_degraded(DAYU_MEM_SAMPLED, "vfd");
+        return;
+    }
+
+    page_range_t* new_range = new page_range_t();
+    new_range->start_page = start_page;
+    new_range->end_page = end_page;
+    new_range->io_idx= VFD_ACCESS_IDX;
+    new_range->next = nullptr;
+
+    if (*head == nullptr) {
+        *head = new_range;
+        *tail = new_range;
+    } else {
+        (*tail)->next = new_range;
+        *tail = new_range;
+    }
+    dayu_mem_charge(sizeof(page_range_t));
+    if (TKR_HELPER_VFD != nullptr)
+        TKR_HELPER_VFD->flush_held += sizeof(page_range_t);
+}
+
 void HelperUpdateMemTypeStat(int rw, size_t start_page, 
   size_t end_page, size_t access_size, h5_mem_stat_t* mem_stat) 
 {
@@ -674,43 +777,28 @@ void HelperUpdateMemTypeStat(int rw, size_t start_page,
 #endif
 
     if (rw == 1) { // read
-        page_range_t* new_range = new page_range_t();
-        new_range->start_page = start_page;
-        new_range->end_page = end_page;
-        new_range->io_idx= VFD_ACCESS_IDX;
-        new_range->next = nullptr;
-
-        if (mem_stat->read_ranges == nullptr) {
-            mem_stat->read_ranges = new_range;
-            mem_stat->read_ranges_tail = new_range;
-        } else {
-            mem_stat->read_ranges_tail->next = new_range;
-            mem_stat->read_ranges_tail = new_range;
-        }
-
+        AppendPageRange(&mem_stat->read_ranges, &mem_stat->read_ranges_tail, mem_stat->read_cnt,
+            start_page, end_page);
         mem_stat->read_cnt++;
         mem_stat->read_bytes += access_size;
 
     } else if (rw == 2) { // write
-        page_range_t* new_range = new page_range_t();
-        new_range->start_page = start_page;
-        new_range->end_page = end_page;
-        new_range->io_idx= VFD_ACCESS_IDX;
-        new_range->next = nullptr;
-
-        if (mem_stat->write_ranges == nullptr) {
-            mem_stat->write_ranges = new_range;
-            mem_stat->write_ranges_tail = new_range;
-        } else {
-            mem_stat->write_ranges_tail->next = new_range;
-            mem_stat->write_ranges_tail = new_range;
-        }
-
+        AppendPageRange(&mem_stat->write_ranges, &mem_stat->write_ranges_tail, mem_stat->write_cnt,
+            start_page, end_page);
         mem_stat->write_cnt++;
         mem_stat->write_bytes += access_size;
     }
 }
 
+static h5_mem_stat_t* MemTypeStat(h5_mem_stat_t** slot, const char* mem_type)
+{
+    if (*slot == nullptr) {
+        *slot = new h5_mem_stat_t();
+        (*slot)->mem_type = mem_type;
+        dayu_mem_charge(sizeof(h5_mem_stat_t));
+    }
+    return *slot;
+}
 
 void UpdateMemTypeStat(int rw, size_t start_page, 
   size_t end_page, size_t access_size, H5FD_mem_t type, h5_dset_info_t * info)
@@ -720,95 +808,174 @@ void UpdateMemTypeStat(int rw, size_t start_page,
   std::cout << "UpdateMemTypeStat() : " << info->group_dset_name << std::endl;
 #endif
 
+  h5_mem_stat_t* mem_stat;
   switch(type) {
     case H5FD_MEM_DRAW:
-      if (info->h5_draw == nullptr) {
-        info->h5_draw = new h5_mem_stat_t();
-        info->h5_draw->mem_type = "H5FD_MEM_DRAW";
-      }
-      HelperUpdateMemTypeStat(rw, start_page, end_page, access_size, info->h5_draw);
-      
+      mem_stat = MemTypeStat(&info->h5_draw, "H5FD_MEM_DRAW");
       break;
     case H5FD_MEM_OHDR:
-      if (info->h5_ohdr == nullptr) {
-        info->h5_ohdr = new h5_mem_stat_t();
-        info->h5_ohdr->mem_type = "H5FD_MEM_OHDR";
-      }
-      HelperUpdateMemTypeStat(rw, start_page, end_page, access_size, info->h5_ohdr);
+      mem_stat = MemTypeStat(&info->h5_ohdr, "H5FD_MEM_OHDR");
       break;
     case H5FD_MEM_SUPER:
-      if (info->h5_super == nullptr) {
-          info->h5_super = new h5_mem_stat_t();
-          info->h5_super->mem_type = "H5FD_MEM_SUPER";
-      }
-      HelperUpdateMemTypeStat(rw, start_page, end_page, access_size, info->h5_super);
+      mem_stat = MemTypeStat(&info->h5_super, "H5FD_MEM_SUPER");
       break;
     case H5FD_MEM_BTREE:
-      if (info->h5_btree == nullptr) {
-          info->h5_btree = new h5_mem_stat_t();
-          info->h5_btree->mem_type = "H5FD_MEM_BTREE";
-      }
-      HelperUpdateMemTypeStat(rw, start_page, end_page, access_size, info->h5_btree);
+      mem_stat = MemTypeStat(&info->h5_btree, "H5FD_MEM_BTREE");
       break;
     case H5FD_MEM_LHEAP:
-      if (info->h5_lheap == nullptr) {
-          info->h5_lheap = new h5_mem_stat_t();
-          info->h5_lheap->mem_type = "H5FD_MEM_LHEAP";
-      }
-      HelperUpdateMemTypeStat(rw, start_page, end_page, access_size, info->h5_lheap);
+      mem_stat = MemTypeStat(&info->h5_lheap, "H5FD_MEM_LHEAP");
       break;
     case H5FD_MEM_GHEAP:
-      break;
-    case H5FD_MEM_NTYPES:
-      break;
-    case H5FD_MEM_NOLIST:
+      mem_stat = MemTypeStat(&info->h5_gheap, "H5FD_MEM_GHEAP");
       break;
     case H5FD_MEM_DEFAULT:
+      mem_stat = MemTypeStat(&info->h5_default, "H5FD_MEM_DEFAULT");
       break;
+    case H5FD_MEM_NTYPES:
+    case H5FD_MEM_NOLIST:
     default:
+      mem_stat = MemTypeStat(&info->h5_other, "H5FD_MEM_OTHER");
       break;
   }
+  HelperUpdateMemTypeStat(rw, start_page, end_page, access_size, mem_stat);
 }
 
-std::string GetDsetName() {
-    pid_t pid = getpid();
-    size_t len = strlen(SHM_NAME) + 1 + sizeof(pid) * 3; // +1 for null terminator
-    char *task_shm_name = new char[len];
-    snprintf(task_shm_name, len, "%s_%d", SHM_NAME, pid);
-
-    // // Check if shared memory exists before open:
-    // struct stat shm_stat;
-    // if (stat(task_shm_name, &shm_stat) == -1) { // this always return -1
-    //     delete[] task_shm_name;
-    //     return "unknown";  // Return unknown if shared memory dataset is not available
-    // }
-
-    // Open the shared memory
-    int shm_fd = shm_open(task_shm_name, O_RDONLY, 0666);
-    if (shm_fd == -1) {
-  #ifdef DEBUG_TRK_VFD
-        printf("H5FD_tracker_vfd_log.h: GetDsetName() Failed to open shared memory: %s\n", strerror(errno));
-  #endif
-        delete[] task_shm_name;
-        return "unknown";  // Return unknown if shared memory dataset is not available
-    } else {
-#ifdef DEBUG_TRK_VFD
-  std::cout << "H5FD_tracker_vfd_log.h: GetDsetName() Successful read to shm name : " << task_shm_name << std::endl;
-#endif
+/* Page buffer reuse distance simulation start */
+static uint64_t ReuseSimHash(size_t page) {
+    uint64_t x = (uint64_t)page + 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return (x ^ (x >> 31)) % PAGEBUF_SIM_HASH_MOD;
+}
+
+static void ReuseSimFenwickAdd(reuse_sim_t* sim, uint32_t i, int v) {
+    for (; i < sim->fenwick.size(); i += i & (-i))
+        sim->fenwick[i] += v;
+}
+
+static size_t ReuseSimFenwickSum(const reuse_sim_t* sim, uint32_t i) {
+    size_t sum = 0;
+    for (; i > 0; i -= i & (-i))
+        sum += sim->fenwick[i];
+    return sum;
+}
+
+// Renumber live timestamps 1..n once the tree runs out of slots
+static void ReuseSimCompact(reuse_sim_t* sim) {
+    std::vector<std::pair<uint32_t, size_t>> order;
+    order.reserve(sim->pages.size());
+    for (auto const& [page, sample] : sim->pages)
+        order.emplace_back(sample.ts, page);
+    std::sort(order.begin(), order.end());
+
+    std::fill(sim->fenwick.begin(), sim->fenwick.end(), 0);
+    sim->next_ts = 1;
+    for (auto const& [ts, page] : order) {
+        sim->pages[page].ts = sim->next_ts;
+        ReuseSimFenwickAdd(sim, sim->next_ts++, 1);
     }
+}
 
-    char* curr_dset = (char*)mmap(0, SHM_SIZE, PROT_READ, MAP_SHARED, shm_fd, 0);
-    close(shm_fd);
+reuse_sim_t* newReuseSim() {
+    reuse_sim_t* sim = new reuse_sim_t();
+    const char* samples_env = std::getenv("TRACKER_PAGEBUF_SAMPLES");
+
+    sim->max_samples = PAGEBUF_SIM_MAX_SAMPLES;
+    if (samples_env && atol(samples_env) > 0)
+        sim->max_samples = (size_t)atol(samples_env);
+    sim->fenwick.assign(4 * sim->max_samples + 1, 0);
+    sim->next_ts = 1;
+    sim->threshold = PAGEBUF_SIM_HASH_MOD;
+    return sim;
+}
 
-    // Convert to C++ string
-    std::string dataset_name(curr_dset);
+static void ReuseSimTouch(reuse_sim_t* sim, size_t page) {
+    sim->refs++;
+    uint64_t hash = ReuseSimHash(page);
+    if (hash >= sim->threshold)
+        return;
+
+    double rate = (double)sim->threshold / PAGEBUF_SIM_HASH_MOD;
+    sim->sampled_refs++;
+    sim->weighted_refs += 1.0 / rate;
+
+    if (sim->next_ts >= sim->fenwick.size())
+        ReuseSimCompact(sim);
+
+    auto it = sim->pages.find(page);
+    if (it != sim->pages.end()) {
+        // Distinct sampled pages touched since the last reference
+        size_t d = sim->pages.size() - ReuseSimFenwickSum(sim, it->second.ts);
+        size_t scaled = (size_t)(d / rate);
+        int b = scaled == 0 ? 0 : 64 - __builtin_clzll(scaled);
+        sim->hist[std::min(b, PAGEBUF_SIM_BUCKETS - 1)] += 1.0 / rate;
+
+        ReuseSimFenwickAdd(sim, it->second.ts, -1);
+        it->second.ts = sim->next_ts;
+        ReuseSimFenwickAdd(sim, sim->next_ts++, 1);
+        return;
+    }
 
-    delete[] task_shm_name;
+    sim->cold += 1.0 / rate;
+    sim->pages[page] = {hash, sim->next_ts};
+    sim->by_hash.insert({hash, page});
+    ReuseSimFenwickAdd(sim, sim->next_ts++, 1);
+
+    // Sample set full: lower the threshold to the largest tracked hash
+    while (sim->pages.size() > sim->max_samples) {
+        sim->threshold = std::prev(sim->by_hash.end())->first;
+        while (!sim->by_hash.empty() && std::prev(sim->by_hash.end())->first >= sim->threshold) {
+            auto last = std::prev(sim->by_hash.end());
+            auto evict = sim->pages.find(last->second);
+            ReuseSimFenwickAdd(sim, evict->second.ts, -1);
+            sim->pages.erase(evict);
+            sim->by_hash.erase(last);
+        }
+    }
+}
 
-    return dataset_name;
+void ReuseSimAccess(reuse_sim_t* sim, size_t start_page, size_t end_page) {
+    for (size_t page = start_page; page <= end_page; page++)
+        ReuseSimTouch(sim, page);
 }
 
-void UpdateDsetStat(int rw, size_t start_page, 
+// LRU hit rate of a buffer holding cache_pages pages, rounded down to a power of two
+double ReuseSimHitRate(const reuse_sim_t* sim, size_t cache_pages) {
+    if (sim == nullptr || sim->weighted_refs == 0 || cache_pages == 0)
+        return 0;
+    int k = 63 - __builtin_clzll(cache_pages);
+    double hits = 0;
+    for (int b = 0; b <= k && b < PAGEBUF_SIM_BUCKETS; b++)
+        hits += sim->hist[b];
+    return hits / sim->weighted_refs;
+}
+
+// Smallest power-of-two page count reaching the target hit rate, or
+// where growing further gains less than PAGEBUF_SIM_MIN_GAIN
+size_t ReuseSimPick(const reuse_sim_t* sim, double target) {
+    if (sim == nullptr || sim->weighted_refs == 0)
+        return 0;
+    double max_hit = (sim->weighted_refs - sim->cold) / sim->weighted_refs;
+    double goal = std::min(target, max_hit - PAGEBUF_SIM_MIN_GAIN);
+    if (goal <= 0)
+        return 0;
+    for (int k = 0; k < PAGEBUF_SIM_BUCKETS - 1; k++) {
+        if (ReuseSimHitRate(sim, (size_t)1 << k) >= goal)
+            return (size_t)1 << k;
+    }
+    return (size_t)1 << (PAGEBUF_SIM_BUCKETS - 2);
+}
+/* Page buffer reuse distance simulation end */
+
+// Dataset the calling thread is doing I/O for, as set by the VOL
+std::string GetDsetName() {
+    const char* dset_name = dayu_ctx_get();
+    if (dset_name[0] == '\0')
+        return "unknown";  // Return unknown if no VOL context is available
+    return std::string(dset_name);
+}
+
+void UpdateDsetStat(int rw, haddr_t addr, size_t start_page,
   size_t end_page, size_t access_size, H5FD_mem_t type, vfd_file_tkr_info_t * info){
 
 #ifdef DEBUG_TRK_VFD
@@ -820,6 +987,22 @@ void UpdateDsetStat(int rw, size_t start_page,
   std::string dset_name = GetDsetName();
   // unknown is a acceptable dataset name
 
+  // Raw data goes to the dataset owning the address, the context string
+  // is only right while the VOL callback is running (not for evictions
+  // and flushes at close)
+  if (type == H5FD_MEM_DRAW) {
+    const char* owner = dayu_dset_at(info->core_file_key, (uint64_t)addr);
+    if (owner != nullptr) {
+      info->amap_raw_hits++;
+      if (dset_name != owner) {
+        info->amap_ctx_differs++;
+        dset_name = owner;
+      }
+    } else {
+      info->amap_raw_misses++;
+    }
+  }
+
 
 #ifdef DEBUG_TRK_VFD
   std::cout << "UpdateDsetStat() dset_name = " << dset_name << std::endl;
@@ -829,6 +1012,7 @@ void UpdateDsetStat(int rw, size_t start_page,
     // h5_dset_info_t * new_dset_info = new h5_dset_info_t();
     info->h5_dset_info_map[dset_name] = new h5_dset_info_t();
     info->h5_dset_info_map[dset_name]->group_dset_name = dset_name;
+    dayu_mem_charge(sizeof(h5_dset_info_t) + dset_name.size());
   }
   UpdateMemTypeStat(rw, start_page, end_page, access_size, type, info->h5_dset_info_map[dset_name]);
 
@@ -851,6 +1035,8 @@ void updateReadWriteInfo(std::string func_name, char * file_name, hid_t fapl_id,
   if (info->file_name == nullptr){
     info->file_name = file_name;
   }
+  if (info->core_file_key == nullptr)
+    info->core_file_key = dayu_intern(file_name); // as passed to H5Fopen, like the VOL's
 
 
   if (!info->io_bytes || info->io_bytes == 0){
@@ -860,14 +1046,35 @@ void updateReadWriteInfo(std::string func_name, char * file_name, hid_t fapl_id,
   }
 
   if(func_name == read_func){
-    TOTAL_VFD_READ += size;
+    TKR_ADD(TOTAL_VFD_READ, size);
     info->file_read_cnt++;
-    UpdateDsetStat(1, addr/page_size, (addr+size-1)/page_size, size, type, info);
+    UpdateDsetStat(1, addr, addr/page_size, (addr+size-1)/page_size, size, type, info);
   } 
   if(func_name == write_func){
-    TOTAL_VFD_WRITE += size;
+    TKR_ADD(TOTAL_VFD_WRITE, size);
     info->file_write_cnt++;
-    UpdateDsetStat(2, addr/page_size, (addr+size-1)/page_size, size, type, info);
+    UpdateDsetStat(2, addr, addr/page_size, (addr+size-1)/page_size, size, type, info);
+  }
+  if (info->live_slot >= 0)
+    dayu_live_io(info->live_slot, DAYU_LIVE_VFD, func_name == write_func, size,
+      (unsigned long)(timer.GetUsFromEpoch() - t_start), dayu_ctx_get());
+
+  if (size > 0 && page_size > 0) {
+    reuse_sim_t** sim = (type == H5FD_MEM_DRAW) ? &info->raw_reuse : &info->meta_reuse;
+    if (*sim == nullptr)
+      *sim = newReuseSim();
+    ReuseSimAccess(*sim, addr/page_size, (addr+size-1)/page_size);
+  }
+
+  // Write what a long-lived file gathered so far and release it, early
+  // when the memory budget is nearly spent and the VFD holds a good part of it
+  if (TKR_HELPER_VFD != nullptr) {
+    if (dayu_flush_due(&TKR_HELPER_VFD->flush, TKR_HELPER_VFD->flush_held)) {
+      FlushVFDFileStats(TKR_HELPER_VFD);
+    } else if (dayu_mem_level() == DAYU_MEM_SPILL && TKR_HELPER_VFD->flush_held >= dayu_mem_used() / 4) {
+      dayu_mem_degraded(DAYU_MEM_SPILLED, "vfd");
+      FlushVFDFileStats(TKR_HELPER_VFD);
+    }
   }
 
 
@@ -1105,10 +1312,13 @@ vfd_tkr_helper_t * vfdTkrHelperInit( char* file_path, size_t page_size, hbool_t
     new_helper->tracker_vfd_page_size = page_size;
     /* VFD vars end */
 
-    // New json file list
-    FILE * f = fopen(new_helper->tkr_file_path, "a");
-    fprintf(f, "[");
-    fclose(f);
+    // Columnar stat file on request, otherwise a new json file list
+    const char* fmt_env = std::getenv("TRACKER_LOG_FORMAT");
+    if (fmt_env && strcmp(fmt_env, "columnar") == 0)
+        ColStatInit(new_helper, file_path);
+    if (new_helper->col_writer == nullptr)
+        dayu_sink_open(&new_helper->log_sink, new_helper->tkr_file_path);
+    dayu_flush_init(&new_helper->flush);
 
     // Get the user's login name
     if (getlogin_r(new_helper->user_name, sizeof(new_helper->user_name)) != 0) {
@@ -1134,12 +1344,43 @@ void freeFileInfo(vfd_file_tkr_info_t* info)
     // if(info->task_name)
     //   free((void*)(info->task_name));
 
+    for (auto const& [dset_name, dset_info] : info->h5_dset_info_map)
+        freeDsetInfo(dset_info);
     info->h5_dset_info_map.clear();
+    delete info->meta_reuse;
+    delete info->raw_reuse;
 
     free(info);
 }
 
 
+static void freePageRanges(page_range_t* range)
+{
+    while (range != nullptr) {
+        page_range_t* next = range->next;
+        delete range;
+        dayu_mem_charge(-(long)sizeof(page_range_t));
+        range = next;
+    }
+}
+
+void freeDsetInfo(h5_dset_info_t* dset_info)
+{
+    h5_mem_stat_t* mem_stats[] = {dset_info->h5_draw, dset_info->h5_ohdr, dset_info->h5_super,
+        dset_info->h5_btree, dset_info->h5_lheap, dset_info->h5_gheap,
+        dset_info->h5_default, dset_info->h5_other};
+
+    for (h5_mem_stat_t* mem_stat : mem_stats) {
+        if (mem_stat == nullptr)
+            continue;
+        freePageRanges(mem_stat->read_ranges);
+        freePageRanges(mem_stat->write_ranges);
+        delete mem_stat;
+        dayu_mem_charge(-(long)sizeof(h5_mem_stat_t));
+    }
+    dayu_mem_charge(-(long)(sizeof(h5_dset_info_t) + dset_info->group_dset_name.size()));
+    delete dset_info;
+}
 
 vfd_file_tkr_info_t* newVFDFileInfo(const char* fname, unsigned long file_no)
 {
@@ -1159,9 +1400,7 @@ vfd_file_tkr_info_t* newVFDFileInfo(const char* fname, unsigned long file_no)
 
     info->file_no = file_no;
 
-    // dlLockAcquire(&myLock);
-    info->sorder_id =++FILE_SORDER;
-    // dlLockRelease(&myLock);
+    info->sorder_id = TKR_NEXT_ID(FILE_SORDER);
 
     info->open_time = timer.GetUsFromEpoch();
     info->file_read_cnt = 0;
@@ -1211,6 +1450,7 @@ vfd_file_tkr_info_t* addVFDFileNode(vfd_tkr_helper_t * helper, const char* file_
 
   // Allocate and initialize new file node
   cur = newVFDFileInfo(file_name, file_no);
+  cur->live_slot = dayu_live_file_open(cur->file_name);
 
   // Add to linked list
   cur->next = helper->vfd_opened_files;
@@ -1286,15 +1526,18 @@ void teardownVFDTkrHelper(vfd_tkr_helper_t* helper){
 
 
   timerRmStat.Resume();
-  // Close json file list
-  FILE * f = fopen(helper->tkr_file_path, "r+");
-
-  fseek(f, -3, SEEK_END);
-  // Add the closing JSON array bracket
-  fwrite("}]", 2, 1, f);
+  if (helper->col_writer != nullptr) {
+    // Write the footer index, the file is unreadable without it
+    dayu_mem_log_col(helper->col_writer);
+    dayu_col_close(helper->col_writer);
+    helper->col_writer = nullptr;
+    timerTermVFD.Pause();
+    return;
+  }
 
-  // Close the file
-  fclose(f);
+  // Flush pending records and close json file list
+  dayu_mem_log(&helper->log_sink);
+  dayu_sink_close(&helper->log_sink);
   timerTermVFD.Pause();
 
   // // free down causes double free error in single process mode
@@ -1313,8 +1556,13 @@ void teardownVFDTkrHelper(vfd_tkr_helper_t* helper){
 }
 
 
-void DumpJsonFileStat(vfd_tkr_helper_t* helper, const vfd_file_tkr_info_t* info) {
+void DumpJsonFileStat(vfd_tkr_helper_t* helper, const vfd_file_tkr_info_t* info, bool delta) {
   timerLogStat.Resume();
+  if (helper->col_writer != nullptr) {
+    DumpColFileStat(helper, info, delta);
+    timerLogStat.Pause();
+    return;
+  }
 #ifdef DEBUG_TRK_VFD
   std::cout << "File close and write to : " << helper->tkr_file_path << std::endl;
 #endif
@@ -1328,18 +1576,21 @@ void DumpJsonFileStat(vfd_tkr_helper_t* helper, const vfd_file_tkr_info_t* info)
   else
       file_name = (const char*)info->file_name;
   
-  FILE * f = fopen(helper->tkr_file_path, "a");
-
   if (!info) {
-      fprintf(f, "DumpJsonFileStat(): vfd_file_tkr_info_t is nullptr.\n");
+      fprintf(stderr, "DumpJsonFileStat(): vfd_file_tkr_info_t is nullptr.\n");
+      timerLogStat.Pause();
       return;
   }
 
+  char* rec = nullptr;
+  size_t rec_len = 0;
+  FILE * f = open_memstream(&rec, &rec_len);
+
 #ifdef ACCESS_STAT
   
   // fprintf(f, "[\n");
   /* file info */
-  fprintf(f, "\n{\n");
+  fprintf(f, "{\n");
   fprintf(f, "\t\"file-%lu\": ", info->sorder_id);
   fprintf(f, "{");
   fprintf(f, "\"file_name\": \"/%s\", ", file_name);
@@ -1392,13 +1643,23 @@ void DumpJsonFileStat(vfd_tkr_helper_t* helper, const vfd_file_tkr_info_t* info)
 
   fprintf(f, "\"io_bytes\": %ld, ", info->io_bytes);
   fprintf(f, "\"file_size\": %zu, \n", info->file_size);
+  // Once a file was flushed, each record holds the stats since the previous one
+  if (delta || info->delta_seq > 0) {
+    fprintf(f, "\t\t\"delta_seq\": %lu, \"final\": %s,\n",
+      delta ? info->delta_seq : info->delta_seq + 1, delta ? "false" : "true");
+  }
   
-
+  fprintf(f, "\t\t\"raw_attribution\": {\"by_address\": %zu, \"by_context\": %zu, \"context_mismatch\": %zu},\n",
+    info->amap_raw_hits, info->amap_raw_misses, info->amap_ctx_differs);
+  if (delta)
+    fprintf(f, "\t\t\"page_buffer\": null,\n"); // cumulative, in the final record
+  else
+    DumpJsonPageBufStat(f, info);
   DumpJsonDsetStat(f, info);
   fprintf(f, "\t},\n");
 
 #else
-  fprintf(f, "\n{\n");
+  fprintf(f, "{\n");
 #endif
 
   /* task info */
@@ -1448,15 +1709,253 @@ void DumpJsonFileStat(vfd_tkr_helper_t* helper, const vfd_file_tkr_info_t* info)
   fprintf(f, "}\n");
   // TOTAL_POSIX_IO_TIME = 0;
 
-  fprintf(f, "},\n");
-
+  fprintf(f, "}");
 
-  fflush(f);
-  fclose(f);
+  dayu_sink_record_end(&helper->log_sink, f, &rec, &rec_len);
   timerLogStat.Pause();
 
 }
 
+// Delta record of every open file with I/O since the last flush, then the
+// page ranges and counters it holds are released. The page buffer
+// simulations are bounded and stay cumulative until close.
+void FlushVFDFileStats(vfd_tkr_helper_t* helper) {
+  for (vfd_file_tkr_info_t* info = helper->vfd_opened_files; info != nullptr; info = info->next) {
+    if (info->file_read_cnt == 0 && info->file_write_cnt == 0)
+      continue;
+    info->delta_seq++;
+    DumpJsonFileStat(helper, info, true);
+
+    for (auto const& [dset_name, dset_info] : info->h5_dset_info_map)
+      freeDsetInfo(dset_info);
+    info->h5_dset_info_map.clear();
+    info->file_read_cnt = 0;
+    info->file_write_cnt = 0;
+    info->io_bytes = 0;
+    info->amap_raw_hits = 0;
+    info->amap_raw_misses = 0;
+    info->amap_ctx_differs = 0;
+  }
+  helper->flush_held = 0;
+  dayu_flush_done(&helper->flush);
+}
+
+
+/* Columnar stat output start */
+// Same content as the JSON records, split into tables:
+//   vfd_file   one row per closed file or delta, the "Task" fields as "Task.*" columns
+//   vfd_dset   one row per dataset of a file, rows of a file are contiguous
+//   vfd_mem    one row per memory type of a dataset, raw = 1 for H5FD_MEM_DRAW
+//   vfd_range  page ranges, the read then write ranges of a vfd_mem row
+// Child rows are referenced by the index of the first one and a count.
+// The file is written directly, without the sink's compression or collector
+// streaming, and its footer only at teardown: a process that dies before
+// leaves a file readers reject.
+void ColStatInit(vfd_tkr_helper_t* helper, const char* file_path) {
+  std::string path = std::string(file_path) + "/" + std::to_string(helper->pid) + "-" + VFD_COLSTAT_FILE_NAME;
+
+  helper->col_writer = dayu_col_create(path.c_str());
+  if (helper->col_writer == nullptr) {
+    fprintf(stderr, "H5FD_tracker_vfd_log.h: ColStatInit() failed, writing JSON to %s\n", helper->tkr_file_path);
+    return;
+  }
+
+  static const char* file_cols[] = {"sorder_id", "file_name", "task_name", "node_id",
+    "open_time(us)", "close_time(us)", "file_intent", "file_no", "file_read_cnt", "file_write_cnt",
+    "access_type", "file_type", "io_bytes", "file_size",
+    "raw_attribution.by_address", "raw_attribution.by_context", "raw_attribution.context_mismatch",
+    "page_buffer", "dset_first", "dset_cnt",
+    "Task.task_id", "Task.tracker_vfd_page_size",
+    "Task.POSIX-READ-Time(us)", "Task.POSIX-WRITE-Time(us)", "Task.POSIX-OPEN-Time(us)",
+    "Task.POSIX-CLOSE-Time(us)", "Task.POSIX-DELETE-Time(us)",
+    "Task.MMAP-READ-Time(us)", "Task.MMAP-WRITE-Time(us)", "Task.MMAP-OPEN-Time(us)", "Task.MMAP-CLOSE-Time(us)",
+    "Task.VFD-Overhead(us)", "Task.VFD-Init(us)", "Task.VFD-Term(us)", "Task.VFD-Tracker-Init(us)",
+    "Task.VFD-Stat-Add(us)", "Task.VFD-Stat-Update(us)", "Task.VFD-Stat-Rm(us)", "Task.VFD-Stat-Log(us)",
+    "delta_seq", "delta_final"};
+  static const dayu_col_type_t file_types[] = {DAYU_COL_U64, DAYU_COL_STR, DAYU_COL_STR, DAYU_COL_STR,
+    DAYU_COL_F64, DAYU_COL_F64, DAYU_COL_STR, DAYU_COL_U64, DAYU_COL_I64, DAYU_COL_I64,
+    DAYU_COL_STR, DAYU_COL_STR, DAYU_COL_I64, DAYU_COL_U64,
+    DAYU_COL_U64, DAYU_COL_U64, DAYU_COL_U64,
+    DAYU_COL_STR, DAYU_COL_U64, DAYU_COL_U64,
+    DAYU_COL_I64, DAYU_COL_I64,
+    DAYU_COL_F64, DAYU_COL_F64, DAYU_COL_F64, DAYU_COL_F64, DAYU_COL_F64,
+    DAYU_COL_F64, DAYU_COL_F64, DAYU_COL_F64, DAYU_COL_F64,
+    DAYU_COL_F64, DAYU_COL_F64, DAYU_COL_F64, DAYU_COL_F64,
+    DAYU_COL_F64, DAYU_COL_F64, DAYU_COL_F64, DAYU_COL_F64,
+    DAYU_COL_U64, DAYU_COL_U64};
+  static const char* dset_cols[] = {"file_row", "dset_name", "mem_first", "mem_cnt"};
+  static const dayu_col_type_t dset_types[] = {DAYU_COL_U64, DAYU_COL_STR, DAYU_COL_U64, DAYU_COL_U64};
+  static const char* mem_cols[] = {"dset_row", "mem_type", "raw", "read_bytes", "read_cnt",
+    "write_bytes", "write_cnt", "range_first", "read_range_cnt", "write_range_cnt"};
+  static const dayu_col_type_t mem_types[] = {DAYU_COL_U64, DAYU_COL_STR, DAYU_COL_U64, DAYU_COL_U64, DAYU_COL_I64,
+    DAYU_COL_U64, DAYU_COL_I64, DAYU_COL_U64, DAYU_COL_U64, DAYU_COL_U64};
+  static const char* range_cols[] = {"io_idx", "start_page", "end_page"};
+  static const dayu_col_type_t range_types[] = {DAYU_COL_I64, DAYU_COL_U64, DAYU_COL_U64};
+
+  static_assert(sizeof(file_cols) / sizeof(file_cols[0]) == sizeof(file_types) / sizeof(file_types[0]),
+    "vfd_file columns and types differ");
+  helper->col_file = dayu_col_table(helper->col_writer, "vfd_file",
+    sizeof(file_cols) / sizeof(file_cols[0]), file_cols, file_types);
+  helper->col_dset = dayu_col_table(helper->col_writer, "vfd_dset", 4, dset_cols, dset_types);
+  helper->col_mem = dayu_col_table(helper->col_writer, "vfd_mem", 10, mem_cols, mem_types);
+  helper->col_range = dayu_col_table(helper->col_writer, "vfd_range", 3, range_cols, range_types);
+
+  if (helper->col_file == nullptr || helper->col_dset == nullptr || helper->col_mem == nullptr
+      || helper->col_range == nullptr) {
+    dayu_col_close(helper->col_writer);
+    unlink(path.c_str());
+    helper->col_writer = nullptr;
+    helper->col_file = helper->col_dset = helper->col_mem = helper->col_range = nullptr;
+    fprintf(stderr, "H5FD_tracker_vfd_log.h: ColStatInit() failed, writing JSON to %s\n", helper->tkr_file_path);
+  }
+}
+
+static uint64_t ColStatRanges(vfd_tkr_helper_t* helper, const page_range_t* range) {
+  uint64_t cnt = 0;
+  dayu_col_val_t row[3];
+
+  for (; range != nullptr; range = range->next, cnt++) {
+    row[0].i = range->io_idx;
+    row[1].u = range->start_page;
+    row[2].u = range->end_page;
+    dayu_col_append(helper->col_range, row);
+  }
+  return cnt;
+}
+
+static void ColStatMem(vfd_tkr_helper_t* helper, uint64_t dset_row, const h5_mem_stat_t* mem_stat, int raw) {
+  dayu_col_val_t row[10];
+
+  row[0].u = dset_row;
+  row[1].s = mem_stat->mem_type.c_str();
+  row[2].u = raw;
+  row[3].u = mem_stat->read_bytes;
+  row[4].i = mem_stat->read_cnt;
+  row[5].u = mem_stat->write_bytes;
+  row[6].i = mem_stat->write_cnt;
+  row[7].u = dayu_col_rows(helper->col_range);
+  row[8].u = ColStatRanges(helper, mem_stat->read_ranges);
+  row[9].u = ColStatRanges(helper, mem_stat->write_ranges);
+  dayu_col_append(helper->col_mem, row);
+}
+
+void DumpColFileStat(vfd_tkr_helper_t* helper, const vfd_file_tkr_info_t* info, bool delta) {
+  if (!info)
+    return;
+
+#ifdef ACCESS_STAT
+  uint64_t file_row = dayu_col_rows(helper->col_file);
+  uint64_t dset_first = dayu_col_rows(helper->col_dset);
+
+  for (auto const& [dset_name, dset_info] : info->h5_dset_info_map) {
+    dayu_col_val_t drow[4];
+    uint64_t dset_row = dayu_col_rows(helper->col_dset);
+    uint64_t mem_first = dayu_col_rows(helper->col_mem);
+
+    if (dset_info->h5_draw != nullptr)
+      ColStatMem(helper, dset_row, dset_info->h5_draw, 1);
+    const h5_mem_stat_t* meta_stats[] = {dset_info->h5_ohdr, dset_info->h5_super,
+        dset_info->h5_btree, dset_info->h5_lheap, dset_info->h5_gheap,
+        dset_info->h5_default, dset_info->h5_other};
+    for (const h5_mem_stat_t* mem_stat : meta_stats) {
+      if (mem_stat != nullptr)
+        ColStatMem(helper, dset_row, mem_stat, 0);
+    }
+
+    drow[0].u = file_row;
+    drow[1].s = dset_name.c_str();
+    drow[2].u = mem_first;
+    drow[3].u = dayu_col_rows(helper->col_mem) - mem_first;
+    dayu_col_append(helper->col_dset, drow);
+  }
+
+  // same file name, task name and node id as the JSON record
+  const char * file_name = (char*)info->file_name;
+  if (file_name)
+    file_name++;
+  std::string file_name_str = std::string("/") + (file_name ? file_name : "");
+  const char* task_name = info->task_name ? info->task_name : std::getenv("CURR_TASK");
+#ifdef HERMES
+  TRANSPARENT_HERMES();
+  std::string node_id = std::to_string(HRUN_CLIENT->node_id_);
+#else
+  char hostname[128];
+  std::string node_id = gethostname(hostname, sizeof(hostname)) == 0 ? hostname : "unknown";
+#endif
+
+  const char* access_type = "not_accessed";
+  const char* file_type = "na";
+  if (info->file_read_cnt > 0 && info->file_write_cnt == 0) {
+    access_type = "read_only";
+    file_type = "input";
+  } else if (info->file_write_cnt > 0 && info->file_read_cnt == 0) {
+    access_type = "write_only";
+    file_type = "output";
+  } else if (info->file_write_cnt > 0 && info->file_read_cnt > 0) {
+    access_type = "read_write";
+    file_type = "input-output";
+  }
+
+  char* page_buffer = nullptr;
+  size_t page_buffer_len = 0;
+  FILE* pb = open_memstream(&page_buffer, &page_buffer_len);
+  if (delta)
+    fprintf(pb, "null");
+  else
+    DumpJsonPageBufValue(pb, info);
+  fclose(pb);
+
+  dayu_col_val_t row[41];
+  int c = 0;
+  row[c++].u = info->sorder_id;
+  row[c++].s = file_name_str.c_str();
+  row[c++].s = task_name ? task_name : "(null)";
+  row[c++].s = node_id.c_str();
+  row[c++].f = info->open_time;
+  row[c++].f = timer.GetUsFromEpoch();
+  row[c++].s = info->intent ? info->intent : "";
+  row[c++].u = info->file_no;
+  row[c++].i = info->file_read_cnt;
+  row[c++].i = info->file_write_cnt;
+  row[c++].s = access_type;
+  row[c++].s = file_type;
+  row[c++].i = (int64_t)info->io_bytes;
+  row[c++].u = info->file_size;
+  row[c++].u = info->amap_raw_hits;
+  row[c++].u = info->amap_raw_misses;
+  row[c++].u = info->amap_ctx_differs;
+  row[c++].s = page_buffer;
+  row[c++].u = dset_first;
+  row[c++].u = dayu_col_rows(helper->col_dset) - dset_first;
+  row[c++].i = getpid();
+  row[c++].i = (int64_t)info->adaptor_page_size;
+  row[c++].f = timer_read.GetUsec();
+  row[c++].f = timer_write.GetUsec();
+  row[c++].f = timer_open.GetUsec();
+  row[c++].f = timer_close.GetUsec();
+  row[c++].f = timer_del.GetUsec();
+  row[c++].f = timer_mmap_read.GetUsec();
+  row[c++].f = timer_mmap_write.GetUsec();
+  row[c++].f = timer_mmap_open.GetUsec();
+  row[c++].f = timer_mmap_close.GetUsec();
+  row[c++].f = timer_vfd.GetUsec();
+  row[c++].f = timerInitVFD.GetUsec();
+  row[c++].f = timerTermVFD.GetUsec();
+  row[c++].f = timerInitTracker.GetUsec();
+  row[c++].f = timerAddStat.GetUsec();
+  row[c++].f = timerUpdateStat.GetUsec();
+  row[c++].f = timerRmStat.GetUsec();
+  row[c++].f = timerLogStat.GetUsec();
+  // 0 without incremental flushing, see DumpJsonFileStat()
+  row[c++].u = delta ? info->delta_seq : (info->delta_seq > 0 ? info->delta_seq + 1 : 0);
+  row[c++].u = !delta;
+  assert(c == 41);
+  dayu_col_append(helper->col_file, row);
+  free(page_buffer);
+#endif
+}
+/* Columnar stat output end */
+
 
 #ifdef MIO
 int handle_error(const std::error_code& error, const std::string& func_name)
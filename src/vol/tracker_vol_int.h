@@ -6,6 +6,7 @@
 #include <sys/stat.h>
 #include <sys/file.h> // Include for file locks
 #include <errno.h>
+#include <time.h>
 
 #include "hdf5.h"
 #include "tracker_vol.h"
@@ -25,8 +26,6 @@
 #define va_copy(D,S)      ((D) = (S))
 #endif
 
-#define STAT_FUNC_MOD 733//a reasonably big size to avoid expensive collision handling, make sure it works with 62 function names.
-
 #define MAX_PATH_LENGTH 1024
 
 // #define UINT32DECODE(p, val) {                      \
@@ -66,6 +65,8 @@ unsigned long DSET_LL_TOTAL_TIME;         //dataset
 unsigned long DSET_INFO_ADD_TIME;
 unsigned long DSET_INFO_RM_TIME;
 unsigned long DSET_INFO_UPDATE_TIME;
+unsigned long DSET_PROP_CACHE_HIT;        //dataset property cache reuse on reopen
+unsigned long DSET_PROP_CACHE_MISS;
 
 unsigned long GRP_LL_TOTAL_TIME;        //group
 unsigned long GRP_INFO_ADD_TIME;
@@ -84,9 +85,28 @@ unsigned long ATTR_INFO_RM_TIME;
 
 
 unsigned long TRK_ACCESS_STAT_TIME;        //record all schema info update time
-//shorten function id: use hash value
-static char* FUNC_DIC[STAT_FUNC_MOD];
-char *CURR_DSET;
+// per-callback overhead profile, indexed by tkr_cb_t
+tkr_cb_stat_t TKR_CB_STAT[TKR_CB_NUM];
+#define TKR_CB_NAME_STR(name) "H5VL_tracker_" #name,
+static const char* TKR_CB_NAME[TKR_CB_NUM] = { TKR_CB_LIST(TKR_CB_NAME_STR) };
+#undef TKR_CB_NAME_STR
+
+// count-only profiling for pure passthrough callbacks
+#define TKR_CB_COUNT(cb) TKR_ADD(TKR_CB_STAT[cb].calls, 1)
+
+/* async request lifecycle, completions may come from connector threads */
+static pthread_mutex_t TKR_REQ_MUTEX = PTHREAD_MUTEX_INITIALIZER;
+tkr_req_stat_t TKR_REQ_ALL;                              // all requests, whether or not their dataset is still open
+unsigned long TKR_REQ_INFLIGHT;
+unsigned long TKR_REQ_INFLIGHT_MAX;
+unsigned long TKR_REQ_LEVEL_TIME[TKR_REQ_LEVELS];       // time spent with n requests in flight (us)
+unsigned long TKR_REQ_LEVEL_SINCE;                       // last in-flight count change, 0 before the first submit
+
+/* per-thread dataset context */
+#define DSET_CTX_DEPTH 16
+static __thread char DSET_CTX_STACK[DSET_CTX_DEPTH][DAYU_NAME_MAX]; // names to restore on pop
+static __thread int DSET_CTX_TOP = 0;
+static __thread dataset_tkr_info_t* DSET_CTX_DSET = NULL;           // owner of blob put/get during a read/write
 
 /* locks */
 void tkrLockInit(TKRLock* lock) {
@@ -111,10 +131,7 @@ TKRLock myLock;
 /* Common Routines */
 static
 unsigned long get_time_usec(void) {
-    struct timeval tp;
-
-    gettimeofday(&tp, NULL);
-    return (unsigned long)((1000000 * tp.tv_sec) + tp.tv_usec);
+    return dayu_time_usec();
 }
 
 
@@ -142,13 +159,16 @@ static hsize_t file_get_size(void *under_file, hid_t under_vol_id, hid_t dxpl_id
 char * dataset_get_layout(hid_t plist_id);
 static hsize_t dataset_get_storage_size(void *under_dset, hid_t under_vol_id, hid_t dxpl_id);
 static haddr_t dataset_get_offset(void *under_dset, hid_t under_vol_id, hid_t dxpl_id);
-static hsize_t dataset_get_num_chunks(void *under_dset, hid_t under_vol_id, hid_t dxpl_id);
-static hsize_t dataset_get_vlen_buf_size(void *under_dset, hid_t under_vol_id, hid_t dxpl_id); //TODO: fix
+static hsize_t dataset_get_num_chunks(void *under_dset, hid_t under_vol_id, hid_t dxpl_id, hid_t fspace_id);
+static herr_t dataset_get_vlen_buf_size(void *under_dset, hid_t under_vol_id, hid_t type_id,
+    hid_t space_id, hid_t dxpl_id, hsize_t *size);
 static herr_t dataset_get_chunk_info_by_coord(void *under_dset, hid_t under_vol_id, hid_t dxpl_id,
     const hsize_t *offset, unsigned *filter_mask /*out*/, haddr_t *addr /*out*/, hsize_t *size /*out*/); //TODO: fix
 static herr_t dataset_get_chunk_info_by_idx(void *under_dset, hid_t under_vol_id, hid_t dxpl_id,
     hid_t fspace_id, hsize_t chk_index,
     hsize_t *offset /*out*/, unsigned *filter_mask /*out*/, haddr_t *addr /*out*/, hsize_t *size /*out*/);
+static herr_t dataset_chunk_iter(void *under_dset, hid_t under_vol_id, hid_t dxpl_id,
+    H5D_chunk_iter_op_t op, void *op_data);
      /* candice added routine prototypes end */
 
 /* Local routine prototypes */
@@ -201,49 +221,48 @@ void _fake_obj_free(H5VL_tracker_t* obj);
 H5VL_tracker_t * _obj_wrap_under(void* under, H5VL_tracker_t* upper_o,
         const char *name, H5I_type_t type, hid_t dxpl_id, void** req);
 
-unsigned int genHash(const char *msg);
-void _dic_init(void);
-void _dic_free(void);
+void tkr_cb_record(tkr_cb_t cb, unsigned long start, unsigned long native_time);
+void tkr_cb_profile_log(dayu_sink_t* sink);
 
 
 /* Tracker internal print and logs prototypes */
-void _dic_print(void);
-void _preset_dic_print(void);
 void tkr_helper_teardown(tkr_helper_t* helper);
 int tkr_write(tkr_helper_t* helper_in, const char* msg, unsigned long duration);
 char * get_datatype_class_str(hid_t type_id);
+char * H5S_select_type_to_str(H5S_sel_type type);
 
     
     /* candice added routine prototypes start */
 void log_file_stat_json(tkr_helper_t* helper_in, const file_tkr_info_t* file_info);
-void log_dset_ht_json(FILE *f);
+void log_dset_ht_json(dayu_sink_t* sink, unsigned long delta_seq);
+void log_dset_ht_flush(tkr_helper_t* helper);
+
 // void print_order_id();
 // void tracker_insert_file(file_list_t** head_ref, file_tkr_info_t * file_info);
 // void print_all_tracker(file_list_t * head);
 // void tracker_file_dump(file_list_t * file_ndoe);
 // void tracker_dset_dump(dset_list_t * dset_node);
 // file_list_t * tracker_newfile(file_tkr_info_t * file_info);
-void H5VL_arrow_get_selected_sub_region(hid_t space_id, size_t org_type_size);
 void file_info_print(char * func_name, void * obj, hid_t fapl_id, hid_t fcpl_id, hid_t dxpl_id);
 void dataset_info_print(char * func_name, hid_t mem_type_id, hid_t mem_space_id,
     hid_t file_space_id, void * obj, hid_t dxpl_id);
+void dataset_info_capture(char * func_name, void * obj, hid_t dxpl_id);
 void blob_info_print(char * func_name, void * obj, hid_t dxpl_id, 
     size_t size, void * blob_id, const void * buf, void *ctx);
 
 
-int is_page_in_list(size_t *list, size_t list_size, size_t page);
-void print_list(const size_t *list, size_t list_size);
-void add_meta_page_to_list(size_t **list, size_t *list_size, size_t page);
 
 
 void init_hasn_lock();
 void print_ht_token_numbers();
 void free_dset_track_info(dset_track_t *dset_track_info);
 
-int myll_print(myll_t *head);
-void myll_to_file(FILE * file, myll_t *head);
-void myll_free(myll_t **head);
-void myll_add(myll_t **head, myll_t **tail, unsigned long new_data);
+int idset_contains(const idset_t *set, unsigned long id);
+void idset_add(idset_t *set, unsigned long id);
+size_t idset_count(const idset_t *set);
+int idset_print(const idset_t *set);
+void idset_to_file(FILE * file, const idset_t *set);
+void idset_free(idset_t *set);
 
 char* encode_two_strings(const char* file_path, const char* dset_name);
 dset_track_t *create_dset_track_info(dataset_tkr_info_t* dset_info);
@@ -252,6 +271,56 @@ void update_dset_track_info(char * key, dataset_tkr_info_t* dset_info);
 void add_dset_track_info(char * key, dset_track_t *dset_track_info, dataset_tkr_info_t* dset_info);
 void add_to_dset_ht(dataset_tkr_info_t* dset_info);
 
+DsetPropCacheEntry * dset_prop_cache_find(file_tkr_info_t* file_info, H5O_token_t* token);
+int dset_prop_cache_load(DsetPropCacheEntry* entry, dataset_tkr_info_t* dset_info);
+void dset_prop_cache_store(file_tkr_info_t* file_info, dataset_tkr_info_t* dset_info);
+void dset_prop_cache_invalidate(dataset_tkr_info_t* dset_info, bool extent, bool storage);
+void dset_prop_cache_free(file_tkr_info_t* file_info);
+
+int dset_sel_record(dataset_tkr_info_t* dset_info, char op, hid_t file_space_id, hid_t mem_type_id);
+void dset_sel_append(dset_track_t* track_info, dataset_tkr_info_t* dset_info);
+void dset_sel_free(sel_summary_t** head);
+void dset_sel_to_file(FILE * f, sel_summary_t* head);
+
+void dset_chunk_init(H5VL_tracker_t* dset, dataset_tkr_info_t* dset_info, hid_t dxpl_id);
+void dset_chunk_record(H5VL_tracker_t* dset, dataset_tkr_info_t* dset_info, char op,
+    hid_t file_space_id, hid_t dxpl_id, int sel_repeat);
+void dset_chunk_append(dset_track_t* track_info, dataset_tkr_info_t* dset_info);
+void dset_chunk_resolve(H5VL_tracker_t* dset, dataset_tkr_info_t* dset_info, hid_t dxpl_id);
+void dset_chunk_free(chunk_heat_t** map, int ndim);
+void dset_chunk_to_file(FILE * f, dset_track_t* track_info);
+
+void dset_ccache_init(dataset_tkr_info_t* dset_info);
+void dset_ccache_free(dataset_tkr_info_t* dset_info);
+void dset_ccache_access(dataset_tkr_info_t* dset_info, const hsize_t* coords);
+void dset_ccache_append(dset_track_t* track_info, dataset_tkr_info_t* dset_info);
+void dset_ccache_to_file(FILE * f, dset_track_t* track_info);
+
+size_t dset_tconv_record(H5VL_tracker_t* dset, dataset_tkr_info_t* dset_info, char op,
+    hid_t mem_type_id, hid_t dxpl_id, unsigned long io_time);
+void dset_tconv_append(dset_track_t* track_info, dataset_tkr_info_t* dset_info);
+void dset_tconv_to_file(FILE * f, dset_track_t* track_info);
+void dset_io_time_split(size_t count, void *dset[], hid_t mem_type_id[], hid_t mem_space_id[],
+    hid_t file_space_id[], unsigned long total, unsigned long io_time[]);
+
+void dset_blob_record(file_tkr_info_t* file_info, char op, size_t size, unsigned long blob_time);
+void dset_vlen_read_end(H5VL_tracker_t* dset, dataset_tkr_info_t* dset_info,
+    hid_t mem_type_id, hid_t mem_space_id, hid_t file_space_id, hid_t dxpl_id, const void* buf);
+void dset_blob_append(dset_track_t* track_info, dataset_tkr_info_t* dset_info);
+void dset_blob_to_file(FILE * f, dset_track_t* track_info);
+
+void tkr_req_submit(H5VL_tracker_t* req, dataset_tkr_info_t* dset_info, char op, unsigned long submit_time);
+void tkr_req_wait(H5VL_tracker_t* req, unsigned long wait_time, H5VL_request_status_t status);
+herr_t tkr_req_notify_cb(void* ctx, H5VL_request_status_t status);
+void tkr_req_release(H5VL_tracker_t* req);
+void tkr_req_detach(dataset_tkr_info_t* dset_info);
+void dset_req_append(dset_track_t* track_info, dataset_tkr_info_t* dset_info);
+void dset_req_to_file(FILE * f, tkr_req_stat_t* stat);
+void tkr_req_log(dayu_sink_t* sink);
+
+void dset_amap_publish(dataset_tkr_info_t* dset_info, haddr_t addr, hsize_t size);
+void dset_amap_record(H5VL_tracker_t* dset, dataset_tkr_info_t* dset_info, hid_t dxpl_id);
+
     /* candice added routine prototypes end */
 
 
@@ -264,7 +333,9 @@ void file_dtypes_created(file_tkr_info_t* info);
 void file_dtypes_accessed(file_tkr_info_t* info);
 
 
-void dset_shm_write(const char *obj_name);
+void dset_ctx_write(const char *obj_name);
+void dset_ctx_push(const char *dset_name);
+void dset_ctx_pop();
 
 
 
@@ -272,88 +343,10 @@ void dset_shm_write(const char *obj_name);
 
 /* Helper routines implementation */
 
+// Cached in libdayu_core and shared with the VFD, the task file is only
+// read again when it changes
 int getCurrentTask(char** curr_task) {
-    // Check if the environment variable CURR_TASK is set
-    const char* curr_task_env = getenv("CURR_TASK");
-
-    if (curr_task_env) {
-        // If CURR_TASK is set, return task name with curr_task_env + "-" + getpid()
-        // Allocate memory for the result string and store it in curr_task.
-        // Make sure to free this memory later when it's no longer needed.
-        int pid = getpid();
-        int len = snprintf(NULL, 0, "%s", curr_task_env);
-        *curr_task = (char*)malloc(len + 1);
-        snprintf(*curr_task, len + 1, "%s", curr_task_env);
-        return 1;
-    } else {
-        // If CURR_TASK is not set, try reading it from a file
-        if (getCurrentTaskFromFile(curr_task)) {
-            // Successfully read from the file.
-            // TODO: Handle any additional logic here if needed.
-            return 1;
-        } else {
-            // If both methods fail, return an empty string
-            // Allocate memory for an empty string and store it in curr_task.
-            *curr_task = (char*)malloc(1);
-            (*curr_task)[0] = '\0';
-            return 0;
-        }
-    }
-}
-
-int getCurrentTaskFromFile(char **curr_task) {
-    // Get environment variables
-    const char *path_for_task_files = getenv("PATH_FOR_TASK_FILES");
-    const char *workflow_name = getenv("WORKFLOW_NAME");
-
-    if (path_for_task_files && workflow_name) {
-        // Construct the full file path
-        char file_path[MAX_PATH_LENGTH];
-        snprintf(file_path, MAX_PATH_LENGTH, "%s/%s_vfd.curr_task", path_for_task_files, workflow_name);
-
-        // Open the file with exclusive lock
-        int fd = open(file_path, O_RDONLY);
-        if (fd != -1) {
-            struct flock lock;
-            lock.l_type = F_RDLCK;
-            lock.l_start = 0;
-            lock.l_whence = SEEK_SET;
-            lock.l_len = 0;
-
-            // Attempt to obtain a shared lock on the file
-            if (fcntl(fd, F_SETLK, &lock) != -1) {
-                // Read the file content into a string
-                FILE *file_stream = fopen(file_path, "r");
-                if (file_stream) {
-                    fseek(file_stream, 0, SEEK_END);
-                    long file_size = ftell(file_stream);
-                    fseek(file_stream, 0, SEEK_SET);
-
-                    *curr_task = (char *)malloc(file_size + 1);
-                    if (*curr_task) {
-                        fread(*curr_task, 1, file_size, file_stream);
-                        (*curr_task)[file_size] = '\0';
-                        fclose(file_stream);
-                        close(fd);  // Release the lock
-                        return 1;
-                    } else {
-                        perror("Failed to allocate memory");
-                    }
-                } else {
-                    fprintf(stderr, "Failed to read file: %s\n", file_path);
-                }
-            } else {
-                fprintf(stderr, "Failed to obtain lock on file: %s\n", file_path);
-            }
-            close(fd);
-        } else {
-            fprintf(stderr, "Failed to open file: %s - %s\n", file_path, strerror(errno));
-        }
-    } else {
-        fprintf(stderr, "Missing environment variables: PATH_FOR_TASK_FILES and/or WORKFLOW_NAME\n");
-    }
-
-    return 0;
+    return dayu_task_name(curr_task);
 }
 
 size_t get_tracker_page_size() {
@@ -378,49 +371,6 @@ size_t token_to_num(H5O_token_t token){
 
 
 
-// Function to check if a page is already in the list
-int is_page_in_list(size_t *list, size_t list_size, size_t page) {
-    for (size_t i = 0; i < list_size; i++) {
-        printf("Checking page %zu in the list\n", list[i]);
-        if (list[i] == page) {
-            return 1; // Page found in the list
-        }
-    }
-    return 0; // Page not found in the list
-}
-
-void print_list(const size_t *list, size_t list_size) {
-    printf("List contents: ");
-    for (size_t i = 0; i < list_size; i++) {
-        printf("%zu ", list[i]);
-    }
-    printf("\n");
-}
-
-void add_meta_page_to_list(size_t **list, size_t *list_size, size_t page) {
-    // printf("Adding page %zu to the list\n", page);
-
-    // Check if the page is already in the list
-    if (!is_page_in_list(*list, *list_size, page)) {
-        // Allocate memory for a larger list
-        size_t new_list_size = *list_size + 1;
-        size_t *new_list = realloc(*list, new_list_size * sizeof(size_t));
-        if (new_list == NULL) {
-            perror("Failed to allocate memory for the list");
-            return;
-        }
-        // Update the list and size
-        *list = new_list;
-        (*list)[*list_size] = page;
-        *list_size = new_list_size;
-    }
-
-
-}
-
-
-
-
 /*-------------------------------------------------------------------------
  * Function:    H5VL__tracker_new_obj
  *
@@ -455,7 +405,7 @@ H5VL_tracker_new_obj(void *under_obj, hid_t under_vol_id, tkr_helper_t* helper)
     ptr_cnt_increment(new_obj->tkr_helper);
     H5Iinc_ref(new_obj->under_vol_id);
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start);
+    TKR_ADD(TOTAL_TKR_OVERHEAD, (get_time_usec() - start));
 
 #ifdef DEBUG_PT_TKR_VOL
     printf("TRACKER VOL INT : H5VL_tracker_new_obj END\n");
@@ -494,7 +444,7 @@ H5VL_tracker_free_obj(H5VL_tracker_t *obj)
     H5Eset_current_stack(err_id);
 
     free(obj);
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start);
+    TKR_ADD(TOTAL_TKR_OVERHEAD, (get_time_usec() - start));
     return 0;
 } /* end H5VL__tracker_free_obj() */
 
@@ -732,30 +682,13 @@ static herr_t dataset_get_chunk_info_by_idx(void *under_dset, hid_t under_vol_id
 {
     H5VL_optional_args_t                vol_cb_args;    /* Arguments to VOL callback */
     H5VL_native_dataset_optional_args_t dset_opt_args;  /* Arguments for optional operation */
-    hsize_t                             nchunks   = 0;  /* Number of chunks */
     herr_t                              ret_value = SUCCEED;
 
-    /* Set up VOL callback arguments */
-    dset_opt_args.get_num_chunks.space_id = fspace_id;
-    dset_opt_args.get_num_chunks.nchunks  = &nchunks;
-    vol_cb_args.op_type                   = H5VL_NATIVE_DATASET_GET_NUM_CHUNKS;
-    vol_cb_args.args                      = &dset_opt_args;
-
-    /* Get the number of written chunks to check range */
-    if (H5VLdataset_optional(under_dset, under_vol_id, &vol_cb_args, dxpl_id, NULL) < 0){
-        printf("H5VLdataset_optional-failed: \"can't get number of chunks\", ");
-        return FAIL;
-    }
-
-    /* Check range for chunk index */
-    if (chk_index >= nchunks){
-        printf("H5VLdataset_optional-failed: \"chunk index is out of range\", ");
-        return FAIL;
-    }
+    /* Caller checks chk_index against dataset_get_num_chunks() once, not per chunk */
 
     /* Set up VOL callback arguments */
-    // dset_opt_args.get_chunk_info_by_idx.space_id    = fspace_id;
-    // dset_opt_args.get_chunk_info_by_idx.chk_index   = chk_index;
+    dset_opt_args.get_chunk_info_by_idx.space_id    = fspace_id;
+    dset_opt_args.get_chunk_info_by_idx.chk_index   = chk_index;
     dset_opt_args.get_chunk_info_by_idx.offset      = offset;
     dset_opt_args.get_chunk_info_by_idx.filter_mask = filter_mask;
     dset_opt_args.get_chunk_info_by_idx.addr        = addr;
@@ -770,13 +703,30 @@ static herr_t dataset_get_chunk_info_by_idx(void *under_dset, hid_t under_vol_id
     return ret_value;
 }
 
-static hsize_t dataset_get_num_chunks(void *under_dset, hid_t under_vol_id, hid_t dxpl_id)
+// H5Dchunk_iter() on the under dataset: op is called for every allocated chunk
+static herr_t dataset_chunk_iter(void *under_dset, hid_t under_vol_id, hid_t dxpl_id,
+    H5D_chunk_iter_op_t op, void *op_data)
+{
+    H5VL_optional_args_t                vol_cb_args;    /* Arguments to VOL callback */
+    H5VL_native_dataset_optional_args_t dset_opt_args;  /* Arguments for optional operation */
+
+    /* Set up VOL callback arguments */
+    dset_opt_args.chunk_iter.op      = op;
+    dset_opt_args.chunk_iter.op_data = op_data;
+    vol_cb_args.op_type              = H5VL_NATIVE_DATASET_CHUNK_ITER;
+    vol_cb_args.args                 = &dset_opt_args;
+
+    return H5VLdataset_optional(under_dset, under_vol_id, &vol_cb_args, dxpl_id, NULL);
+}
+
+static hsize_t dataset_get_num_chunks(void *under_dset, hid_t under_vol_id, hid_t dxpl_id, hid_t fspace_id)
 {
     H5VL_optional_args_t                vol_cb_args;               /* Arguments to VOL callback */
     H5VL_native_dataset_optional_args_t dset_opt_args;             /* Arguments for optional operation */
-    hsize_t                             dset_num_chunks; /* Dataset's offset */
+    hsize_t                             dset_num_chunks = 0; /* Number of allocated chunks */
 
     /* Set up VOL callback arguments */
+    dset_opt_args.get_num_chunks.space_id = fspace_id;
     dset_opt_args.get_num_chunks.nchunks = &dset_num_chunks;
     vol_cb_args.op_type             = H5VL_NATIVE_DATASET_GET_NUM_CHUNKS;
     vol_cb_args.args                = &dset_opt_args;
@@ -788,14 +738,19 @@ static hsize_t dataset_get_num_chunks(void *under_dset, hid_t under_vol_id, hid_
     return dset_num_chunks;
 }
 
-static hsize_t dataset_get_vlen_buf_size(void *under_dset, hid_t under_vol_id, hid_t dxpl_id)
+// Buffer size H5Dvlen_get_buf_size() would report for the selection. The
+// native connector reads the selected sequences to answer, so this costs a
+// read; the read path sizes vlen buffers from the memory buffer instead.
+static herr_t dataset_get_vlen_buf_size(void *under_dset, hid_t under_vol_id, hid_t type_id,
+    hid_t space_id, hid_t dxpl_id, hsize_t *size)
 {
     H5VL_optional_args_t                vol_cb_args;               /* Arguments to VOL callback */
     H5VL_native_dataset_optional_args_t dset_opt_args;             /* Arguments for optional operation */
-    hsize_t                             size; /* Dataset's offset */
 
     /* Set up VOL callback arguments */
-    dset_opt_args.get_vlen_buf_size.size = &size;
+    dset_opt_args.get_vlen_buf_size.type_id = type_id;
+    dset_opt_args.get_vlen_buf_size.space_id = space_id;
+    dset_opt_args.get_vlen_buf_size.size = size;
     vol_cb_args.op_type             = H5VL_NATIVE_DATASET_GET_VLEN_BUF_SIZE;
     vol_cb_args.args                = &dset_opt_args;
 
@@ -803,7 +758,7 @@ static hsize_t dataset_get_vlen_buf_size(void *under_dset, hid_t under_vol_id, h
     if (H5VLdataset_optional(under_dset, under_vol_id, &vol_cb_args, dxpl_id, NULL) < 0)
         return -1;
     
-    return size;
+    return 0;
 }
 
 
@@ -851,7 +806,6 @@ tkr_helper_t * tkr_helper_init( char* file_path, Track_level tkr_level, char* tk
 
     // if(new_helper->tkr_level == File_only || new_helper->tkr_level == File_and_print)
     //     new_helper->tkr_file_handle = fopen(new_helper->tkr_file_path, "a");
-    // _dic_init();
 
     // new_helper->pid = 123; // TODO: set tmp PID the same for testing
     // Update the file_name with PID in front
@@ -865,16 +819,17 @@ tkr_helper_t * tkr_helper_init( char* file_path, Track_level tkr_level, char* tk
     /* VFD vars end */
     printf("vol new_helper tkr_file_path: %s\n", new_helper->tkr_file_path);
 
-    // New json file list
-    FILE * f = fopen(new_helper->tkr_file_path, "a");
-    fprintf(f, "[");
-    fclose(f);
+    // New json file list, kept open until teardown
+    dayu_sink_open(&new_helper->log_sink, new_helper->tkr_file_path);
+    dayu_flush_init(&new_helper->flush);
 
-    TKR_INIT_TIME += (get_time_usec() - start);
+    TKR_ADD(TKR_INIT_TIME, (get_time_usec() - start));
     return new_helper;
 }
 
 
+
+
 datatype_tkr_info_t *new_dtype_info(file_tkr_info_t* root_file,
     const char *name, H5O_token_t token)
 {
@@ -1018,6 +973,7 @@ file_tkr_info_t* new_file_info(const char* fname, unsigned long file_no)
     // strcpy(info->file_name, fname);
     info->tkr_helper = TKR_HELPER;
     info->file_no = file_no;
+    info->live_slot = -1;
     info->sorder_id=0;
     info->ds_created =0;
     info->ds_accessed =0;
@@ -1055,6 +1011,7 @@ void file_info_free(file_tkr_info_t* info)
     //     free((void*)info->file_name);
     // if(info->task_name)
     //     free((void*)info->task_name);
+    dset_prop_cache_free(info);
     free(info);
 }
 
@@ -1072,6 +1029,14 @@ void dataset_info_free(dataset_tkr_info_t* info)
 
     // if(info->pfile_name)
     //     free(info->pfile_name);
+    tkr_req_detach(info);
+    dset_sel_free(&info->sel_head); // runs not moved to a tracking entry
+    dset_chunk_free(&info->chunk_map, info->chunk_ndim);
+    dset_ccache_free(info);
+    if(info->file_type_id > 0)
+        H5Tclose(info->file_type_id);
+    free(info->chunk_dims);
+    free(info->chunk_last);
     free(info);
 }
 
@@ -1118,8 +1083,8 @@ datatype_tkr_info_t * add_dtype_node(file_tkr_info_t *file_info,
     // Increment refcount on datatype
     cur->obj_info.ref_cnt++;
 
-    DT_INFO_ADD_TIME += (get_time_usec() - start);
-    DT_LL_TOTAL_TIME += (get_time_usec() - start);
+    TKR_ADD(DT_INFO_ADD_TIME, (get_time_usec() - start));
+    TKR_ADD(DT_LL_TOTAL_TIME, (get_time_usec() - start));
     return cur;
 }
 
@@ -1167,8 +1132,8 @@ int rm_dtype_node(tkr_helper_t *helper, void *under, hid_t under_vol_id, datatyp
                 assert(file_info->opened_dtypes == NULL);
 
             // Decrement refcount on file info
-            DT_INFO_RM_TIME += (get_time_usec() - start);
-            DT_LL_TOTAL_TIME += (get_time_usec() - start);
+            TKR_ADD(DT_INFO_RM_TIME, (get_time_usec() - start));
+            TKR_ADD(DT_LL_TOTAL_TIME, (get_time_usec() - start));
             rm_file_node(helper, file_info->file_no);
 
             return 0;
@@ -1178,8 +1143,8 @@ int rm_dtype_node(tkr_helper_t *helper, void *under, hid_t under_vol_id, datatyp
         cur = cur->next;
     }
 
-    DT_INFO_RM_TIME += (get_time_usec() - start);
-    DT_LL_TOTAL_TIME += (get_time_usec() - start);
+    TKR_ADD(DT_INFO_RM_TIME, (get_time_usec() - start));
+    TKR_ADD(DT_LL_TOTAL_TIME, (get_time_usec() - start));
     //node not found.
     return -1;
 }
@@ -1225,8 +1190,8 @@ group_tkr_info_t *add_grp_node(file_tkr_info_t *file_info,
     // Increment refcount on group
     cur->obj_info.ref_cnt++;
 
-    GRP_INFO_ADD_TIME += (get_time_usec() - start);
-    GRP_LL_TOTAL_TIME += (get_time_usec() - start);
+    TKR_ADD(GRP_INFO_ADD_TIME, (get_time_usec() - start));
+    TKR_ADD(GRP_LL_TOTAL_TIME, (get_time_usec() - start));
     return cur;
 }
 
@@ -1270,7 +1235,7 @@ int rm_grp_node(tkr_helper_t *helper, void *under_obj, hid_t under_vol_id, group
                 assert(file_info->opened_grps == NULL);
 
             // Decrement refcount on file info
-            GRP_LL_TOTAL_TIME += (get_time_usec() - start);
+            TKR_ADD(GRP_LL_TOTAL_TIME, (get_time_usec() - start));
             rm_file_node(helper, file_info->file_no);
 
             return 0;
@@ -1280,8 +1245,8 @@ int rm_grp_node(tkr_helper_t *helper, void *under_obj, hid_t under_vol_id, group
         cur = cur->next;
     }
 
-    GRP_INFO_RM_TIME += (get_time_usec() - start);
-    GRP_LL_TOTAL_TIME += (get_time_usec() - start);
+    TKR_ADD(GRP_INFO_RM_TIME, (get_time_usec() - start));
+    TKR_ADD(GRP_LL_TOTAL_TIME, (get_time_usec() - start));
     //node not found.
     return -1;
 }
@@ -1321,8 +1286,8 @@ attribute_tkr_info_t *add_attr_node(file_tkr_info_t *file_info,
     // Increment refcount on attribute
     cur->obj_info.ref_cnt++;
 
-    ATTR_INFO_ADD_TIME += (get_time_usec() - start);
-    ATTR_LL_TOTAL_TIME += (get_time_usec() - start);
+    TKR_ADD(ATTR_INFO_ADD_TIME, (get_time_usec() - start));
+    TKR_ADD(ATTR_LL_TOTAL_TIME, (get_time_usec() - start));
     return cur;
 }
 
@@ -1365,8 +1330,8 @@ int rm_attr_node(tkr_helper_t *helper, void *under_obj, hid_t under_vol_id, attr
             if(file_info->opened_attrs_cnt == 0)
                 assert(file_info->opened_attrs == NULL);
 
-            ATTR_INFO_RM_TIME += (get_time_usec() - start);
-            ATTR_LL_TOTAL_TIME += (get_time_usec() - start);
+            TKR_ADD(ATTR_INFO_RM_TIME, (get_time_usec() - start));
+            TKR_ADD(ATTR_LL_TOTAL_TIME, (get_time_usec() - start));
 
             // Decrement refcount on file info
             rm_file_node(helper, file_info->file_no);
@@ -1378,8 +1343,8 @@ int rm_attr_node(tkr_helper_t *helper, void *under_obj, hid_t under_vol_id, attr
         cur = cur->next;
     }
 
-    ATTR_INFO_RM_TIME += (get_time_usec() - start);
-    ATTR_LL_TOTAL_TIME += (get_time_usec() - start);
+    TKR_ADD(ATTR_INFO_RM_TIME, (get_time_usec() - start));
+    TKR_ADD(ATTR_LL_TOTAL_TIME, (get_time_usec() - start));
     //node not found.
     return -1;
 }
@@ -1420,6 +1385,7 @@ file_tkr_info_t* add_file_node(tkr_helper_t* helper, const char* file_name,
     if(!cur) {
         // Allocate and initialize new file node
         cur = new_file_info(file_name, file_no);
+        cur->live_slot = dayu_live_file_open(cur->file_name);
 
         // Add to linked list
         cur->next = helper->opened_files;
@@ -1435,14 +1401,11 @@ file_tkr_info_t* add_file_node(tkr_helper_t* helper, const char* file_name,
     cur->ref_cnt++;
     cur->open_time = get_time_usec();
 
-    tkrLockAcquire(&myLock);
     // TODO(candice): only increment if file is not already open
-    FILE_SORDER+=1;
-    cur->sorder_id =FILE_SORDER; // sync order with VFD, no add
-    tkrLockRelease(&myLock);
+    cur->sorder_id = TKR_NEXT_ID(FILE_SORDER); // sync order with VFD, no add
 
-    FILE_INFO_ADD_TIME+= (get_time_usec() - start);
-    FILE_LL_TOTAL_TIME += (get_time_usec() - start);
+    TKR_ADD(FILE_INFO_ADD_TIME, (get_time_usec() - start));
+    TKR_ADD(FILE_LL_TOTAL_TIME, (get_time_usec() - start));
 
     return cur;
 }
@@ -1477,6 +1440,8 @@ int rm_file_node(tkr_helper_t* helper, unsigned long file_no)
                 assert(0 == cur->opened_grps_cnt);
                 assert(0 == cur->opened_dtypes_cnt);
                 assert(0 == cur->opened_attrs_cnt);
+                dayu_live_file_close(cur->live_slot);
+                dayu_dset_extent_drop(cur->file_name); // a reopen republishes, after a truncate too
 
                 // Unlink from list of opened files
                 if(cur == helper->opened_files) //first node is the target
@@ -1501,8 +1466,8 @@ int rm_file_node(tkr_helper_t* helper, unsigned long file_no)
         cur = cur->next;
     }
 
-    FILE_INFO_RM_TIME += (get_time_usec() - start);
-    FILE_LL_TOTAL_TIME += (get_time_usec() - start);
+    TKR_ADD(FILE_INFO_RM_TIME, (get_time_usec() - start));
+    TKR_ADD(FILE_LL_TOTAL_TIME, (get_time_usec() - start));
 
 #ifdef DEBUG_PT_TKR_VOL
     printf("TRACKER VOL INT : rm_file_node END\n");
@@ -1584,15 +1549,13 @@ dataset_tkr_info_t * add_dataset_node(unsigned long obj_file_no,
     /* Add dset info that requires parent file info */
     cur->pfile_name = file_info->file_name ? strdup(file_info->file_name) : NULL;
 
-    tkrLockAcquire(&myLock);
-    cur->sorder_id = ++DATA_SORDER;
-    tkrLockRelease(&myLock);
+    cur->sorder_id = TKR_NEXT_ID(DATA_SORDER);
 
     // Increment refcount on dataset
     cur->obj_info.ref_cnt++;
 
-    DSET_INFO_ADD_TIME+= (get_time_usec() - start);
-    DSET_LL_TOTAL_TIME += (get_time_usec() - start);
+    TKR_ADD(DSET_INFO_ADD_TIME, (get_time_usec() - start));
+    TKR_ADD(DSET_LL_TOTAL_TIME, (get_time_usec() - start));
     return cur;
 }
 
@@ -1638,8 +1601,8 @@ int rm_dataset_node(tkr_helper_t *helper, void *under_obj, hid_t under_vol_id, d
                 assert(file_info->opened_datasets == NULL);
 
             // Decrement refcount on file info
-            DSET_INFO_RM_TIME += (get_time_usec() - start);
-            DSET_LL_TOTAL_TIME += (get_time_usec() - start);
+            TKR_ADD(DSET_INFO_RM_TIME, (get_time_usec() - start));
+            TKR_ADD(DSET_LL_TOTAL_TIME, (get_time_usec() - start));
             rm_file_node(helper, file_info->file_no);
 
             return 0;
@@ -1649,8 +1612,8 @@ int rm_dataset_node(tkr_helper_t *helper, void *under_obj, hid_t under_vol_id, d
         cur = cur->next;
     }
 
-    DSET_INFO_RM_TIME += (get_time_usec() - start);
-    DSET_LL_TOTAL_TIME += (get_time_usec() - start);
+    TKR_ADD(DSET_INFO_RM_TIME, (get_time_usec() - start));
+    TKR_ADD(DSET_LL_TOTAL_TIME, (get_time_usec() - start));
     //node not found.
     return -1;
 }
@@ -1706,10 +1669,9 @@ dataset_tkr_info_t * new_ds_tkr_info(void* under_object, hid_t vol_id, H5O_token
 
     ds_info = new_dataset_info(file_info, ds_name, token);
 
-    dt_id = dataset_get_type(under_object, vol_id, dxpl_id);
-    ds_info->dt_class = H5Tget_class(dt_id);
-    ds_info->dset_type_size = H5Tget_size(dt_id);
-    H5Tclose(dt_id);
+    // dtype, dspace, layout and offset are queried by dataset_info_capture()
+    // on first read/write or at close, datasets opened only for attributes
+    // never pay for the under VOL round-trips
 
     return ds_info;
 }
@@ -1990,38 +1952,68 @@ H5VL_tracker_t * _obj_wrap_under(void *under, H5VL_tracker_t *upper_o,
     return obj;
 }
 
-unsigned int genHash(const char *msg) {
-    unsigned long hash = 0;
-    unsigned long c;
-    unsigned int func_index;
-    const char* tmp = msg;
-
-    while (0 != (c = (unsigned long)(*msg++))) {//SDBM hash
-        hash = c + (hash << 6) + (hash << 16) - hash;
-    }
-
-    msg = tmp;//restore string head address
-    func_index = (unsigned int)(hash % STAT_FUNC_MOD);
-    if(!FUNC_DIC[func_index]) {
-        FUNC_DIC[func_index] = strdup(msg);
-        //printf("received msg = %s, hash index = %d, result msg = %s\n", msg, func_index, FUNC_DIC[func_index]);
-    }
+// Close the profile of one callback call: native_time is the time spent in
+// the under connector, the rest since start is tracker self time
+void tkr_cb_record(tkr_cb_t cb, unsigned long start, unsigned long native_time)
+{
+    unsigned long self_time = get_time_usec() - start - native_time;
+    tkr_cb_stat_t* stat = &TKR_CB_STAT[cb];
+    int bin = self_time == 0 ? 0 : 64 - __builtin_clzl(self_time);
+
+    TKR_ADD(TOTAL_TKR_OVERHEAD, self_time);
+    TKR_ADD(stat->calls, 1);
+    TKR_ADD(stat->native_time, native_time);
+    TKR_ADD(stat->self_time, self_time);
+    TKR_ADD(stat->self_hist[bin < TKR_CB_HIST_BINS ? bin : TKR_CB_HIST_BINS - 1], 1);
+}
 
-    return func_index;
+static int tkr_cb_cmp_self(const void* a, const void* b)
+{
+    unsigned long sa = TKR_CB_STAT[*(const int*)a].self_time;
+    unsigned long sb = TKR_CB_STAT[*(const int*)b].self_time;
+    return sa < sb ? 1 : (sa > sb ? -1 : 0);
 }
 
-void _dic_init(void){
-    for(int i = 0; i < STAT_FUNC_MOD; i++){
-        FUNC_DIC[i] = NULL;
+// One record with a row per called callback, highest self time first
+void tkr_cb_profile_log(dayu_sink_t* sink)
+{
+    int order[TKR_CB_NUM];
+    int n = 0;
+    char* rec = NULL;
+    size_t rec_len = 0;
+    FILE* f;
+
+    for(int cb = 0; cb < TKR_CB_NUM; cb++)
+        if(TKR_CB_STAT[cb].calls > 0)
+            order[n++] = cb;
+    qsort(order, n, sizeof(int), tkr_cb_cmp_self);
+
+    f = open_memstream(&rec, &rec_len);
+    fprintf(f, "{\n    \"Callback-Profile\": [");
+    for(int i = 0; i < n; i++){
+        tkr_cb_stat_t* stat = &TKR_CB_STAT[order[i]];
+        int top = 0;
+        for(int b = 0; b < TKR_CB_HIST_BINS; b++)
+            if(stat->self_hist[b])
+                top = b;
+        fprintf(f, "%s\n        {\"name\": \"%s\", \"calls\": %lu, \"native(us)\": %lu, \"self(us)\": %lu, "
+            "\"self_avg(us)\": %.2f, \"self_hist\": [", i ? "," : "", TKR_CB_NAME[order[i]],
+            stat->calls, stat->native_time, stat->self_time, (double)stat->self_time / stat->calls);
+        for(int b = 0; b <= top; b++)
+            fprintf(f, "%s%lu", b ? ", " : "", stat->self_hist[b]);
+        fprintf(f, "]}");
     }
-}
+    fprintf(f, "\n    ]\n}");
+    dayu_sink_record_end(sink, f, &rec, &rec_len);
 
-void _dic_free(void){
-    for(int i = 0; i < STAT_FUNC_MOD; i++){
-        if(FUNC_DIC[i]){
-            free(FUNC_DIC[i]);
-        }
+#ifdef VOLTRK_PROV_DEBUG
+    printf("%-40s %10s %14s %14s %10s\n", "callback", "calls", "native(us)", "self(us)", "self/call");
+    for(int i = 0; i < n; i++){
+        tkr_cb_stat_t* stat = &TKR_CB_STAT[order[i]];
+        printf("%-40s %10lu %14lu %14lu %10.2f\n", TKR_CB_NAME[order[i]], stat->calls,
+            stat->native_time, stat->self_time, (double)stat->self_time / stat->calls);
     }
+#endif
 }
 
 // TODO: currently not used
@@ -2113,125 +2105,25 @@ void tkr_log_open_things(FILE *f)
 
 /* Tracker internal print and logs implementation */
 
-void _dic_print(void){
-    for(int i = 0; i < STAT_FUNC_MOD; i++){
-        if(FUNC_DIC[i]){
-            printf("%d %s\n", i, FUNC_DIC[i]);
-        }
-    }
-}
-void _preset_dic_print(void){
-    const char* preset_dic[] = {
-            "H5VL_tracker_init",                         /* initialize   */
-            "H5VL_tracker_term",                         /* terminate    */
-            "H5VL_tracker_info_copy",                /* info copy    */
-            "H5VL_tracker_info_cmp",                 /* info compare */
-            "H5VL_tracker_info_free",                /* info free    */
-            "H5VL_tracker_info_to_str",              /* info to str  */
-            "H5VL_tracker_str_to_info",              /* str to info  */
-            "H5VL_tracker_get_object",               /* get_object   */
-            "H5VL_tracker_get_wrap_ctx",             /* get_wrap_ctx */
-            "H5VL_tracker_wrap_object",              /* wrap_object  */
-            "H5VL_tracker_unwrap_object",            /* unwrap_object  */
-            "H5VL_tracker_free_wrap_ctx",            /* free_wrap_ctx */
-            "H5VL_tracker_attr_create",                       /* create */
-            "H5VL_tracker_attr_open",                         /* open */
-            "H5VL_tracker_attr_read",                         /* read */
-            "H5VL_tracker_attr_write",                        /* write */
-            "H5VL_tracker_attr_get",                          /* get */
-            "H5VL_tracker_attr_specific",                     /* specific */
-            "H5VL_tracker_attr_optional",                     /* optional */
-            "H5VL_tracker_attr_close",                         /* close */
-            "H5VL_tracker_dataset_create",                    /* create */
-            "H5VL_tracker_dataset_open",                      /* open */
-            "H5VL_tracker_dataset_read",                      /* read */
-            "H5VL_tracker_dataset_write",                     /* write */
-            "H5VL_tracker_dataset_get",                       /* get */
-            "H5VL_tracker_dataset_specific",                  /* specific */
-            "H5VL_tracker_dataset_optional",                  /* optional */
-            "H5VL_tracker_dataset_close",                      /* close */
-            "H5VL_tracker_datatype_commit",                   /* commit */
-            "H5VL_tracker_datatype_open",                     /* open */
-            "H5VL_tracker_datatype_get",                      /* get_size */
-            "H5VL_tracker_datatype_specific",                 /* specific */
-            "H5VL_tracker_datatype_optional",                 /* optional */
-            "H5VL_tracker_datatype_close",                     /* close */
-            "H5VL_tracker_file_create",                       /* create */
-            "H5VL_tracker_file_open",                         /* open */
-            "H5VL_tracker_file_get",                          /* get */
-            "H5VL_tracker_file_specific",                     /* specific */
-            "H5VL_tracker_file_optional",                     /* optional */
-            "H5VL_tracker_file_close",                         /* close */
-            "H5VL_tracker_group_create",                      /* create */
-            "H5VL_tracker_group_open",                        /* open */
-            "H5VL_tracker_group_get",                         /* get */
-            "H5VL_tracker_group_specific",                    /* specific */
-            "H5VL_tracker_group_optional",                    /* optional */
-            "H5VL_tracker_group_close",                        /* close */
-            "H5VL_tracker_link_create",                       /* create */
-            "H5VL_tracker_link_copy",                         /* copy */
-            "H5VL_tracker_link_move",                         /* move */
-            "H5VL_tracker_link_get",                          /* get */
-            "H5VL_tracker_link_specific",                     /* specific */
-            "H5VL_tracker_link_optional",                     /* optional */
-            "H5VL_tracker_object_open",                       /* open */
-            "H5VL_tracker_object_copy",                       /* copy */
-            "H5VL_tracker_object_get",                        /* get */
-            "H5VL_tracker_object_specific",                   /* specific */
-            "H5VL_tracker_object_optional",                   /* optional */
-            "H5VL_tracker_request_wait",                      /* wait */
-            "H5VL_tracker_request_notify",
-            "H5VL_tracker_request_cancel",
-            "H5VL_tracker_request_specific",
-            "H5VL_tracker_request_optional",
-            "H5VL_tracker_request_free",
-            "H5VL_tracker_blob_put",
-            "H5VL_tracker_blob_get",
-            "H5VL_tracker_blob_specific",
-    };
-    int size = sizeof(preset_dic) / sizeof(const char*);
-    int key_space[1000];
-
-    for(int i = 0; i < 1000; i++){
-        key_space[i] = -1;
-    }
-
-    for(int i = 0; i < size; i++){
-        printf("%d %s\n", genHash(preset_dic[i]), preset_dic[i]);
-        if(key_space[genHash(preset_dic[i])] == -1){
-            key_space[genHash(preset_dic[i])] = (int)genHash(preset_dic[i]);
-        }else
-            printf("Collision found: key = %d, hash index = %d\n", key_space[genHash(preset_dic[i])], genHash(preset_dic[i]));
-    }
-}
-
-
-
 void tkr_helper_teardown(tkr_helper_t* helper){
 
     if(helper){// not null
 
-    // Close json file list
-    FILE * f = fopen(helper->tkr_file_path, "r+");
-
-    fseek(f, -3, SEEK_END);
-    // Add the closing JSON array bracket
-    fwrite("}]", 2, 1, f);
-
-    // Close the file
-    fclose(f);
+    // Flush pending records and close json file list
+    tkr_cb_profile_log(&helper->log_sink);
+    tkr_req_log(&helper->log_sink);
+    dayu_mem_log(&helper->log_sink);
+    dayu_sink_close(&helper->log_sink);
 
 #ifdef VOLTRK_PROV_DEBUG
-
-        printf(pline,
-                "TOTAL_TKR_OVERHEAD %llu\n"
-                "TOTAL_NATIVE_H5_TIME %llu\n"
-                "TKR_WRITE_TOTAL_TIME %llu\n"
-                "FILE_LL_TOTAL_TIME %llu\n"
-                "DSET_LL_TOTAL_TIME %llu\n"
-                "GRP_LL_TOTAL_TIME %llu\n"
-                "DT_LL_TOTAL_TIME %llu\n"
-                "ATTR_LL_TOTAL_TIME %llu\n",
+        printf("TOTAL_TKR_OVERHEAD %lu\n"
+                "TOTAL_NATIVE_H5_TIME %lu\n"
+                "TKR_WRITE_TOTAL_TIME %lu\n"
+                "FILE_LL_TOTAL_TIME %lu\n"
+                "DSET_LL_TOTAL_TIME %lu\n"
+                "GRP_LL_TOTAL_TIME %lu\n"
+                "DT_LL_TOTAL_TIME %lu\n"
+                "ATTR_LL_TOTAL_TIME %lu\n",
                 TOTAL_TKR_OVERHEAD,
                 TOTAL_NATIVE_H5_TIME,
                 TKR_WRITE_TOTAL_TIME,
@@ -2240,53 +2132,6 @@ void tkr_helper_teardown(tkr_helper_t* helper){
                 GRP_LL_TOTAL_TIME,
                 DT_LL_TOTAL_TIME,
                 ATTR_LL_TOTAL_TIME);
-
-        char pline[512];
-        FILE * file_handle = fopen(helper->tkr_file_path, "a");
-
-
-        // sprintf(pline,
-        //         "TOTAL_TKR_OVERHEAD %llu\n"
-        //         "TOTAL_NATIVE_H5_TIME %llu\n"
-        //         "TKR_WRITE_TOTAL_TIME %llu\n"
-        //         "FILE_LL_TOTAL_TIME %llu\n"
-        //         "DSET_LL_TOTAL_TIME %llu\n"
-        //         "GRP_LL_TOTAL_TIME %llu\n"
-        //         "DT_LL_TOTAL_TIME %llu\n"
-        //         "ATTR_LL_TOTAL_TIME %llu\n",
-        //         TOTAL_TKR_OVERHEAD,
-        //         TOTAL_NATIVE_H5_TIME,
-        //         TKR_WRITE_TOTAL_TIME,
-        //         FILE_LL_TOTAL_TIME,
-        //         DSET_LL_TOTAL_TIME,
-        //         GRP_LL_TOTAL_TIME,
-        //         DT_LL_TOTAL_TIME,
-        //         ATTR_LL_TOTAL_TIME);
-
-        // switch(helper->tkr_level){
-        //     case File_only:
-        //         fputs(pline, file_handle);
-        //         break;
-
-        //     case File_and_print:
-        //         fputs(pline, file_handle);
-        //         printf("%s", pline);
-        //         break;
-
-        //     case Print_only:
-        //         printf("%s", pline);
-        //         break;
-
-        //     case Level4:
-        //     case Level5:
-        //     case Disabled:
-        //     case Default:
-        //     default:
-        //         break;
-        // }
-
-        fflush(file_handle);
-        fclose(file_handle);
 #endif
         tkrLockDestroy(&myLock);
         destroy_hash_lock();
@@ -2307,7 +2152,6 @@ void tkr_helper_teardown(tkr_helper_t* helper){
         //     free(helper->tkr_line_format);
 
         // free(helper);
-        // _dic_free();
     }
 }
 
@@ -2336,23 +2180,25 @@ int tkr_write(tkr_helper_t* helper_in, const char* msg, unsigned long duration){
                 break;
     }
 #ifdef VOLTRK_PROV_DEBUG
-    FILE * file_handle = fopen(helper_in->tkr_file_path, "a");
-
-    sprintf(pline, "%s %llu(us)\n",  msg, duration);//assume less than 64 functions
+    // Per-callback overhead goes through the sink as its own record
+    int len = snprintf(pline, sizeof(pline),
+        "{\n    \"Func\": {\n        \"name\": \"%s\",\n        \"duration(us)\": %lu\n    }\n}",
+        msg, duration);
+    if(len >= (int)sizeof(pline))
+        len = sizeof(pline) - 1;
 
-    //printf("Func name:[%s], hash index = [%u], overhead = [%llu]\n",  msg, genHash(msg), duration);
     switch(helper_in->tkr_level){
         case File_only:
-            fputs(pline, file_handle);
+            dayu_sink_put(&helper_in->log_sink, pline, (size_t)len);
             break;
 
         case File_and_print:
-            fputs(pline, file_handle);
-            printf("%s", pline);
+            dayu_sink_put(&helper_in->log_sink, pline, (size_t)len);
+            printf("%s %lu(us)\n", msg, duration);
             break;
 
         case Print_only:
-            printf("%s", pline);
+            printf("%s %lu(us)\n", msg, duration);
             break;
 
         case Level4:
@@ -2362,17 +2208,10 @@ int tkr_write(tkr_helper_t* helper_in, const char* msg, unsigned long duration){
         default:
             break;
     }
-
-    if(helper_in->tkr_level == (File_only | File_and_print )){
-        fputs(pline, file_handle);
-    }
-//    unsigned tmp = TKR_WRITE_TOTAL_TIME;
-    fflush(file_handle); // TODO: check if this is necessary
-    fclose(file_handle);
 #endif
 
 
-    TKR_WRITE_TOTAL_TIME += (get_time_usec() - start);
+    TKR_ADD(TKR_WRITE_TOTAL_TIME, (get_time_usec() - start));
     return 0;
 }
 
@@ -2382,15 +2221,18 @@ int tkr_write(tkr_helper_t* helper_in, const char* msg, unsigned long duration){
 void log_file_stat_json(tkr_helper_t* helper_in, const file_tkr_info_t* file_info)
 {
     unsigned long start = get_time_usec();
-    FILE * f = fopen(helper_in->tkr_file_path, "a");
-    
+    dayu_sink_t* sink = &helper_in->log_sink;
+    char* rec = NULL;
+    size_t rec_len = 0;
+    FILE * f = NULL;
+
     if (!file_info) {
-        fprintf(f, "log_file_stat_json(): file_info is NULL.\n");
+        fprintf(stderr, "log_file_stat_json(): file_info is NULL.\n");
         return;
     }
 
 #ifdef ACCESS_STAT
-    log_dset_ht_json(f);
+    log_dset_ht_json(sink, 0);
 
     // char* file_name = strrchr(file_info->file_name, '/');
     char* file_name = (char *) file_info->file_name;
@@ -2400,6 +2242,7 @@ void log_file_stat_json(tkr_helper_t* helper_in, const file_tkr_info_t* file_inf
     else
         file_name = (char*)file_info->file_name;
 
+    f = open_memstream(&rec, &rec_len);
     fprintf(f, "{\n");
     fprintf(f, "    \"file-%ld\": {\n", file_info->sorder_id);
     fprintf(f, "        \"file_name\": \"/%s\",\n", file_name);
@@ -2415,323 +2258,1518 @@ void log_file_stat_json(tkr_helper_t* helper_in, const file_tkr_info_t* file_inf
     fprintf(f, "        \"grp_created\": %d,\n", file_info->grp_created);
     fprintf(f, "        \"grp_accessed\": %d,\n", file_info->grp_accessed);
     fprintf(f, "        \"dtypes_created\": %d,\n", file_info->dtypes_created);
-    fprintf(f, "        \"dtypes_accessed\": %d\n", file_info->dtypes_accessed);
+    fprintf(f, "        \"dtypes_accessed\": %d,\n", file_info->dtypes_accessed);
+    fprintf(f, "        \"blob_put_cnt\": %lu,\n", file_info->blob_put_cnt);
+    fprintf(f, "        \"blob_put_bytes\": %zu,\n", file_info->blob_put_bytes);
+    fprintf(f, "        \"blob_get_cnt\": %lu,\n", file_info->blob_get_cnt);
+    fprintf(f, "        \"blob_get_bytes\": %zu\n", file_info->blob_get_bytes);
     fprintf(f, "    }\n");
-    fprintf(f, "},\n");
+    fprintf(f, "}");
+    dayu_sink_record_end(sink, f, &rec, &rec_len);
 
 #endif
 
+    f = open_memstream(&rec, &rec_len);
     fprintf(f, "{\n");
     fprintf(f, "    \"Task\": {\n");
     fprintf(f, "        \"task_id\": %d,\n", getpid());
-    fprintf(f, "        \"VOL-Overhead(us)\": %ld,\n", TOTAL_TKR_OVERHEAD);
-    fprintf(f, "        \"VOL-Init(us)\": %ld,\n", TKR_INIT_TIME);
-    fprintf(f, "        \"VOL-Term(us)\": %ld,\n", TKR_TERM_TIME);
-    fprintf(f, "        \"VOL-Log(us)\": %ld,\n", TKR_LOG_TIME);
-
-    fprintf(f, "        \"VOL-HT-Overhead(us)\": %ld,\n", FILE_DSET_HT_TOTAL_TIME);
-    fprintf(f, "        \"VOL-HT-Add(us)\": %ld,\n", FILE_DSET_HT_ADD_TIME);
-    fprintf(f, "        \"VOL-HT-Rm(us)\": %ld,\n", FILE_DSET_HT_RM_TIME);
-    fprintf(f, "        \"VOL-HT-Search(us)\": %ld,\n", FILE_DSET_HT_SEARCH_TIME);
+    fprintf(f, "        \"VOL-Overhead(us)\": %ld,\n", TKR_TAKE(TOTAL_TKR_OVERHEAD));
+    fprintf(f, "        \"VOL-Init(us)\": %ld,\n", TKR_TAKE(TKR_INIT_TIME));
+    fprintf(f, "        \"VOL-Term(us)\": %ld,\n", TKR_TAKE(TKR_TERM_TIME));
+    fprintf(f, "        \"VOL-Log(us)\": %ld,\n", TKR_TAKE(TKR_LOG_TIME));
+
+    fprintf(f, "        \"VOL-HT-Overhead(us)\": %ld,\n", TKR_TAKE(FILE_DSET_HT_TOTAL_TIME));
+    fprintf(f, "        \"VOL-HT-Add(us)\": %ld,\n", TKR_TAKE(FILE_DSET_HT_ADD_TIME));
+    fprintf(f, "        \"VOL-HT-Rm(us)\": %ld,\n", TKR_TAKE(FILE_DSET_HT_RM_TIME));
+    fprintf(f, "        \"VOL-HT-Search(us)\": %ld,\n", TKR_TAKE(FILE_DSET_HT_SEARCH_TIME));
     
-    fprintf(f, "        \"VOL-FILE_LL-Overhead(us)\": %ld,\n", FILE_LL_TOTAL_TIME);
-    fprintf(f, "        \"VOL-FILE_LL-Add(us)\": %ld,\n", FILE_INFO_ADD_TIME);
-    fprintf(f, "        \"VOL-FILE_LL-Rm(us)\": %ld,\n", FILE_INFO_RM_TIME);
-    fprintf(f, "        \"VOL-FILE_LL-Update(us)\": %ld,\n", FILE_INFO_UPDATE_TIME);
+    fprintf(f, "        \"VOL-FILE_LL-Overhead(us)\": %ld,\n", TKR_TAKE(FILE_LL_TOTAL_TIME));
+    fprintf(f, "        \"VOL-FILE_LL-Add(us)\": %ld,\n", TKR_TAKE(FILE_INFO_ADD_TIME));
+    fprintf(f, "        \"VOL-FILE_LL-Rm(us)\": %ld,\n", TKR_TAKE(FILE_INFO_RM_TIME));
+    fprintf(f, "        \"VOL-FILE_LL-Update(us)\": %ld,\n", TKR_TAKE(FILE_INFO_UPDATE_TIME));
 
-    fprintf(f, "        \"VOL-DS_LL-Overhead(us)\": %ld,\n", DSET_LL_TOTAL_TIME);
-    fprintf(f, "        \"VOL-DS_LL-Add(us)\": %ld,\n", DSET_INFO_ADD_TIME);
-    fprintf(f, "        \"VOL-DS_LL-Rm(us)\": %ld,\n", DSET_INFO_RM_TIME);
-    fprintf(f, "        \"VOL-DS_LL-Update(us)\": %ld,\n", DSET_INFO_UPDATE_TIME);
+    fprintf(f, "        \"VOL-DS_LL-Overhead(us)\": %ld,\n", TKR_TAKE(DSET_LL_TOTAL_TIME));
+    fprintf(f, "        \"VOL-DS_LL-Add(us)\": %ld,\n", TKR_TAKE(DSET_INFO_ADD_TIME));
+    fprintf(f, "        \"VOL-DS_LL-Rm(us)\": %ld,\n", TKR_TAKE(DSET_INFO_RM_TIME));
+    fprintf(f, "        \"VOL-DS_LL-Update(us)\": %ld,\n", TKR_TAKE(DSET_INFO_UPDATE_TIME));
+    fprintf(f, "        \"VOL-DS_Cache-Hit\": %ld,\n", TKR_TAKE(DSET_PROP_CACHE_HIT));
+    fprintf(f, "        \"VOL-DS_Cache-Miss\": %ld,\n", TKR_TAKE(DSET_PROP_CACHE_MISS));
 
-    fprintf(f, "        \"VOL-GRP_LL-Overhead(us)\": %ld,\n", GRP_LL_TOTAL_TIME);
-    fprintf(f, "        \"VOL-GRP_LL-Add(us)\": %ld,\n", GRP_INFO_ADD_TIME);
-    fprintf(f, "        \"VOL-GRP_LL-Rm(us)\": %ld,\n", GRP_INFO_RM_TIME);
+    fprintf(f, "        \"VOL-GRP_LL-Overhead(us)\": %ld,\n", TKR_TAKE(GRP_LL_TOTAL_TIME));
+    fprintf(f, "        \"VOL-GRP_LL-Add(us)\": %ld,\n", TKR_TAKE(GRP_INFO_ADD_TIME));
+    fprintf(f, "        \"VOL-GRP_LL-Rm(us)\": %ld,\n", TKR_TAKE(GRP_INFO_RM_TIME));
 
-    fprintf(f, "        \"VOL-DT_LL-Overhead(us)\": %ld,\n", DT_LL_TOTAL_TIME);
-    fprintf(f, "        \"VOL-DT_LL-Add(us)\": %ld,\n", DT_INFO_ADD_TIME);
-    fprintf(f, "        \"VOL-DT_LL-Rm(us)\": %ld,\n", DT_INFO_RM_TIME);
+    fprintf(f, "        \"VOL-DT_LL-Overhead(us)\": %ld,\n", TKR_TAKE(DT_LL_TOTAL_TIME));
+    fprintf(f, "        \"VOL-DT_LL-Add(us)\": %ld,\n", TKR_TAKE(DT_INFO_ADD_TIME));
+    fprintf(f, "        \"VOL-DT_LL-Rm(us)\": %ld,\n", TKR_TAKE(DT_INFO_RM_TIME));
 
-    fprintf(f, "        \"VOL-All_LL-Overhead(us)\": %ld\n", TRK_ACCESS_STAT_TIME);
+    fprintf(f, "        \"VOL-All_LL-Overhead(us)\": %ld\n", TKR_TAKE(TRK_ACCESS_STAT_TIME));
 
     // fprintf(f, "        \"TOTAL_NATIVE_H5_TIME(us)\": %ld,\n", TOTAL_NATIVE_H5_TIME);
     // fprintf(f, "        \"TKR_WRITE_TOTAL_TIME(us)\": %ld,\n", TKR_WRITE_TOTAL_TIME);
     
     fprintf(f, "    }\n");
-    fprintf(f, "},\n");
+    fprintf(f, "}");
+    dayu_sink_record_end(sink, f, &rec, &rec_len);
 
-    TOTAL_TKR_OVERHEAD = 0; // reset the total overhead once recorded
-    TKR_INIT_TIME = 0; // reset the total init time once recorded
-    TKR_TERM_TIME = 0; // reset the total term time once recorded
-    TKR_LOG_TIME = 0; // reset the total log time once recorded
+    // counters above were reset as they were printed
+    (void)TKR_TAKE(ATTR_LL_TOTAL_TIME);
 
-    FILE_DSET_HT_TOTAL_TIME = 0; // reset the total file-dataset hash table time once recorded
-    FILE_DSET_HT_ADD_TIME = 0; // reset the total file-dataset hash table add time once recorded
-    FILE_DSET_HT_RM_TIME = 0; // reset the total file-dataset hash table remove time once recorded
-    FILE_DSET_HT_SEARCH_TIME = 0; // reset the total file-dataset hash table search time once recorded
+    TKR_ADD(TKR_LOG_TIME, (get_time_usec() - start));
+}
+
+/* Selection summary implementation start */
+static int dset_sel_match(const sel_summary_t* sel, char op, H5S_sel_type sel_type, int ndim,
+    hssize_t npoints, hssize_t nblocks, const hsize_t* start, const hsize_t* end)
+{
+    if(sel->op != op || sel->sel_type != sel_type || sel->ndim != ndim
+        || sel->npoints != npoints || sel->nblocks != nblocks)
+        return 0;
+    if(ndim == 0)
+        return 1;
+    return memcmp(sel->bbox_start, start, sizeof(hsize_t) * ndim) == 0
+        && memcmp(sel->bbox_end, end, sizeof(hsize_t) * ndim) == 0;
+}
+
+static void dset_sel_free_one(sel_summary_t* sel)
+{
+    free(sel->bbox_start); // bbox_end and stride share the allocation
+    free(sel);
+    dayu_mem_charge(-(long)sizeof(sel_summary_t));
+}
+
+// Irregular hyperslab: walk the block list in fixed pages and take the
+// smallest non-zero step between consecutive block starts in each dim.
+static void dset_sel_scan_strides(hid_t space_id, sel_summary_t* sel)
+{
+    hsize_t blk_buf[TKR_SEL_BLOCK_BUF];
+    hsize_t prev[H5S_MAX_RANK];
+    int ndim = sel->ndim;
+    hsize_t page = TKR_SEL_BLOCK_BUF / (2 * ndim);
+    hsize_t limit = (hsize_t)sel->nblocks;
+
+    if(limit > TKR_SEL_SCAN_BLOCKS){
+        limit = TKR_SEL_SCAN_BLOCKS;
+        sel->stride_sampled = 1;
+    }
+
+    for(hsize_t b = 0; b < limit; b += page){
+        hsize_t n = (limit - b) < page ? (limit - b) : page;
+        if(H5Sget_select_hyper_blocklist(space_id, b, n, blk_buf) < 0)
+            break;
+        for(hsize_t i = 0; i < n; i++){
+            hsize_t* blk_start = blk_buf + i * 2 * ndim;
+            if(b + i > 0){
+                for(int d = 0; d < ndim; d++){
+                    if(blk_start[d] == prev[d])
+                        continue;
+                    hsize_t delta = blk_start[d] > prev[d] ? blk_start[d] - prev[d] : prev[d] - blk_start[d];
+                    if(!sel->stride[d] || delta < sel->stride[d])
+                        sel->stride[d] = delta;
+                }
+            }
+            memcpy(prev, blk_start, sizeof(hsize_t) * ndim);
+        }
+    }
+}
+
+// Summarize the file selection of one read or write: bounding box, block
+// count, per-dim stride and selected bytes. A call matching the last run
+// (type, points, blocks and bounding box) only bumps its repeat count, so
+// time-step loops never walk the block list again. Returns 1 on a repeat.
+int dset_sel_record(dataset_tkr_info_t* dset_info, char op, hid_t file_space_id, hid_t mem_type_id)
+{
+    H5S_sel_type sel_type = H5S_SEL_ALL;
+    hssize_t npoints = 0;
+    hssize_t nblocks = 0;
+    int ndim = 0;
+    hsize_t start[H5S_MAX_RANK];
+    hsize_t end[H5S_MAX_RANK];
+    size_t type_size = dset_info->dset_type_size;
+    int is_space = (file_space_id > 0 && H5Iget_type(file_space_id) == H5I_DATASPACE);
+
+    if(is_space){
+        sel_type = H5Sget_select_type(file_space_id);
+        npoints = H5Sget_select_npoints(file_space_id);
+        ndim = H5Sget_simple_extent_ndims(file_space_id);
+        if(ndim < 0 || ndim > H5S_MAX_RANK)
+            ndim = 0;
+        memset(start, 0, sizeof(start));
+        memset(end, 0, sizeof(end));
+        if(npoints > 0 && ndim > 0)
+            H5Sget_select_bounds(file_space_id, start, end);
+
+        if(sel_type == H5S_SEL_HYPERSLABS)
+            nblocks = H5Sget_select_hyper_nblocks(file_space_id);
+        else if(sel_type == H5S_SEL_POINTS)
+            nblocks = H5Sget_select_elem_npoints(file_space_id);
+        else if(sel_type == H5S_SEL_ALL)
+            nblocks = 1;
+    }
+    else {
+        // H5S_ALL: the whole dataset extent
+        ndim = dset_info->dimensions ? (int)dset_info->dimension_cnt : 0;
+        for(int d = 0; d < ndim; d++){
+            start[d] = 0;
+            end[d] = dset_info->dimensions[d] ? dset_info->dimensions[d] - 1 : 0;
+        }
+        npoints = (hssize_t)dset_info->dset_n_elements;
+        nblocks = 1;
+    }
 
-    FILE_LL_TOTAL_TIME = 0; // reset the total file time once recorded
-    FILE_INFO_ADD_TIME = 0; // reset the total file add time once recorded
-    FILE_INFO_RM_TIME = 0; // reset the total file remove time once recorded
-    FILE_INFO_UPDATE_TIME = 0; // reset the total file update time once recorded
+    if(!type_size && mem_type_id > 0)
+        type_size = H5Tget_size(mem_type_id);
+    dset_info->hyper_nblocks = nblocks;
+    dset_info->sel_npoints = npoints;
 
-    DSET_LL_TOTAL_TIME = 0; // reset the total dataset time once recorded
-    DSET_INFO_ADD_TIME = 0; // reset the total dataset add time once recorded
-    DSET_INFO_RM_TIME = 0; // reset the total dataset remove time once recorded
-    DSET_INFO_UPDATE_TIME = 0; // reset the total dataset update time once recorded
+    if(dset_info->sel_tail && dset_sel_match(dset_info->sel_tail, op, sel_type, ndim, npoints, nblocks, start, end)){
+        dset_info->sel_tail->repeat++;
+        return 1;
+    }
+    if(dset_info->sel_runs >= TKR_SEL_MAX_RUNS){
+        dset_info->sel_dropped++;
+        return 0;
+    }
+    // Past the memory budget's coarsen level keep the first run only
+    if(dset_info->sel_runs > 0 && dayu_mem_level() >= DAYU_MEM_COARSEN){
+        dset_info->sel_dropped++;
+        dayu_mem_degraded(DAYU_MEM_DROPPED, "vol");
+        return 0;
+    }
 
-    GRP_LL_TOTAL_TIME = 0; // reset the total group time once recorded
-    GRP_INFO_ADD_TIME = 0; // reset the total group add time once recorded
-    GRP_INFO_RM_TIME = 0; // reset the total group remove time once recorded
+    sel_summary_t* sel = (sel_summary_t*)calloc(1, sizeof(sel_summary_t));
+    if(!sel)
+        return 0;
+    dayu_mem_charge(sizeof(sel_summary_t));
+    sel->op = op;
+    sel->sel_type = sel_type;
+    sel->ndim = ndim;
+    sel->npoints = npoints;
+    sel->nblocks = nblocks;
+    sel->sel_bytes = npoints > 0 ? (size_t)npoints * type_size : 0;
+    sel->repeat = 1;
+
+    if(ndim > 0){
+        sel->bbox_start = (hsize_t*)calloc(3 * ndim, sizeof(hsize_t));
+        if(!sel->bbox_start){
+            dset_sel_free_one(sel);
+            return 0;
+        }
+        sel->bbox_end = sel->bbox_start + ndim;
+        sel->stride = sel->bbox_end + ndim;
+        memcpy(sel->bbox_start, start, sizeof(hsize_t) * ndim);
+        memcpy(sel->bbox_end, end, sizeof(hsize_t) * ndim);
+
+        if(is_space && sel_type == H5S_SEL_HYPERSLABS && nblocks > 1){
+            if(H5Sis_regular_hyperslab(file_space_id) > 0){
+                hsize_t h_start[H5S_MAX_RANK], h_stride[H5S_MAX_RANK];
+                hsize_t h_count[H5S_MAX_RANK], h_block[H5S_MAX_RANK];
+                if(H5Sget_regular_hyperslab(file_space_id, h_start, h_stride, h_count, h_block) >= 0){
+                    for(int d = 0; d < ndim; d++)
+                        sel->stride[d] = h_count[d] > 1 ? h_stride[d] : 0;
+                }
+            }
+            else
+                dset_sel_scan_strides(file_space_id, sel);
+        }
+    }
 
-    DT_LL_TOTAL_TIME = 0; // reset the total datatype time once recorded
-    DT_INFO_ADD_TIME = 0; // reset the total datatype add time once recorded
-    DT_INFO_RM_TIME = 0; // reset the total datatype remove time once recorded
+    if(dset_info->sel_tail)
+        dset_info->sel_tail->next = sel;
+    else
+        dset_info->sel_head = sel;
+    dset_info->sel_tail = sel;
+    dset_info->sel_runs++;
+    return 0;
+}
 
-    ATTR_LL_TOTAL_TIME = 0; // reset the total attribute time once recorded
-    TRK_ACCESS_STAT_TIME = 0; // reset the total dataset info update time once recorded
+// Move the runs of a closing dataset handle onto its tracking entry,
+// joining the boundary run when the selection did not change.
+void dset_sel_append(dset_track_t* track_info, dataset_tkr_info_t* dset_info)
+{
+    sel_summary_t* cur = dset_info->sel_head;
 
-    fflush(f);
-    fclose(f);
+    while(cur){
+        sel_summary_t* next = cur->next;
+        sel_summary_t* last = track_info->sel_tail;
+        cur->next = NULL;
+
+        if(last && dset_sel_match(last, cur->op, cur->sel_type, cur->ndim,
+                cur->npoints, cur->nblocks, cur->bbox_start, cur->bbox_end)){
+            last->repeat += cur->repeat;
+            dset_sel_free_one(cur);
+        }
+        else if(track_info->sel_runs >= TKR_SEL_MAX_RUNS){
+            track_info->sel_dropped += cur->repeat;
+            dset_sel_free_one(cur);
+        }
+        else {
+            if(last)
+                last->next = cur;
+            else
+                track_info->sel_head = cur;
+            track_info->sel_tail = cur;
+            track_info->sel_runs++;
+        }
+        cur = next;
+    }
+    track_info->sel_dropped += dset_info->sel_dropped;
 
-    TKR_LOG_TIME += (get_time_usec() - start);
+    dset_info->sel_head = NULL;
+    dset_info->sel_tail = NULL;
+    dset_info->sel_runs = 0;
+    dset_info->sel_dropped = 0;
 }
 
-void H5VL_arrow_get_selected_sub_region(hid_t space_id, size_t org_type_size) {
-    // from Jie's code
+void dset_sel_free(sel_summary_t** head)
+{
+    sel_summary_t* cur = *head;
+    while(cur){
+        sel_summary_t* next = cur->next;
+        dset_sel_free_one(cur);
+        cur = next;
+    }
+    *head = NULL;
+}
 
-    size_t type_size = org_type_size;
-    int32_t s_row_idx;
-    int32_t s_col_idx;
-    int32_t sub_cols;
+static void dset_sel_dims_to_file(FILE * f, const hsize_t* dims, int ndim)
+{
+    fprintf(f, "[");
+    for(int d = 0; d < ndim; d++)
+        fprintf(f, "%llu%s", (unsigned long long)dims[d], d == ndim - 1 ? "" : ", ");
+    fprintf(f, "]");
+}
 
-    // 1. get the memspace dimensional information
-    // subRegionInfo->type_size = type_size;
-    hsize_t g_sdim[H5S_MAX_RANK];
-    int sranks = H5Sget_simple_extent_dims(space_id, g_sdim, NULL);
-    int32_t g_rows = 1;
-    for (int i = 0; i < sranks - 1; ++i) {
-        g_rows *= g_sdim[i];
+void dset_sel_to_file(FILE * f, sel_summary_t* head)
+{
+    for(sel_summary_t* sel = head; sel != NULL; sel = sel->next){
+        fprintf(f, "%s\n                    {\"op\": \"%s\", \"sel_type\": \"%s\", \"calls\": %lu, "
+            "\"nblocks\": %lld, \"npoints\": %lld, \"bytes\": %zu, \"bbox_start\": ",
+            sel == head ? "" : ",",
+            sel->op == 'r' ? "read" : "write",
+            H5S_select_type_to_str(sel->sel_type),
+            sel->repeat,
+            (long long)sel->nblocks,
+            (long long)sel->npoints,
+            sel->sel_bytes);
+        dset_sel_dims_to_file(f, sel->bbox_start, sel->ndim);
+        fprintf(f, ", \"bbox_end\": ");
+        dset_sel_dims_to_file(f, sel->bbox_end, sel->ndim);
+        fprintf(f, ", \"stride\": ");
+        dset_sel_dims_to_file(f, sel->stride, sel->ndim);
+        fprintf(f, ", \"stride_sampled\": %s}", sel->stride_sampled ? "true" : "false");
     }
-    int32_t g_cols = g_sdim[sranks - 1];
+    if(head)
+        fprintf(f, "\n                ");
+}
+/* Selection summary implementation end */
 
-    // 2. get the start coordinate of the selected region. Here we only consider a single contiguous region
-    H5S_sel_type stype = H5Sget_select_type(space_id);
-    s_row_idx = 0;
-    s_col_idx = 0;
 
-    // if (stype == H5S_SEL_ALL) {
-    //     // subRegionInfo->s_row_idx = 0;
-    //     // subRegionInfo->s_col_idx = 0;
-    //     s_row_idx = 0;
-    //     s_col_idx = 0;
-    // }
-    // else if (stype == H5S_SEL_HYPERSLABS) {
-    //     hid_t sel_iter_id = H5Ssel_iter_create(space_id, (size_t)type_size, 0);
-    //     size_t nseq;
-    //     size_t nelem;
-    //     hsize_t seq_start_off;
-    //     size_t seq_len;
-    //     H5Ssel_iter_get_seq_list(sel_iter_id, 1, (size_t)type_size, &nseq, &nelem, &seq_start_off, &seq_len);
-    //     H5Ssel_iter_close(sel_iter_id);
-
-    //     // 3. get the start coordinate according to the start_offset
-    //     // subRegionInfo->s_row_idx = (seq_start_off / type_size) / g_cols;
-    //     // subRegionInfo->s_col_idx = (seq_start_off / type_size) % g_cols;
-    //     s_row_idx = (seq_start_off / type_size) / g_cols;
-    //     s_col_idx = (seq_start_off / type_size) % g_cols;
-    // }
+/* Chunk heat implementation start */
+#define TKR_CHUNK_BYTES(ndim) (sizeof(chunk_heat_t) + sizeof(hsize_t) * (ndim))
 
-    
-    hid_t sel_iter_id = H5Ssel_iter_create(space_id, (size_t)type_size, 0);
-    size_t nseq;
-    size_t nelem;
-    int ndim = H5Sget_simple_extent_ndims(space_id);
-    hsize_t * seq_start_off = (hsize_t *)malloc(sizeof(hsize_t) * ndim);
+static chunk_heat_t* dset_chunk_new(int ndim, const hsize_t* coords)
+{
+    chunk_heat_t* chunk = (chunk_heat_t*)calloc(1, TKR_CHUNK_BYTES(ndim));
+    if(!chunk)
+        return NULL;
+    chunk->coords = (hsize_t*)(chunk + 1);
+    memcpy(chunk->coords, coords, sizeof(hsize_t) * ndim);
+    chunk->addr = HADDR_UNDEF;
+    dayu_mem_charge(TKR_CHUNK_BYTES(ndim));
+    return chunk;
+}
 
-    // uint64_t *seq_start_off = (uint64_t *)malloc(sizeof(uint64_t) * ndim);
+static void dset_chunk_release(chunk_heat_t* chunk, int ndim)
+{
+    free(chunk);
+    dayu_mem_charge(-(long)TKR_CHUNK_BYTES(ndim));
+}
 
-    size_t seq_len;
-    // H5Ssel_iter_get_seq_list(sel_iter_id, 1, (size_t)type_size, &nseq, &nelem, seq_start_off, &seq_len);
-    H5Ssel_iter_get_seq_list(sel_iter_id, 1, (size_t)type_size, &nseq, &nelem, seq_start_off, &seq_len);
+// Chunk dims of this open from the dcpl, once. Chunk addresses are resolved
+// by dset_chunk_resolve() at flush and close, not during I/O.
+void dset_chunk_init(H5VL_tracker_t* dset, dataset_tkr_info_t* dset_info, hid_t dxpl_id)
+{
+    hid_t dcpl_id;
+    int ndim;
+    hsize_t dims[H5S_MAX_RANK];
 
+    dset_info->chunk_ndim = -1;
+    if(!dset_info->layout || strcmp(dset_info->layout, "H5D_CHUNKED") != 0)
+        return;
 
-    H5Ssel_iter_close(sel_iter_id);
+    dcpl_id = dataset_get_dcpl(dset->under_object, dset->under_vol_id, dxpl_id);
+    if(dcpl_id < 0)
+        return;
+    ndim = H5Pget_chunk(dcpl_id, H5S_MAX_RANK, dims);
+    H5Pclose(dcpl_id);
+    if(ndim <= 0)
+        return;
 
-    printf("nseq: %ld\n", nseq);
-    printf("nelem: %ld\n", nelem);
+    dset_info->chunk_dims = (hsize_t*)malloc(sizeof(hsize_t) * ndim);
+    if(!dset_info->chunk_dims)
+        return;
+    memcpy(dset_info->chunk_dims, dims, sizeof(hsize_t) * ndim);
+    dset_info->chunk_ndim = ndim;
+    dset_ccache_init(dset_info);
+}
 
-    printf("sranks: %d, ", sranks);
-    printf("seq_start_off: [", seq_start_off);
+// Charge one call's bytes in a chunk, counting the chunk once per call.
+static void dset_chunk_touch(dataset_tkr_info_t* dset_info, const hsize_t* coords, size_t bytes)
+{
+    int ndim = dset_info->chunk_ndim;
+    chunk_heat_t* chunk = NULL;
 
-    for (int i=0; i< sranks; i++){
-        printf("%zu, ", seq_start_off[i]);
-    }
-    printf("], ");
-    printf("seq_len: %d, ", seq_len);
-    // // printf("seq_start_off: %ld\n", seq_start_off);
-    // for (int i = 0; i < ndim; ++i) {
-    //     printf("seq_start_off[%d]: %d\n", i, seq_start_off[i]);
-    // }
-    // printf("seq_len: %ld\n", seq_len);
-
-    // 4. get the selected rows and cols;
-    hsize_t start[sranks];
-    hsize_t end[sranks];
-    herr_t status = H5Sget_select_bounds(space_id, start, end);
-    int32_t sub_rows = 1;
-    for (int i = 0; i < sranks - 1; ++i) {
-        sub_rows *= (end[i] - start[i] + 1);
-    }
-    // subRegionInfo->sub_rows = sub_rows;
-    // subRegionInfo->sub_cols = end[sranks - 1] - start[sranks - 1] + 1;
-    // subRegionInfo->g_rows = g_rows;
-    // subRegionInfo->g_cols = g_cols;
-    sub_cols = end[sranks - 1] - start[sranks - 1] + 1;
-
-    // check file_space selection and mem_space selection
-    if(stype == H5S_SEL_NONE){
-        printf("H5S_SEL_NONE");
-    } else if (stype == H5S_SEL_POINTS){
-        printf("H5VL_arrow_get_selected_sub_region ----  type_size: %zu, ", type_size);
-        printf("s_row_idx: %d, ", s_row_idx);
-        printf("s_col_idx: %d, ", s_col_idx);
-        printf("sub_rows: %d, ", sub_rows);
-        printf("sub_cols: %d, ", sub_cols);
-        printf("g_rows: %ld, ", g_rows);
-        printf("g_cols: %ld, ", g_cols);
-
-        printf("H5Sget_select_bounds : {");
-        for (int i = 0; i < sranks; ++i) {
-            printf("start[%d]: %ld, ", i, start[i]);
-            printf("end[%d]: %ld, ", i, end[i]);
-        }
-        printf("} ");
-        printf("H5Sget_select_npoints : %ld ", H5Sget_select_npoints(space_id));
-        printf("H5Sget_select_elem_npoints : %ld ", H5Sget_select_elem_npoints(space_id));
-
-    } else if (stype == H5S_SEL_HYPERSLABS){
-        printf("H5VL_arrow_get_selected_sub_region ----  type_size: %zu, ", type_size);
-        printf("s_row_idx: %d, ", s_row_idx);
-        printf("s_col_idx: %d, ", s_col_idx);
-        printf("sub_rows: %d, ", sub_rows);
-        printf("sub_cols: %d, ", sub_cols);
-        printf("g_rows: %ld, ", g_rows);
-        printf("g_cols: %ld, ", g_cols);
-        printf("H5Sget_select_bounds : {");
-        for (int i = 0; i < sranks; ++i) {
-            printf("start[%d]: %ld, ", i, start[i]);
-            printf("end[%d]: %ld, ", i, end[i]);
+    HASH_FIND(hh, dset_info->chunk_map, coords, sizeof(hsize_t) * ndim, chunk);
+    if(!chunk){
+        if(dset_info->chunk_map_cnt >= TKR_CHUNK_MAP_MAX){
+            dset_info->chunk_dropped++;
+            return;
         }
-        printf("} ");        
-        printf("H5Sget_select_hyper_nblocks : %ld ", H5Sget_select_hyper_nblocks(space_id));
-    } else if (stype == H5S_SEL_ALL){
-        // printf("H5S_SEL_ALL ");
-        printf("H5VL_arrow_get_selected_sub_region ----  type_size: %zu, ", type_size);
-        printf("s_row_idx: %d, ", s_row_idx);
-        printf("s_col_idx: %d, ", s_col_idx);
-        printf("sub_rows: %d, ", sub_rows);
-        printf("sub_cols: %d, ", sub_cols);
-        printf("g_rows: %ld, ", g_rows);
-        printf("g_cols: %ld, ", g_cols);
-
-        printf("H5Sget_select_bounds : {");
-        for (int i = 0; i < sranks; ++i) {
-            printf("start[%d]: %ld, ", i, start[i]);
-            printf("end[%d]: %ld, ", i, end[i]);
+        // Past the memory budget's sample level only chunks already tracked are counted
+        if(dayu_mem_level() >= DAYU_MEM_SAMPLE){
+            dset_info->chunk_dropped++;
+            dayu_mem_degraded(DAYU_MEM_DROPPED, "vol");
+            return;
         }
-        printf("} ");
-        printf("H5Sget_select_npoints : %ld ", H5Sget_select_npoints(space_id));
-        printf("H5Sget_select_elem_npoints : %ld ", H5Sget_select_elem_npoints(space_id));
-        printf("H5Sget_select_hyper_nblocks : %ld ", H5Sget_select_hyper_nblocks(space_id));
-
-    } else if (stype == H5S_SEL_N){
-        printf("H5S_SEL_N ");
-    } else {
-        printf("H5S_SEL_ERROR ");
+        chunk = dset_chunk_new(ndim, coords);
+        if(!chunk)
+            return;
+        HASH_ADD_KEYPTR(hh, dset_info->chunk_map, chunk->coords, sizeof(hsize_t) * ndim, chunk);
+        dset_info->chunk_map_cnt++;
     }
-    
 
-    printf("\n");
+    if(chunk->last_call == dset_info->chunk_call){
+        dset_info->chunk_last[chunk->last_slot].bytes += bytes;
+        return;
+    }
 
-    // return 0;
+    if(dset_info->chunk_last_cnt == dset_info->chunk_last_cap){
+        size_t new_cap = dset_info->chunk_last_cap ? dset_info->chunk_last_cap * 2 : 16;
+        chunk_touch_t* new_last = (chunk_touch_t*)realloc(dset_info->chunk_last, sizeof(chunk_touch_t) * new_cap);
+        if(!new_last){
+            dset_info->chunk_dropped++;
+            return;
+        }
+        dset_info->chunk_last = new_last;
+        dset_info->chunk_last_cap = new_cap;
+    }
+    chunk->last_call = dset_info->chunk_call;
+    chunk->last_slot = dset_info->chunk_last_cnt;
+    dset_info->chunk_last[dset_info->chunk_last_cnt].chunk = chunk;
+    dset_info->chunk_last[dset_info->chunk_last_cnt].bytes = bytes;
+    dset_info->chunk_last_cnt++;
 }
 
+// Split one selection block [lo, hi] over the chunk grid.
+static void dset_chunk_touch_block(dataset_tkr_info_t* dset_info, const hsize_t* lo, const hsize_t* hi,
+    size_t type_size, hsize_t* budget)
+{
+    int ndim = dset_info->chunk_ndim;
+    const hsize_t* cdims = dset_info->chunk_dims;
+    hsize_t first[H5S_MAX_RANK];
+    hsize_t last[H5S_MAX_RANK];
+    hsize_t cur[H5S_MAX_RANK];
+
+    for(int d = 0; d < ndim; d++){
+        first[d] = lo[d] / cdims[d];
+        last[d] = hi[d] / cdims[d];
+        cur[d] = first[d];
+    }
 
+    for(;;){
+        size_t bytes = type_size;
+        for(int d = 0; d < ndim; d++){
+            hsize_t c_lo = cur[d] * cdims[d];
+            hsize_t c_hi = c_lo + cdims[d] - 1;
+            hsize_t o_lo = lo[d] > c_lo ? lo[d] : c_lo;
+            hsize_t o_hi = hi[d] < c_hi ? hi[d] : c_hi;
+            bytes *= (size_t)(o_hi - o_lo + 1);
+        }
+        dset_chunk_touch(dset_info, cur, bytes);
 
-char* get_datatype_class_str(hid_t type_id) {
-    switch (type_id) {
-        case H5T_NO_CLASS:
-            return "H5T_NO_CLASS";
-        case H5T_INTEGER:
-            return "H5T_INTEGER";
-        case H5T_FLOAT:
-            return "H5T_FLOAT";
-        case H5T_TIME:
-            return "H5T_TIME";
-        case H5T_STRING:
-            return "H5T_STRING";
-        case H5T_BITFIELD:
-            return "H5T_BITFIELD";
-        case H5T_OPAQUE:
-            return "H5T_OPAQUE";
-        case H5T_COMPOUND:
-            return "H5T_COMPOUND";
-        case H5T_REFERENCE:
-            return "H5T_REFERENCE";
-        case H5T_ENUM:
-            return "H5T_ENUM";
-        case H5T_VLEN:
-            return "H5T_VLEN";
-        case H5T_ARRAY:
-            return "H5T_ARRAY";
-        default:
-            return "H5T_NCLASSES";
+        // Bound the chunks visited per call, e.g. H5S_ALL over a huge grid
+        if(--(*budget) == 0){
+            dset_info->chunk_sampled = 1;
+            return;
+        }
+
+        // Next chunk in row-major order within the block's chunk range
+        int d = ndim - 1;
+        while(d >= 0 && cur[d] == last[d]){
+            cur[d] = first[d];
+            d--;
+        }
+        if(d < 0)
+            break;
+        cur[d]++;
     }
 }
 
-char* get_dataspace_class_str(H5S_class_t class_id) {
-    switch (class_id) {
-        case H5S_NO_CLASS:
-            return "H5S_NO_CLASS";
-        case H5S_SCALAR:
-            return "H5S_SCALAR";
-        case H5S_SIMPLE:
-            return "H5S_SIMPLE";
-        case H5S_NULL:
-            return "H5S_NULL";
-        default:
-            return "H5S_NO_CLASS";
+// Charge the chunks of the current call, in access order for the cache simulator
+static void dset_chunk_charge(dataset_tkr_info_t* dset_info, char op)
+{
+    for(size_t i = 0; i < dset_info->chunk_last_cnt; i++){
+        chunk_touch_t* touch = &dset_info->chunk_last[i];
+        if(op == 'r'){
+            touch->chunk->read_cnt++;
+            touch->chunk->read_bytes += touch->bytes;
+        } else {
+            touch->chunk->write_cnt++;
+            touch->chunk->write_bytes += touch->bytes;
+        }
+        dset_ccache_access(dset_info, touch->chunk->coords);
     }
 }
 
-void file_info_update(char * func_name, void * obj, hid_t fapl_id, hid_t fcpl_id, hid_t dxpl_id)
+// Map the file selection of one read or write onto chunks. A selection that
+// repeats the previous call replays its chunk list without touching the
+// selection again.
+void dset_chunk_record(H5VL_tracker_t* dset, dataset_tkr_info_t* dset_info, char op,
+    hid_t file_space_id, hid_t dxpl_id, int sel_repeat)
 {
-    unsigned long start = get_time_usec();
-    H5VL_tracker_t *file = (H5VL_tracker_t *)obj;
-    file_tkr_info_t * file_info = (file_tkr_info_t*)file->generic_tkr_info;
+    hsize_t blk_buf[TKR_SEL_BLOCK_BUF];
+    hsize_t lo[H5S_MAX_RANK];
+    hsize_t hi[H5S_MAX_RANK];
+    size_t type_size = dset_info->dset_type_size;
+    hsize_t budget = TKR_CHUNK_MAP_MAX;
+    int ndim;
+
+    if(dset_info->chunk_ndim == 0)
+        dset_chunk_init(dset, dset_info, dxpl_id);
+    if(dset_info->chunk_ndim < 0 || !type_size)
+        return;
+    ndim = dset_info->chunk_ndim;
 
-    // get file intent
-    if(!file_info->intent){
-        char * intent = file_get_intent(file->under_object, file->under_vol_id, dxpl_id);
-        file_info->intent = intent ? strdup(intent) : NULL;
+    if(sel_repeat && dset_info->chunk_last_cnt > 0){
+        dset_chunk_charge(dset_info, op);
+        return;
     }
-    
-    hsize_t file_size = file_get_size(file->under_object, file->under_vol_id, dxpl_id);
-    file_info->file_size = file_size;
 
-    if(file_info->fapl_id != NULL){
-        if(!file_info->header_size){
-            H5Pget_meta_block_size(file_info->fapl_id, &file_info->header_size);
-        }
+    dset_info->chunk_call++;
+    dset_info->chunk_last_cnt = 0;
 
-        if(!file_info->sieve_buf_size){
-            H5Pget_sieve_buf_size(file_info->fapl_id, &file_info->sieve_buf_size);
+    if(file_space_id > 0 && H5Iget_type(file_space_id) == H5I_DATASPACE
+            && H5Sget_simple_extent_ndims(file_space_id) == ndim){
+        H5S_sel_type sel_type = H5Sget_select_type(file_space_id);
+        hssize_t nblocks = 0;
+        int is_points = 0;
+
+        if(sel_type == H5S_SEL_HYPERSLABS)
+            nblocks = H5Sget_select_hyper_nblocks(file_space_id);
+        else if(sel_type == H5S_SEL_POINTS){
+            nblocks = H5Sget_select_elem_npoints(file_space_id);
+            is_points = 1;
         }
-        if(!file_info->alignment || !file_info->threshold){
-            if(H5Pget_alignment(file_info->fapl_id, &file_info->threshold, &file_info->alignment) < 0){
-                file_info->alignment = -1;
-                file_info->threshold = -1;
+        else if(sel_type == H5S_SEL_ALL){
+            H5Sget_simple_extent_dims(file_space_id, hi, NULL);
+            for(int d = 0; d < ndim; d++){
+                lo[d] = 0;
+                hi[d] = hi[d] ? hi[d] - 1 : 0;
+            }
+            dset_chunk_touch_block(dset_info, lo, hi, type_size, &budget);
+        }
+
+        if(nblocks > 0){
+            // Block lists are read in fixed pages, points are 1-element blocks
+            hsize_t coords_per = is_points ? ndim : 2 * ndim;
+            hsize_t page = TKR_SEL_BLOCK_BUF / coords_per;
+            hsize_t limit = (hsize_t)nblocks;
+            if(limit > TKR_CHUNK_SCAN_BLOCKS){
+                limit = TKR_CHUNK_SCAN_BLOCKS;
+                dset_info->chunk_sampled = 1;
+            }
+            for(hsize_t b = 0; b < limit && budget > 0; b += page){
+                hsize_t n = (limit - b) < page ? (limit - b) : page;
+                herr_t status = is_points
+                    ? H5Sget_select_elem_pointlist(file_space_id, b, n, blk_buf)
+                    : H5Sget_select_hyper_blocklist(file_space_id, b, n, blk_buf);
+                if(status < 0)
+                    break;
+                for(hsize_t i = 0; i < n && budget > 0; i++){
+                    const hsize_t* blk = blk_buf + i * coords_per;
+                    dset_chunk_touch_block(dset_info, blk, is_points ? blk : blk + ndim, type_size, &budget);
+                }
+            }
+        }
+    }
+    else if(dset_info->dimensions && (int)dset_info->dimension_cnt == ndim){
+        // H5S_ALL: the whole dataset extent
+        for(int d = 0; d < ndim; d++){
+            lo[d] = 0;
+            hi[d] = dset_info->dimensions[d] ? dset_info->dimensions[d] - 1 : 0;
+        }
+        dset_chunk_touch_block(dset_info, lo, hi, type_size, &budget);
+    }
+
+    dset_chunk_charge(dset_info, op);
+}
+
+// Move the touched chunks of a closing dataset handle onto its tracking
+// entry, summing chunks seen by earlier opens. Untouched index entries are freed.
+void dset_chunk_append(dset_track_t* track_info, dataset_tkr_info_t* dset_info)
+{
+    chunk_heat_t *chunk, *tmp;
+    int ndim = dset_info->chunk_ndim;
+
+    if(ndim > 0 && track_info->chunk_ndim == 0){
+        track_info->chunk_dims = (hsize_t*)malloc(sizeof(hsize_t) * ndim);
+        if(track_info->chunk_dims){
+            memcpy(track_info->chunk_dims, dset_info->chunk_dims, sizeof(hsize_t) * ndim);
+            track_info->chunk_ndim = ndim;
+        }
+    }
+
+    HASH_ITER(hh, dset_info->chunk_map, chunk, tmp) {
+        chunk_heat_t* found = NULL;
+        HASH_DEL(dset_info->chunk_map, chunk);
+
+        if(chunk->read_cnt == 0 && chunk->write_cnt == 0){
+            dset_chunk_release(chunk, ndim);
+            continue;
+        }
+        if(ndim != track_info->chunk_ndim){
+            dset_chunk_release(chunk, ndim);
+            continue;
+        }
+
+        HASH_FIND(hh, track_info->chunk_map, chunk->coords, sizeof(hsize_t) * ndim, found);
+        if(found){
+            found->read_cnt += chunk->read_cnt;
+            found->write_cnt += chunk->write_cnt;
+            found->read_bytes += chunk->read_bytes;
+            found->write_bytes += chunk->write_bytes;
+            if(chunk->addr != HADDR_UNDEF){
+                found->addr = chunk->addr;
+                found->stored_size = chunk->stored_size;
+            }
+            dset_chunk_release(chunk, ndim);
+        }
+        else if(track_info->chunk_map_cnt >= TKR_CHUNK_MAP_MAX){
+            track_info->chunk_dropped += chunk->read_cnt + chunk->write_cnt;
+            dset_chunk_release(chunk, ndim);
+        }
+        else {
+            HASH_ADD_KEYPTR(hh, track_info->chunk_map, chunk->coords, sizeof(hsize_t) * ndim, chunk);
+            track_info->chunk_map_cnt++;
+        }
+    }
+    track_info->chunk_dropped += dset_info->chunk_dropped;
+    track_info->chunk_sampled |= dset_info->chunk_sampled;
+
+    dset_info->chunk_map = NULL;
+    dset_info->chunk_map_cnt = 0;
+    dset_info->chunk_dropped = 0;
+    dset_info->chunk_last_cnt = 0;
+}
+
+typedef struct {
+    dataset_tkr_info_t* dset_info;
+    size_t found;                       // tracked chunks seen so far
+} chunk_resolve_t;
+
+static int dset_chunk_resolve_cb(const hsize_t* offset, unsigned filter_mask, haddr_t addr,
+    hsize_t size, void* op_data)
+{
+    chunk_resolve_t* rs = (chunk_resolve_t*)op_data;
+    dataset_tkr_info_t* dset_info = rs->dset_info;
+    int ndim = dset_info->chunk_ndim;
+    hsize_t coords[H5S_MAX_RANK];
+    chunk_heat_t* chunk = NULL;
+
+    (void)filter_mask;
+    for(int d = 0; d < ndim; d++)
+        coords[d] = offset[d] / dset_info->chunk_dims[d];
+    HASH_FIND(hh, dset_info->chunk_map, coords, sizeof(hsize_t) * ndim, chunk);
+    if(!chunk)
+        return H5_ITER_CONT;
+
+    // a filtered chunk moves when it is rewritten with a different size
+    if(chunk->addr != addr || chunk->stored_size != size){
+        chunk->addr = addr;
+        chunk->stored_size = size;
+        dset_amap_publish(dset_info, addr, size);
+    }
+    return ++rs->found == dset_info->chunk_map_cnt ? H5_ITER_STOP : H5_ITER_CONT;
+}
+
+// Addresses of the touched chunks from one walk of the chunk index. Called
+// at flush and before close, where the chunk cache is written out anyway;
+// a lookup per touch would flush it in the middle of the I/O measured.
+void dset_chunk_resolve(H5VL_tracker_t* dset, dataset_tkr_info_t* dset_info, hid_t dxpl_id)
+{
+    chunk_resolve_t rs;
+
+    if(dset_info->chunk_ndim <= 0 || dset_info->chunk_map_cnt == 0)
+        return;
+    rs.dset_info = dset_info;
+    rs.found = 0;
+    dataset_chunk_iter(dset->under_object, dset->under_vol_id, dxpl_id, dset_chunk_resolve_cb, &rs);
+}
+
+void dset_chunk_free(chunk_heat_t** map, int ndim)
+{
+    chunk_heat_t *chunk, *tmp;
+    HASH_ITER(hh, *map, chunk, tmp) {
+        HASH_DEL(*map, chunk);
+        dset_chunk_release(chunk, ndim);
+    }
+    *map = NULL;
+}
+
+static int dset_chunk_hotter(chunk_heat_t* a, chunk_heat_t* b)
+{
+    unsigned long a_cnt = a->read_cnt + a->write_cnt;
+    unsigned long b_cnt = b->read_cnt + b->write_cnt;
+    return (a_cnt < b_cnt) - (a_cnt > b_cnt);
+}
+
+// Hottest chunks first
+void dset_chunk_to_file(FILE * f, dset_track_t* track_info)
+{
+    chunk_heat_t* chunk;
+    int first = 1;
+
+    HASH_SORT(track_info->chunk_map, dset_chunk_hotter);
+    for(chunk = track_info->chunk_map; chunk != NULL; chunk = chunk->hh.next){
+        fprintf(f, "%s\n                    {\"coords\": ", first ? "" : ",");
+        dset_sel_dims_to_file(f, chunk->coords, track_info->chunk_ndim);
+        fprintf(f, ", \"addr\": %lld, \"stored_size\": %llu, \"read_cnt\": %lu, \"write_cnt\": %lu, "
+            "\"read_bytes\": %zu, \"write_bytes\": %zu}",
+            chunk->addr == HADDR_UNDEF ? -1LL : (long long)chunk->addr,
+            (unsigned long long)chunk->stored_size,
+            chunk->read_cnt, chunk->write_cnt,
+            chunk->read_bytes, chunk->write_bytes);
+        first = 0;
+    }
+    if(!first)
+        fprintf(f, "\n                ");
+}
+/* Chunk heat implementation end */
+
+
+/* Chunk cache simulator implementation start */
+static const size_t CCACHE_NSLOTS[TKR_CCACHE_NSLOTS_CNT] = {521, 2053, 8209}; // 521 is the HDF5 default
+static const size_t CCACHE_NBYTES[TKR_CCACHE_NBYTES_CNT] = {
+    1024 * 1024, 4 * 1024 * 1024, 16 * 1024 * 1024, 64 * 1024 * 1024 }; // 1 MiB is the HDF5 default
+static int CCACHE_ACTIVE_DSETS = 0;
+
+// Configs are ordered by nbytes then nslots, smallest first. Their slot
+// arrays wait for the first chunk access, opens that never touch a chunk
+// cost only the config table.
+void dset_ccache_init(dataset_tkr_info_t* dset_info)
+{
+    if(dset_info->chunk_ndim <= 0 || !dset_info->chunk_dims || !dset_info->dset_type_size)
+        return;
+    dset_info->ccache = (ccache_sim_t*)calloc(TKR_CCACHE_NCONF, sizeof(ccache_sim_t));
+    if(!dset_info->ccache)
+        return;
+
+    dset_info->chunk_bytes = dset_info->dset_type_size;
+    for(int d = 0; d < dset_info->chunk_ndim; d++)
+        dset_info->chunk_bytes *= dset_info->chunk_dims[d];
+
+    for(int b = 0; b < TKR_CCACHE_NBYTES_CNT; b++){
+        for(int s = 0; s < TKR_CCACHE_NSLOTS_CNT; s++){
+            ccache_sim_t* sim = &dset_info->ccache[b * TKR_CCACHE_NSLOTS_CNT + s];
+            sim->nslots = CCACHE_NSLOTS[s];
+            sim->nbytes = CCACHE_NBYTES[b];
+            sim->capacity = sim->nbytes / dset_info->chunk_bytes;
+            sim->lru_head = TKR_CCACHE_NIL;
+            sim->lru_tail = TKR_CCACHE_NIL;
+        }
+    }
+}
+
+// Allocate the slot arrays of every config, or stop simulating this open
+// when TKR_CCACHE_MAX_DSETS opens already hold theirs
+static int dset_ccache_pool(dataset_tkr_info_t* dset_info)
+{
+    size_t slots_total = 0;
+    uint64_t * keys;
+    uint32_t * links;
+
+    if(__sync_fetch_and_add(&CCACHE_ACTIVE_DSETS, 1) >= TKR_CCACHE_MAX_DSETS){
+        __sync_fetch_and_sub(&CCACHE_ACTIVE_DSETS, 1);
+        dset_ccache_free(dset_info);
+        return -1;
+    }
+    for(int c = 0; c < TKR_CCACHE_NCONF; c++)
+        slots_total += dset_info->ccache[c].nslots;
+    dset_info->ccache_pool = calloc(slots_total, sizeof(uint64_t) + 2 * sizeof(uint32_t));
+    if(!dset_info->ccache_pool){
+        __sync_fetch_and_sub(&CCACHE_ACTIVE_DSETS, 1);
+        dset_ccache_free(dset_info);
+        return -1;
+    }
+
+    keys = (uint64_t*)dset_info->ccache_pool;
+    links = (uint32_t*)(keys + slots_total);
+    for(int c = 0; c < TKR_CCACHE_NCONF; c++){
+        ccache_sim_t* sim = &dset_info->ccache[c];
+        sim->slot_key = keys;
+        sim->lru_prev = links;
+        sim->lru_next = links + sim->nslots;
+        keys += sim->nslots;
+        links += 2 * sim->nslots;
+    }
+    return 0;
+}
+
+void dset_ccache_free(dataset_tkr_info_t* dset_info)
+{
+    if(dset_info->ccache_pool){
+        free(dset_info->ccache_pool);
+        dset_info->ccache_pool = NULL;
+        __sync_fetch_and_sub(&CCACHE_ACTIVE_DSETS, 1);
+    }
+    free(dset_info->ccache);
+    dset_info->ccache = NULL;
+}
+
+static void ccache_lru_unlink(ccache_sim_t* sim, uint32_t slot)
+{
+    uint32_t prev = sim->lru_prev[slot];
+    uint32_t next = sim->lru_next[slot];
+
+    if(prev != TKR_CCACHE_NIL)
+        sim->lru_next[prev] = next;
+    else
+        sim->lru_head = next;
+    if(next != TKR_CCACHE_NIL)
+        sim->lru_prev[next] = prev;
+    else
+        sim->lru_tail = prev;
+}
+
+static void ccache_lru_push(ccache_sim_t* sim, uint32_t slot)
+{
+    sim->lru_prev[slot] = TKR_CCACHE_NIL;
+    sim->lru_next[slot] = sim->lru_head;
+    if(sim->lru_head != TKR_CCACHE_NIL)
+        sim->lru_prev[sim->lru_head] = slot;
+    else
+        sim->lru_tail = slot;
+    sim->lru_head = slot;
+}
+
+static void ccache_sim_access(ccache_sim_t* sim, uint64_t key, hsize_t index)
+{
+    uint32_t slot = (uint32_t)(index % sim->nslots);
+
+    if(sim->slot_key[slot] == key){
+        sim->hits++;
+        ccache_lru_unlink(sim, slot);
+        ccache_lru_push(sim, slot);
+        return;
+    }
+    if(sim->capacity == 0)
+        return; // chunk larger than the cache, never cached
+
+    if(sim->slot_key[slot]){
+        // hash collision evicts the occupant
+        ccache_lru_unlink(sim, slot);
+        sim->resident--;
+    }
+    while(sim->resident >= sim->capacity && sim->lru_tail != TKR_CCACHE_NIL){
+        uint32_t victim = sim->lru_tail;
+        ccache_lru_unlink(sim, victim);
+        sim->slot_key[victim] = 0;
+        sim->resident--;
+    }
+    sim->slot_key[slot] = key;
+    ccache_lru_push(sim, slot);
+    sim->resident++;
+}
+
+// Feed one chunk access to every simulated cache. The slot comes from the
+// linear chunk index over the current extent, which H5Dset_extent keeps up
+// to date; the key is a hash of all coordinates, so chunks that share an
+// index before and after an extent change stay apart.
+void dset_ccache_access(dataset_tkr_info_t* dset_info, const hsize_t* coords)
+{
+    int ndim = dset_info->chunk_ndim;
+    uint64_t key = 0x9e3779b97f4a7c15ull;
+    hsize_t index = 0;
+
+    if(!dset_info->ccache || (!dset_info->ccache_pool && dset_ccache_pool(dset_info) < 0))
+        return;
+    for(int d = 0; d < ndim; d++){
+        key = (key ^ coords[d]) * 0xff51afd7ed558ccdull;
+        key ^= key >> 33;
+    }
+    if(key == 0)
+        key = 1; // 0 marks an empty slot
+    if(dset_info->dimensions && (int)dset_info->dimension_cnt == ndim){
+        for(int d = 0; d < ndim; d++)
+            index = index * ((dset_info->dimensions[d] + dset_info->chunk_dims[d] - 1) / dset_info->chunk_dims[d]) + coords[d];
+    } else {
+        index = key;
+    }
+
+    dset_info->ccache_accesses++;
+    for(int c = 0; c < TKR_CCACHE_NCONF; c++)
+        ccache_sim_access(&dset_info->ccache[c], key, index);
+}
+
+void dset_ccache_append(dset_track_t* track_info, dataset_tkr_info_t* dset_info)
+{
+    if(!dset_info->ccache)
+        return;
+    for(int c = 0; c < TKR_CCACHE_NCONF; c++)
+        track_info->ccache_hits[c] += dset_info->ccache[c].hits;
+    track_info->ccache_accesses += dset_info->ccache_accesses;
+    track_info->chunk_bytes = dset_info->chunk_bytes;
+    for(int c = 0; c < TKR_CCACHE_NCONF; c++)
+        dset_info->ccache[c].hits = 0;
+    dset_info->ccache_accesses = 0;
+}
+
+// Smallest rdcc_nbytes, then rdcc_nslots, reaching the target hit rate,
+// or the best simulated config when none does.
+void dset_ccache_to_file(FILE * f, dset_track_t* track_info)
+{
+    const char* target_env = getenv("TRACKER_CCACHE_TARGET");
+    double target = TKR_CCACHE_TARGET_HIT;
+    int pick = -1, best = 0;
+
+    if(track_info->ccache_accesses == 0){
+        fprintf(f, "null");
+        return;
+    }
+    if(target_env && atof(target_env) > 0)
+        target = atof(target_env);
+
+    for(int c = 0; c < TKR_CCACHE_NCONF; c++){
+        if(track_info->ccache_hits[c] > track_info->ccache_hits[best])
+            best = c;
+        if(pick < 0 && (double)track_info->ccache_hits[c] / track_info->ccache_accesses >= target)
+            pick = c;
+    }
+
+    fprintf(f, "{\"rdcc_nbytes\": %zu, \"rdcc_nslots\": %zu, \"hit_rate\": %.4f, "
+        "\"target_hit_rate\": %.2f, \"target_met\": %s, \"default_hit_rate\": %.4f, "
+        "\"chunk_bytes\": %zu, \"chunk_accesses\": %lu}",
+        CCACHE_NBYTES[(pick < 0 ? best : pick) / TKR_CCACHE_NSLOTS_CNT],
+        CCACHE_NSLOTS[(pick < 0 ? best : pick) % TKR_CCACHE_NSLOTS_CNT],
+        (double)track_info->ccache_hits[pick < 0 ? best : pick] / track_info->ccache_accesses,
+        target,
+        pick < 0 ? "false" : "true",
+        (double)track_info->ccache_hits[0] / track_info->ccache_accesses,
+        track_info->chunk_bytes,
+        track_info->ccache_accesses);
+}
+/* Chunk cache simulator implementation end */
+
+/* Datatype conversion implementation start */
+static const char* TCONV_CLASS_STR[TKR_TCONV_NCLASS] = {"noop", "hard", "soft"};
+
+// Class of the conversion HDF5 applies between the memory type and the
+// dataset's file type, in the direction of the I/O
+static tkr_tconv_class_t dset_tconv_classify(H5VL_tracker_t* dset, dataset_tkr_info_t* dset_info,
+    char op, hid_t mem_type_id, hid_t dxpl_id)
+{
+    htri_t equal, hard;
+
+    if(dset_info->file_type_id <= 0)
+        dset_info->file_type_id = dataset_get_type(dset->under_object, dset->under_vol_id, dxpl_id);
+    if(dset_info->file_type_id < 0 || mem_type_id < 0)
+        return TKR_TCONV_NOOP;
+
+    equal = H5Tequal(mem_type_id, dset_info->file_type_id);
+    if(equal > 0)
+        return TKR_TCONV_NOOP;
+
+    H5E_BEGIN_TRY {
+        if(op == 'r')
+            hard = H5Tcompiler_conv(dset_info->file_type_id, mem_type_id);
+        else
+            hard = H5Tcompiler_conv(mem_type_id, dset_info->file_type_id);
+    } H5E_END_TRY;
+    return hard > 0 ? TKR_TCONV_HARD : TKR_TCONV_SOFT;
+}
+
+// Charge one read/write and its time in the native call to the conversion
+// class of its memory type. Classes are cached per memory type, so repeated
+// calls with the same type cost a short scan. Returns the bytes moved.
+size_t dset_tconv_record(H5VL_tracker_t* dset, dataset_tkr_info_t* dset_info, char op,
+    hid_t mem_type_id, hid_t dxpl_id, unsigned long io_time)
+{
+    tconv_cache_t* c = NULL;
+    int n = dset_info->tconv_cache_cnt < TKR_TCONV_CACHE ? dset_info->tconv_cache_cnt : TKR_TCONV_CACHE;
+
+    for(int i = 0; i < n; i++){
+        if(dset_info->tconv_cache[i].mem_type_id == mem_type_id && dset_info->tconv_cache[i].op == op){
+            c = &dset_info->tconv_cache[i];
+            break;
+        }
+    }
+    if(!c){
+        c = &dset_info->tconv_cache[dset_info->tconv_cache_cnt++ % TKR_TCONV_CACHE];
+        c->mem_type_id = mem_type_id;
+        c->op = op;
+        c->conv = dset_tconv_classify(dset, dset_info, op, mem_type_id, dxpl_id);
+        c->mem_type_size = mem_type_id > 0 ? H5Tget_size(mem_type_id) : dset_info->dset_type_size;
+    }
+
+    tconv_stat_t* stat = &dset_info->tconv[op == 'w'][c->conv];
+    size_t bytes = dset_info->sel_npoints > 0 ? (size_t)dset_info->sel_npoints * c->mem_type_size : 0;
+    stat->calls++;
+    stat->bytes += bytes;
+    stat->time += io_time;
+    return bytes;
+}
+
+// Share the time of one whole multi-dataset call among its datasets by
+// the bytes each selected, evenly when no selection size is known
+void dset_io_time_split(size_t count, void *dset[], hid_t mem_type_id[], hid_t mem_space_id[],
+    hid_t file_space_id[], unsigned long total, unsigned long io_time[])
+{
+    double bytes[count];
+    double sum = 0;
+
+    for(size_t u = 0; u < count; u++){
+        dataset_tkr_info_t* dset_info = (dataset_tkr_info_t*)((H5VL_tracker_t *)dset[u])->generic_tkr_info;
+        hid_t space_id = file_space_id[u] != H5S_ALL ? file_space_id[u] : mem_space_id[u];
+        hssize_t npoints = space_id != H5S_ALL ? H5Sget_select_npoints(space_id)
+            : (hssize_t)(dset_info ? dset_info->dset_n_elements : 0);
+        size_t type_size = mem_type_id[u] > 0 ? H5Tget_size(mem_type_id[u]) : 0;
+
+        bytes[u] = npoints > 0 ? (double)npoints * type_size : 0;
+        sum += bytes[u];
+    }
+    for(size_t u = 0; u < count; u++)
+        io_time[u] = sum > 0 ? (unsigned long)(total * (bytes[u] / sum)) : total / count;
+}
+
+void dset_tconv_append(dset_track_t* track_info, dataset_tkr_info_t* dset_info)
+{
+    for(int rw = 0; rw < 2; rw++){
+        for(int c = 0; c < TKR_TCONV_NCLASS; c++){
+            track_info->tconv[rw][c].calls += dset_info->tconv[rw][c].calls;
+            track_info->tconv[rw][c].bytes += dset_info->tconv[rw][c].bytes;
+            track_info->tconv[rw][c].time += dset_info->tconv[rw][c].time;
+        }
+    }
+    memset(dset_info->tconv, 0, sizeof(dset_info->tconv));
+}
+
+void dset_tconv_to_file(FILE * f, dset_track_t* track_info)
+{
+    fprintf(f, "{");
+    for(int rw = 0; rw < 2; rw++){
+        fprintf(f, "%s\"%s\": {", rw ? ", " : "", rw ? "write" : "read");
+        for(int c = 0; c < TKR_TCONV_NCLASS; c++){
+            tconv_stat_t* stat = &track_info->tconv[rw][c];
+            fprintf(f, "%s\"%s\": {\"calls\": %lu, \"bytes\": %zu, \"time(us)\": %lu}",
+                c ? ", " : "", TCONV_CLASS_STR[c], stat->calls, stat->bytes, stat->time);
+        }
+        fprintf(f, "}");
+    }
+    fprintf(f, "}");
+}
+/* Datatype conversion implementation end */
+
+/* Vlen and blob implementation start */
+// Charge one blob put/get to the dataset whose read/write is running on
+// this thread, or to the file when there is none
+void dset_blob_record(file_tkr_info_t* file_info, char op, size_t size, unsigned long blob_time)
+{
+    dataset_tkr_info_t* dset_info = DSET_CTX_DSET;
+
+    if(dset_info){
+        if(op == 'w'){
+            dset_info->blob_put_cnt++;
+            dset_info->total_bytes_blob_put += size;
+            dset_info->total_blob_put_time += blob_time;
+        }
+        else {
+            dset_info->blob_get_cnt++;
+            dset_info->total_bytes_blob_get += size;
+            dset_info->total_blob_get_time += blob_time;
+            dset_info->vlen_call_bytes += size;
+        }
+    }
+    else if(file_info){
+        if(op == 'w'){
+            file_info->blob_put_cnt++;
+            file_info->blob_put_bytes += size;
+        }
+        else {
+            file_info->blob_get_cnt++;
+            file_info->blob_get_bytes += size;
+        }
+    }
+}
+
+typedef struct {
+    int is_str;
+    size_t base_size;
+    size_t bytes;
+} vlen_buf_walk_t;
+
+static herr_t dset_vlen_buf_walk(void* elem, hid_t type_id, unsigned ndim, const hsize_t* point, void* op_data)
+{
+    vlen_buf_walk_t* walk = (vlen_buf_walk_t*)op_data;
+
+    if(walk->is_str){
+        const char* str = *(const char**)elem;
+        if(str)
+            walk->bytes += strlen(str) + 1;
+    }
+    else
+        walk->bytes += ((const hvl_t*)elem)->len * walk->base_size;
+    return 0;
+}
+
+// Vlen data the read left in buf, summed over the memory selection. Only a
+// vlen or variable-length string memory type is walked, vlen members of a
+// compound are not.
+static size_t dset_vlen_buf_bytes(H5VL_tracker_t* dset, hid_t mem_type_id, hid_t mem_space_id,
+    hid_t file_space_id, hid_t dxpl_id, const void* buf)
+{
+    vlen_buf_walk_t walk = {0, 0, 0};
+    hid_t space_id = mem_space_id != H5S_ALL ? mem_space_id : file_space_id;
+    hid_t dset_space_id = H5I_INVALID_HID;
+
+    if(!buf)
+        return 0;
+    if(H5Tis_variable_str(mem_type_id) > 0){
+        walk.is_str = 1;
+    }
+    else if(H5Tget_class(mem_type_id) == H5T_VLEN){
+        hid_t base_id = H5Tget_super(mem_type_id);
+        if(base_id < 0)
+            return 0;
+        walk.base_size = H5Tget_size(base_id);
+        H5Tclose(base_id);
+    }
+    else
+        return 0;
+
+    if(space_id == H5S_ALL){
+        dset_space_id = dataset_get_space(dset->under_object, dset->under_vol_id, dxpl_id);
+        if(dset_space_id < 0)
+            return 0;
+        space_id = dset_space_id;
+    }
+    H5Diterate((void*)buf, mem_type_id, space_id, dset_vlen_buf_walk, &walk);
+    if(dset_space_id >= 0)
+        H5Sclose(dset_space_id);
+    return walk.bytes;
+}
+
+// Close the vlen buffer tally of one read. Blob gets of the read give its
+// size; a vlen read with none (e.g. a connector below that does not issue
+// blob callbacks, or a whole multi-dataset call) is sized from the memory
+// buffer, which costs no I/O.
+void dset_vlen_read_end(H5VL_tracker_t* dset, dataset_tkr_info_t* dset_info,
+    hid_t mem_type_id, hid_t mem_space_id, hid_t file_space_id, hid_t dxpl_id, const void* buf)
+{
+    size_t bytes = dset_info->vlen_call_bytes;
+
+    if(bytes == 0 && mem_type_id > 0
+        && (H5Tdetect_class(mem_type_id, H5T_VLEN) > 0 || H5Tis_variable_str(mem_type_id) > 0))
+        bytes = dset_vlen_buf_bytes(dset, mem_type_id, mem_space_id, file_space_id, dxpl_id, buf);
+    if(bytes == 0)
+        return;
+
+    dset_info->vlen_reads++;
+    dset_info->vlen_read_bytes += bytes;
+    if(bytes > dset_info->vlen_read_max)
+        dset_info->vlen_read_max = bytes;
+    dset_info->vlen_call_bytes = 0;
+}
+
+void dset_blob_append(dset_track_t* track_info, dataset_tkr_info_t* dset_info)
+{
+    track_info->blob_put_cnt += dset_info->blob_put_cnt;
+    track_info->blob_put_bytes += dset_info->total_bytes_blob_put;
+    track_info->blob_put_time += dset_info->total_blob_put_time;
+    track_info->blob_get_cnt += dset_info->blob_get_cnt;
+    track_info->blob_get_bytes += dset_info->total_bytes_blob_get;
+    track_info->blob_get_time += dset_info->total_blob_get_time;
+    track_info->vlen_reads += dset_info->vlen_reads;
+    track_info->vlen_read_bytes += dset_info->vlen_read_bytes;
+    if(dset_info->vlen_read_max > track_info->vlen_read_max)
+        track_info->vlen_read_max = dset_info->vlen_read_max;
+
+    dset_info->blob_put_cnt = 0;
+    dset_info->total_bytes_blob_put = 0;
+    dset_info->total_blob_put_time = 0;
+    dset_info->blob_get_cnt = 0;
+    dset_info->total_bytes_blob_get = 0;
+    dset_info->total_blob_get_time = 0;
+    dset_info->vlen_reads = 0;
+    dset_info->vlen_read_bytes = 0;
+    dset_info->vlen_read_max = 0;
+}
+
+// Blob counts and sizes of a vlen dataset, null for fixed-size data
+void dset_blob_to_file(FILE * f, dset_track_t* track_info)
+{
+    if(track_info->blob_put_cnt == 0 && track_info->blob_get_cnt == 0 && track_info->vlen_reads == 0){
+        fprintf(f, "null");
+        return;
+    }
+    fprintf(f, "{\"blob_put_cnt\": %lu, \"blob_put_bytes\": %zu, \"blob_put_time(us)\": %lu, ",
+        track_info->blob_put_cnt, track_info->blob_put_bytes, track_info->blob_put_time);
+    fprintf(f, "\"blob_get_cnt\": %lu, \"blob_get_bytes\": %zu, \"blob_get_time(us)\": %lu, ",
+        track_info->blob_get_cnt, track_info->blob_get_bytes, track_info->blob_get_time);
+    fprintf(f, "\"avg_blob_bytes\": %.1f, ",
+        (double)(track_info->blob_put_bytes + track_info->blob_get_bytes)
+            / (track_info->blob_put_cnt + track_info->blob_get_cnt ? track_info->blob_put_cnt + track_info->blob_get_cnt : 1));
+    fprintf(f, "\"vlen_reads\": %lu, \"vlen_read_bytes\": %zu, \"vlen_read_max\": %zu}",
+        track_info->vlen_reads, track_info->vlen_read_bytes, track_info->vlen_read_max);
+}
+/* Vlen and blob implementation end */
+
+/* Async request implementation start */
+// Move the in-flight count to now, charging the time since the last
+// change to the previous count. Called with TKR_REQ_MUTEX held.
+static void tkr_req_level_change(unsigned long now, int delta)
+{
+    if(TKR_REQ_LEVEL_SINCE && now > TKR_REQ_LEVEL_SINCE)
+        TKR_REQ_LEVEL_TIME[TKR_REQ_INFLIGHT < TKR_REQ_LEVELS ? TKR_REQ_INFLIGHT : TKR_REQ_LEVELS - 1]
+            += now - TKR_REQ_LEVEL_SINCE;
+    TKR_REQ_LEVEL_SINCE = now;
+    if(delta > 0)
+        TKR_REQ_INFLIGHT++;
+    else if(delta < 0 && TKR_REQ_INFLIGHT > 0)
+        TKR_REQ_INFLIGHT--;
+    if(TKR_REQ_INFLIGHT > TKR_REQ_INFLIGHT_MAX)
+        TKR_REQ_INFLIGHT_MAX = TKR_REQ_INFLIGHT;
+}
+
+// Stamp a dataset read/write request returned by the connector below
+void tkr_req_submit(H5VL_tracker_t* req, dataset_tkr_info_t* dset_info, char op, unsigned long submit_time)
+{
+    tkr_req_info_t* info;
+
+    if(!req || !dset_info)
+        return;
+    info = (tkr_req_info_t*)calloc(1, sizeof(tkr_req_info_t));
+    if(!info){
+        fprintf(stderr, "tkr_req_submit(): failed to allocate request info\n");
+        return;
+    }
+    info->dset_info = dset_info;
+    info->op = op;
+    info->submit_time = submit_time;
+
+    pthread_mutex_lock(&TKR_REQ_MUTEX);
+    info->next = dset_info->req_inflight;
+    if(info->next)
+        info->next->prev = info;
+    dset_info->req_inflight = info;
+    dset_info->req.submitted++;
+    TKR_REQ_ALL.submitted++;
+    tkr_req_level_change(get_time_usec(), 1);
+    pthread_mutex_unlock(&TKR_REQ_MUTEX);
+
+    req->generic_tkr_info = info;
+}
+
+static void tkr_req_stat_add(tkr_req_stat_t* stat, unsigned long latency, unsigned long queue,
+    int has_queue, unsigned long wait)
+{
+    stat->completed++;
+    stat->latency += latency;
+    if(latency > stat->latency_max)
+        stat->latency_max = latency;
+    if(has_queue){
+        stat->queue += queue;
+        stat->queue_cnt++;
+    }
+    stat->wait += wait;
+}
+
+// Unlink a request from its dataset and the in-flight count, then free it.
+// exec_ts is when the connector started executing it, 0 if unknown;
+// complete is 0 for a request released without a completion.
+static void tkr_req_finish(tkr_req_info_t* info, unsigned long exec_ts, int complete)
+{
+    unsigned long now = get_time_usec();
+    unsigned long latency = now > info->submit_time ? now - info->submit_time : 0;
+    int has_queue = exec_ts >= info->submit_time && exec_ts <= now;
+    unsigned long queue = has_queue ? exec_ts - info->submit_time : 0;
+
+    pthread_mutex_lock(&TKR_REQ_MUTEX);
+    if(complete){
+        tkr_req_stat_add(&TKR_REQ_ALL, latency, queue, has_queue, info->wait_time);
+        if(info->dset_info)
+            tkr_req_stat_add(&info->dset_info->req, latency, queue, has_queue, info->wait_time);
+    }
+    else {
+        TKR_REQ_ALL.released++;
+        if(info->dset_info)
+            info->dset_info->req.released++;
+    }
+    if(info->prev)
+        info->prev->next = info->next;
+    else if(info->dset_info)
+        info->dset_info->req_inflight = info->next;
+    if(info->next)
+        info->next->prev = info->prev;
+    tkr_req_level_change(now, -1);
+    pthread_mutex_unlock(&TKR_REQ_MUTEX);
+
+    free(info);
+}
+
+// Account a request_wait; once the request is done, ask the connector
+// below when execution started (e.g. the async VOL) to split out the
+// queueing delay
+void tkr_req_wait(H5VL_tracker_t* req, unsigned long wait_time, H5VL_request_status_t status)
+{
+    tkr_req_info_t* info = (tkr_req_info_t*)req->generic_tkr_info;
+    H5VL_request_specific_args_t args;
+    uint64_t exec_ts = 0, exec_time = 0;
+    herr_t ret;
+
+    if(!info)
+        return;
+    info->wait_time += wait_time;
+    if(status == H5VL_REQUEST_STATUS_IN_PROGRESS)
+        return;
+
+    if(status == H5VL_REQUEST_STATUS_SUCCEED){
+        args.op_type = H5VL_REQUEST_GET_EXEC_TIME;
+        args.args.get_exec_time.exec_ts = &exec_ts;
+        args.args.get_exec_time.exec_time = &exec_time;
+        H5E_BEGIN_TRY {
+            ret = H5VLrequest_specific(req->under_object, req->under_vol_id, &args);
+        } H5E_END_TRY;
+        if(ret < 0)
+            exec_ts = 0;
+    }
+    req->generic_tkr_info = NULL;
+    tkr_req_finish(info, (unsigned long)exec_ts, status != H5VL_REQUEST_STATUS_CANCELED);
+}
+
+// Completion callback registered in place of the application's through
+// request_notify; chains to the application callback
+herr_t tkr_req_notify_cb(void* ctx, H5VL_request_status_t status)
+{
+    tkr_req_info_t* info = (tkr_req_info_t*)ctx;
+    H5VL_request_notify_t user_cb = info->user_cb;
+    void* user_ctx = info->user_ctx;
+
+    tkr_req_finish(info, 0, status != H5VL_REQUEST_STATUS_CANCELED);
+    return user_cb ? user_cb(user_ctx, status) : 0;
+}
+
+// request_free or a cancel of a request still being tracked
+void tkr_req_release(H5VL_tracker_t* req)
+{
+    tkr_req_info_t* info = (tkr_req_info_t*)req->generic_tkr_info;
+
+    if(!info)
+        return;
+    req->generic_tkr_info = NULL;
+    tkr_req_finish(info, 0, 0);
+}
+
+// The dataset is closing with requests in flight: they still count in
+// the task totals when they complete, but no longer in the dataset's
+void tkr_req_detach(dataset_tkr_info_t* dset_info)
+{
+    pthread_mutex_lock(&TKR_REQ_MUTEX);
+    for(tkr_req_info_t* info = dset_info->req_inflight; info; info = info->next)
+        info->dset_info = NULL;
+    dset_info->req_inflight = NULL;
+    pthread_mutex_unlock(&TKR_REQ_MUTEX);
+}
+
+void dset_req_append(dset_track_t* track_info, dataset_tkr_info_t* dset_info)
+{
+    pthread_mutex_lock(&TKR_REQ_MUTEX);
+    track_info->req.submitted += dset_info->req.submitted;
+    track_info->req.completed += dset_info->req.completed;
+    track_info->req.released += dset_info->req.released;
+    track_info->req.latency += dset_info->req.latency;
+    if(dset_info->req.latency_max > track_info->req.latency_max)
+        track_info->req.latency_max = dset_info->req.latency_max;
+    track_info->req.queue += dset_info->req.queue;
+    track_info->req.queue_cnt += dset_info->req.queue_cnt;
+    track_info->req.wait += dset_info->req.wait;
+    memset(&dset_info->req, 0, sizeof(tkr_req_stat_t));
+    pthread_mutex_unlock(&TKR_REQ_MUTEX);
+}
+
+// Request latencies and how much of them the application overlapped with
+// other work (1 - blocked in wait / latency); null without async I/O
+void dset_req_to_file(FILE * f, tkr_req_stat_t* stat)
+{
+    double overlap;
+
+    if(stat->submitted == 0){
+        fprintf(f, "null");
+        return;
+    }
+    fprintf(f, "{\"submitted\": %lu, \"completed\": %lu, \"released\": %lu, ",
+        stat->submitted, stat->completed, stat->released);
+    if(stat->completed == 0){
+        fprintf(f, "\"latency_avg(us)\": null, \"latency_max(us)\": null, \"queue_avg(us)\": null, "
+            "\"wait(us)\": %lu, \"overlap_ratio\": null}", stat->wait);
+        return;
+    }
+    overlap = stat->latency ? 1.0 - (double)stat->wait / stat->latency : 0.0;
+    fprintf(f, "\"latency_avg(us)\": %.1f, \"latency_max(us)\": %lu, ",
+        (double)stat->latency / stat->completed, stat->latency_max);
+    if(stat->queue_cnt)
+        fprintf(f, "\"queue_avg(us)\": %.1f, ", (double)stat->queue / stat->queue_cnt);
+    else
+        fprintf(f, "\"queue_avg(us)\": null, ");
+    fprintf(f, "\"wait(us)\": %lu, \"overlap_ratio\": %.3f}", stat->wait, overlap < 0 ? 0.0 : overlap);
+}
+
+// Task-wide request totals and the in-flight count over time, only when
+// the task issued async dataset I/O
+void tkr_req_log(dayu_sink_t* sink)
+{
+    char* rec = NULL;
+    size_t rec_len = 0;
+    unsigned long span = 0, weighted = 0;
+    int top = 0;
+    FILE* f;
+
+    pthread_mutex_lock(&TKR_REQ_MUTEX);
+    if(TKR_REQ_ALL.submitted == 0){
+        pthread_mutex_unlock(&TKR_REQ_MUTEX);
+        return;
+    }
+    tkr_req_level_change(get_time_usec(), 0);
+    for(int l = 0; l < TKR_REQ_LEVELS; l++){
+        span += TKR_REQ_LEVEL_TIME[l];
+        weighted += TKR_REQ_LEVEL_TIME[l] * l;
+        if(TKR_REQ_LEVEL_TIME[l])
+            top = l;
+    }
+
+    f = open_memstream(&rec, &rec_len);
+    fprintf(f, "{\n    \"Async-Requests\": {\n        \"requests\": ");
+    dset_req_to_file(f, &TKR_REQ_ALL);
+    fprintf(f, ",\n        \"inflight_max\": %lu,\n        \"inflight_avg\": %.2f,\n",
+        TKR_REQ_INFLIGHT_MAX, span ? (double)weighted / span : 0.0);
+    fprintf(f, "        \"inflight_time(us)\": [");
+    for(int l = 0; l <= top; l++)
+        fprintf(f, "%s%lu", l ? ", " : "", TKR_REQ_LEVEL_TIME[l]);
+    fprintf(f, "]\n    }\n}");
+    pthread_mutex_unlock(&TKR_REQ_MUTEX);
+    dayu_sink_record_end(sink, f, &rec, &rec_len);
+}
+/* Async request implementation end */
+
+/* Address map implementation start */
+// Publish one raw data extent of the dataset to the core registry, where the
+// VFD looks it up by address. The name has the same form as the context
+// string (no leading '/').
+void dset_amap_publish(dataset_tkr_info_t* dset_info, haddr_t addr, hsize_t size)
+{
+    const char* name = dset_info->obj_info.name;
+
+    if(addr == HADDR_UNDEF || size == 0 || size == (hsize_t)-1 || !dset_info->pfile_name || !name)
+        return;
+    if(name[0] == '/')
+        name++;
+
+    dayu_dset_extent_add(dset_info->pfile_name, (uint64_t)addr, (uint64_t)size, name);
+}
+
+// Contiguous storage is allocated by the first write (or already exists on
+// read), so its extent is published once after a read/write. Chunk extents
+// are published when dset_chunk_resolve() finds their addresses.
+void dset_amap_record(H5VL_tracker_t* dset, dataset_tkr_info_t* dset_info, hid_t dxpl_id)
+{
+    haddr_t addr;
+
+    if(dset_info->amap_contig_done || !dset_info->layout || strcmp(dset_info->layout, "H5D_CONTIGUOUS") != 0)
+        return;
+    addr = dataset_get_offset(dset->under_object, dset->under_vol_id, dxpl_id);
+    if(addr == HADDR_UNDEF)
+        return;
+    dset_amap_publish(dset_info, addr, dataset_get_storage_size(dset->under_object, dset->under_vol_id, dxpl_id));
+    dset_info->amap_contig_done = 1;
+}
+
+/* Address map implementation end */
+
+
+
+char* get_datatype_class_str(hid_t type_id) {
+    switch (type_id) {
+        case H5T_NO_CLASS:
+            return "H5T_NO_CLASS";
+        case H5T_INTEGER:
+            return "H5T_INTEGER";
+        case H5T_FLOAT:
+            return "H5T_FLOAT";
+        case H5T_TIME:
+            return "H5T_TIME";
+        case H5T_STRING:
+            return "H5T_STRING";
+        case H5T_BITFIELD:
+            return "H5T_BITFIELD";
+        case H5T_OPAQUE:
+            return "H5T_OPAQUE";
+        case H5T_COMPOUND:
+            return "H5T_COMPOUND";
+        case H5T_REFERENCE:
+            return "H5T_REFERENCE";
+        case H5T_ENUM:
+            return "H5T_ENUM";
+        case H5T_VLEN:
+            return "H5T_VLEN";
+        case H5T_ARRAY:
+            return "H5T_ARRAY";
+        default:
+            return "H5T_NCLASSES";
+    }
+}
+
+char* get_dataspace_class_str(H5S_class_t class_id) {
+    switch (class_id) {
+        case H5S_NO_CLASS:
+            return "H5S_NO_CLASS";
+        case H5S_SCALAR:
+            return "H5S_SCALAR";
+        case H5S_SIMPLE:
+            return "H5S_SIMPLE";
+        case H5S_NULL:
+            return "H5S_NULL";
+        default:
+            return "H5S_NO_CLASS";
+    }
+}
+
+void file_info_update(char * func_name, void * obj, hid_t fapl_id, hid_t fcpl_id, hid_t dxpl_id)
+{
+    unsigned long start = get_time_usec();
+    H5VL_tracker_t *file = (H5VL_tracker_t *)obj;
+    file_tkr_info_t * file_info = (file_tkr_info_t*)file->generic_tkr_info;
+
+    // get file intent
+    if(!file_info->intent){
+        char * intent = file_get_intent(file->under_object, file->under_vol_id, dxpl_id);
+        file_info->intent = intent ? strdup(intent) : NULL;
+    }
+    
+    hsize_t file_size = file_get_size(file->under_object, file->under_vol_id, dxpl_id);
+    file_info->file_size = file_size;
+
+    if(file_info->fapl_id != NULL){
+        if(!file_info->header_size){
+            H5Pget_meta_block_size(file_info->fapl_id, &file_info->header_size);
+        }
+
+        if(!file_info->sieve_buf_size){
+            H5Pget_sieve_buf_size(file_info->fapl_id, &file_info->sieve_buf_size);
+        }
+        if(!file_info->alignment || !file_info->threshold){
+            if(H5Pget_alignment(file_info->fapl_id, &file_info->threshold, &file_info->alignment) < 0){
+                file_info->alignment = -1;
+                file_info->threshold = -1;
             }
         }
     }
@@ -2739,7 +3777,7 @@ void file_info_update(char * func_name, void * obj, hid_t fapl_id, hid_t fcpl_id
 #ifdef DEBUG_TKR_VOL
     file_info_print(func_name, obj, fapl_id, fcpl_id, dxpl_id);
 #endif
-    FILE_INFO_UPDATE_TIME+= (get_time_usec() - start);
+    TKR_ADD(FILE_INFO_UPDATE_TIME, (get_time_usec() - start));
 }
 
 void file_info_print(char * func_name, void * obj, hid_t fapl_id, hid_t fcpl_id, hid_t dxpl_id)
@@ -2901,6 +3939,8 @@ char * H5S_select_type_to_str(H5S_sel_type type){
     {
     case H5S_SEL_NONE:
         return "H5S_SEL_NONE";
+    case H5S_SEL_POINTS:
+        return "H5S_SEL_POINTS";
     case H5S_SEL_HYPERSLABS:
         return "H5S_SEL_HYPERSLABS";
     case H5S_SEL_ALL:
@@ -2939,7 +3979,8 @@ void dataset_info_update(char * func_name, hid_t mem_type_id, hid_t mem_space_id
     dataset_tkr_info_t * dset_info = (dataset_tkr_info_t*)dset->generic_tkr_info;
 
     // When dtype is vlen
-    if(!dset_info->dspace_id)
+    // dataspace is only needed for extent/selection not loaded from the property cache
+    if(!dset_info->dspace_id && (!dset_info->dimension_cnt || !dset_info->dset_select_type))
         dset_info->dspace_id = dataset_get_space(dset->under_object, dset->under_vol_id, dxpl_id);
 
     hid_t space_id = dset_info->dspace_id;
@@ -3026,7 +4067,55 @@ void dataset_info_update(char * func_name, hid_t mem_type_id, hid_t mem_space_id
     // dataset_info_print(func_name, mem_type_id, mem_space_id, file_space_id, obj, dxpl_id);
     printf("TRACKER VOL INT : dataset_info_update: %s END\n", func_name);
 #endif
-    DSET_INFO_UPDATE_TIME+= (get_time_usec() - start);
+    TKR_ADD(DSET_INFO_UPDATE_TIME, (get_time_usec() - start));
+}
+
+/* 
+* This function queries the under VOL for the dataset properties only once per
+* dataset_tkr_info_t, called on first read/write or at close time.
+* Updates dt_class, dset_type_size and everything in dataset_info_update.
+*/
+void dataset_info_capture(char * func_name, void * obj, hid_t dxpl_id)
+{
+    H5VL_tracker_t *dset = (H5VL_tracker_t *)obj;
+    dataset_tkr_info_t * dset_info = (dataset_tkr_info_t*)dset->generic_tkr_info;
+
+    if(dset_info->meta_captured)
+        return;
+
+    unsigned long start = get_time_usec();
+#ifdef DEBUG_TKR_VOL
+    printf("TRACKER VOL INT : dataset_info_capture: %s\n", func_name);
+#endif
+
+    // Reopened dataset, reuse properties from the per-file cache
+    file_tkr_info_t * file_info = dset_info->obj_info.file_info;
+    DsetPropCacheEntry * entry = NULL;
+    if(file_info)
+        entry = dset_prop_cache_find(file_info, &dset_info->obj_info.token);
+
+    if(entry){
+        TKR_ADD(DSET_PROP_CACHE_HIT, 1);
+        if(dset_prop_cache_load(entry, dset_info)){
+            dset_info->meta_captured = 1;
+            TKR_ADD(DSET_INFO_UPDATE_TIME, (get_time_usec() - start));
+            return;
+        }
+        // stale extent or storage, only those are queried below
+    } else {
+        TKR_ADD(DSET_PROP_CACHE_MISS, 1);
+        hid_t dt_id = dataset_get_type(dset->under_object, dset->under_vol_id, dxpl_id);
+        dset_info->dt_class = H5Tget_class(dt_id);
+        dset_info->dset_type_size = H5Tget_size(dt_id);
+        H5Tclose(dt_id);
+    }
+    TKR_ADD(DSET_INFO_UPDATE_TIME, (get_time_usec() - start));
+
+    dataset_info_update(func_name, NULL, NULL, NULL, obj, dxpl_id);
+    dset_info->meta_captured = 1;
+
+    if(file_info)
+        dset_prop_cache_store(file_info, dset_info);
 }
 
 void dataset_info_print(char * func_name, hid_t mem_type_id, hid_t mem_space_id,
@@ -3560,12 +4649,15 @@ dset_track_t *create_dset_track_info(dataset_tkr_info_t* dset_info) {
 
         track_entry->pfile_sorder_id = dset_info->pfile_sorder_id;
 
-        track_entry->sorder_ids = NULL;
-        track_entry->sorder_ids_end = NULL;
-
-        myll_add(&(track_entry->sorder_ids), &(track_entry->sorder_ids_end), dset_info->sorder_id);
+        idset_add(&(track_entry->sorder_ids), dset_info->sorder_id);
         track_entry->dset_select_type = strdup(dset_info->dset_select_type);
         track_entry->dset_select_npoints = dset_info->dset_select_npoints;
+        dset_sel_append(track_entry, dset_info);
+        dset_chunk_append(track_entry, dset_info);
+        dset_ccache_append(track_entry, dset_info);
+        dset_tconv_append(track_entry, dset_info);
+        dset_blob_append(track_entry, dset_info);
+        dset_req_append(track_entry, dset_info);
 
         // TODO: improve add task name
         char *curr_task = NULL;
@@ -3596,6 +4688,9 @@ dset_track_t *create_dset_track_info(dataset_tkr_info_t* dset_info) {
     return track_entry;
 }
 
+// Bytes charged to the memory budget per dataset table entry
+#define TKR_DSET_ENTRY_BYTES (sizeof(DsetTrackHashEntry) + sizeof(dset_track_t))
+
 // Cleanup the hash table (using uthash)
 void cleanup_hash_table() {
     
@@ -3604,7 +4699,9 @@ void cleanup_hash_table() {
     // Iterate over the hash table and delete each entry using uthash macros
     HASH_ITER(hh, lock.hash_table, current, tmp) {
         HASH_DEL(lock.hash_table, current);
+        free(current->key);
         free(current);
+        dayu_mem_charge(-(long)TKR_DSET_ENTRY_BYTES);
     }
 
     // Set the hash table pointer to NULL
@@ -3631,11 +4728,11 @@ void destroy_hash_lock() {
     // Destroy the mutex
     pthread_mutex_destroy(&(lock.mutex));
 
-    FILE_DSET_HT_RM_TIME+= (get_time_usec() - start);
-    FILE_DSET_HT_TOTAL_TIME += (get_time_usec() - start);
+    TKR_ADD(FILE_DSET_HT_RM_TIME, (get_time_usec() - start));
+    TKR_ADD(FILE_DSET_HT_TOTAL_TIME, (get_time_usec() - start));
 }
 
-// Add a dset_track_t object to the hash table
+// Add a dset_track_t object to the hash table, the entry takes over key
 void add_dset_track_info(char * key, dset_track_t *dset_track_info, dataset_tkr_info_t* dset_info) {
     DsetTrackHashEntry *entry = (DsetTrackHashEntry *)malloc(sizeof(DsetTrackHashEntry));
     if (entry) {
@@ -3652,9 +4749,10 @@ void add_dset_track_info(char * key, dset_track_t *dset_track_info, dataset_tkr_
 
         // Release the lock
         pthread_mutex_unlock(&(lock.mutex));
+        dayu_mem_charge(TKR_DSET_ENTRY_BYTES);
 
         // only record when it is first accessed, since we already recording read_cnt, write_cnt
-        myll_add(&(entry->dset_track_info->sorder_ids), &(entry->dset_track_info->sorder_ids_end), dset_info->sorder_id);
+        idset_add(&(entry->dset_track_info->sorder_ids), dset_info->sorder_id);
     }
 }
 
@@ -3677,7 +4775,9 @@ void remove_dset_track_info(char * key) {
 
         // Free the memory of the dset_track_t object
         free_dset_track_info(entry->dset_track_info);
+        free(entry->key);
         free(entry);
+        dayu_mem_charge(-(long)TKR_DSET_ENTRY_BYTES);
     }
 
     // Release the lock
@@ -3685,22 +4785,31 @@ void remove_dset_track_info(char * key) {
 }
 
 
-void log_dset_ht_json(FILE* f) {
+// delta_seq > 0 marks the records as the delta of that flush and releases
+// every entry once written. Records are built under the table lock and
+// handed to the sink after it is released.
+void log_dset_ht_json(dayu_sink_t* sink, unsigned long delta_seq) {
 
     DsetTrackHashEntry* entry = NULL;
+    DsetTrackHashEntry* tmp = NULL;
+    char* rec = NULL;
+    size_t rec_len = 0;
+    char** recs = NULL;
+    size_t* rec_lens = NULL;
+    size_t rec_cnt = 0, rec_cap = 0;
 
     // Acquire the lock before accessing the hash table
     pthread_mutex_lock(&(lock.mutex));
 
     // Traverse the hash table and print the token number and key of each entry
-    for (entry = lock.hash_table; entry != NULL; entry = entry->hh.next) {
+    HASH_ITER(hh, lock.hash_table, entry, tmp) {
         if(entry->logged == 0) {
             char* file_name = NULL;
             char* dset_name = NULL;
             decode_two_strings(entry->key, &file_name, &dset_name);
             dset_track_t* dset_track_info = entry->dset_track_info;
 
-
+            FILE* f = open_memstream(&rec, &rec_len);
             fprintf(f, "{\n");
             fprintf(f, "    \"file-%ld\": {\n", dset_track_info->pfile_sorder_id);
             fprintf(f, "        \"file_name\": \"/%s\",\n", file_name);
@@ -3709,6 +4818,8 @@ void log_dset_ht_json(FILE* f) {
             fprintf(f, "        \"datasets\": [\n");
             fprintf(f, "            {\n");
             fprintf(f, "                \"dset_name\": \"%s\",\n", dset_name);
+            if(delta_seq > 0)
+                fprintf(f, "                \"delta_seq\": %lu,\n", delta_seq);
             fprintf(f, "                \"start_time\": %ld,\n", dset_track_info->start_time);
             fprintf(f, "                \"end_time\": %ld,\n", dset_track_info->end_time);
             fprintf(f, "                \"dt_class\": \"%s\",\n", get_datatype_class_str(dset_track_info->dt_class));
@@ -3722,6 +4833,18 @@ void log_dset_ht_json(FILE* f) {
                 fprintf(f, "%ld%s", dset_track_info->dimensions[i], i == dset_track_info->dimension_cnt - 1 ? "" : ", ");
             }
             fprintf(f, "],\n");
+            fprintf(f, "                \"chunk_cache\": ");
+            dset_ccache_to_file(f, dset_track_info);
+            fprintf(f, ",\n");
+            fprintf(f, "                \"type_conversion\": ");
+            dset_tconv_to_file(f, dset_track_info);
+            fprintf(f, ",\n");
+            fprintf(f, "                \"vlen\": ");
+            dset_blob_to_file(f, dset_track_info);
+            fprintf(f, ",\n");
+            fprintf(f, "                \"async_requests\": ");
+            dset_req_to_file(f, &dset_track_info->req);
+            fprintf(f, ",\n");
             fprintf(f, "                \"dset_type_size\": %d,\n", dset_track_info->dset_type_size);
             fprintf(f, "                \"dataset_read_cnt\": %d,\n", dset_track_info->dataset_read_cnt);
             fprintf(f, "                \"dataset_write_cnt\": %d,\n", dset_track_info->dataset_write_cnt);
@@ -3732,12 +4855,49 @@ void log_dset_ht_json(FILE* f) {
             fprintf(f, "                \"dset_select_type\": \"%s\",\n", dset_track_info->dset_select_type);
             fprintf(f, "                \"dset_select_npoints\": %ld,\n", dset_track_info->dset_select_npoints);
             fprintf(f, "                \"access_orders\": [");
-            myll_to_file(f, dset_track_info->sorder_ids);
-            fprintf(f, "]\n");
+            idset_to_file(f, &dset_track_info->sorder_ids);
+            fprintf(f, "],\n");
+            fprintf(f, "                \"selections\": [");
+            dset_sel_to_file(f, dset_track_info->sel_head);
+            fprintf(f, "],\n");
+            fprintf(f, "                \"selections_dropped\": %lu,\n", dset_track_info->sel_dropped);
+            fprintf(f, "                \"chunk_dims\": ");
+            dset_sel_dims_to_file(f, dset_track_info->chunk_dims, dset_track_info->chunk_ndim);
+            fprintf(f, ",\n");
+            fprintf(f, "                \"chunks_touched\": %zu,\n", dset_track_info->chunk_map_cnt);
+            fprintf(f, "                \"chunk_heat\": [");
+            dset_chunk_to_file(f, dset_track_info);
+            fprintf(f, "],\n");
+            fprintf(f, "                \"chunk_heat_dropped\": %lu,\n", dset_track_info->chunk_dropped);
+            fprintf(f, "                \"chunk_heat_sampled\": %s\n", dset_track_info->chunk_sampled ? "true" : "false");
             fprintf(f, "            }\n");
             fprintf(f, "        ]\n");
             fprintf(f, "    }\n");
-            fprintf(f, "},\n");
+            fprintf(f, "}");
+            fclose(f);
+
+            if(rec_cnt == rec_cap){
+                size_t new_cap = rec_cap ? rec_cap * 2 : 16;
+                char** new_recs = (char**)realloc(recs, new_cap * sizeof(char*));
+                size_t* new_lens = new_recs ? (size_t*)realloc(rec_lens, new_cap * sizeof(size_t)) : NULL;
+
+                if(new_recs)
+                    recs = new_recs;
+                if(new_lens){
+                    rec_lens = new_lens;
+                    rec_cap = new_cap;
+                }
+            }
+            if(rec_cnt < rec_cap){
+                recs[rec_cnt] = rec;
+                rec_lens[rec_cnt++] = rec_len;
+            }
+            else {
+                fprintf(stderr, "log_dset_ht_json(): out of memory, record of %s dropped\n", dset_name);
+                free(rec);
+            }
+            rec = NULL;
+            rec_len = 0;
 
 
             // // Remove the entry from the hash table
@@ -3747,23 +4907,34 @@ void log_dset_ht_json(FILE* f) {
             // free_dset_track_info(entry->dset_track_info);
             // free(entry);
 
-            // // Free the memory of the file_name and dset_name
-            // free(file_name);
-            // free(dset_name);
+            // Free the memory of the file_name and dset_name
+            free(file_name);
+            free(dset_name);
 
             entry->logged = 1;
         }
 
+        if(delta_seq > 0){
+            HASH_DEL(lock.hash_table, entry);
+            free_dset_track_info(entry->dset_track_info);
+            free(entry->key);
+            free(entry);
+            dayu_mem_charge(-(long)TKR_DSET_ENTRY_BYTES);
+        }
     }
 
-    // TODO: remove logged entries
-
     // fprintf(f, "\n");
 
     // Release the lock
     pthread_mutex_unlock(&(lock.mutex));
-    fflush(f);
 
+    // the sink may block on its own lock or write inline
+    for(size_t i = 0; i < rec_cnt; i++){
+        dayu_sink_put(sink, recs[i], rec_lens[i]);
+        free(recs[i]);
+    }
+    free(recs);
+    free(rec_lens);
 }
 
 
@@ -3849,81 +5020,119 @@ void free_dset_track_info(dset_track_t *dset_track_info) {
 
         // free(dset_track_info->layout);
         // free(dset_track_info->dimensions);
-        // free(dset_track_info->sorder_ids);
-        // free(dset_track_info->sorder_ids_end);
+        idset_free(&dset_track_info->sorder_ids);
+        idset_free(&dset_track_info->metadata_file_pages);
+        dset_sel_free(&dset_track_info->sel_head);
+        dset_chunk_free(&dset_track_info->chunk_map, dset_track_info->chunk_ndim);
+        free(dset_track_info->chunk_dims);
         // free(dset_track_info->dset_select_type);
         free(dset_track_info);
     }
 }
-void myll_free(myll_t **head) {
-    myll_t *current = *head;
-    while (current != NULL) {
-        myll_t *next = current->next;
-        free(current);
-        current = next;
-    }
-    *head = NULL;
+void idset_free(idset_t *set) {
+    free(set->runs);
+    set->runs = NULL;
+    set->nruns = 0;
+    set->cap = 0;
 }
 
+int idset_contains(const idset_t *set, unsigned long id) {
+    size_t lo = 0, hi = set->nruns;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (id < set->runs[mid].start)
+            hi = mid;
+        else if (id > set->runs[mid].end)
+            lo = mid + 1;
+        else
+            return 1;
+    }
+    return 0;
+}
 
+// return the number of IDs in the set
+size_t idset_count(const idset_t *set) {
+    size_t count = 0;
+    for (size_t i = 0; i < set->nruns; i++)
+        count += set->runs[i].end - set->runs[i].start + 1;
+    return count;
+}
 
-// return the size of the linked list
-int myll_print(myll_t *head) {
-    printf("Linked List Values: ");
-    myll_t *current = head;
-    int count =0;
-    while (current != NULL) {
-        printf("%ld, ", current->data);
-        current = current->next;
-        count ++;
-    }
+// return the number of runs
+int idset_print(const idset_t *set) {
+    printf("ID Set Runs: ");
+    for (size_t i = 0; i < set->nruns; i++)
+        printf("[%lu, %lu], ", set->runs[i].start, set->runs[i].end);
     printf("\n");
-    return count;
+    return (int)set->nruns;
 }
 
-void myll_to_file(FILE * f, myll_t *head) {
-    myll_t *current = head;
-    int count =0;
-    while (current != NULL) {
-        if (count!= 0)
-            fprintf(f, ", ");
-        fprintf(f, "%ld", current->data);
-        current = current->next;
-        count ++;
-    }
-    return count;
+// Stream the set as [start, end] ranges
+void idset_to_file(FILE * f, const idset_t *set) {
+    for (size_t i = 0; i < set->nruns; i++)
+        fprintf(f, "%s[%lu, %lu]", i ? ", " : "", set->runs[i].start, set->runs[i].end);
 }
 
+static int idset_insert_run(idset_t *set, size_t pos, unsigned long id) {
+    if (set->nruns == set->cap) {
+        size_t new_cap = set->cap ? set->cap * 2 : 4;
+        idset_run_t *new_runs = (idset_run_t *)realloc(set->runs, new_cap * sizeof(idset_run_t));
+        if (new_runs == NULL) {
+            fprintf(stderr, "Failed to allocate memory for id set run\n");
+            return -1;
+        }
+        set->runs = new_runs;
+        set->cap = new_cap;
+    }
+    memmove(&set->runs[pos + 1], &set->runs[pos], (set->nruns - pos) * sizeof(idset_run_t));
+    set->runs[pos].start = id;
+    set->runs[pos].end = id;
+    set->nruns++;
+    return 0;
+}
 
+void idset_add(idset_t *set, unsigned long id) {
+    size_t lo = 0, hi = set->nruns;
 
-void myll_add(myll_t **head, myll_t **tail, unsigned long new_data) {
-    // Check if the new data already exists in the linked list
-    myll_t *current = *head;
-    while (current != NULL) {
-        if (current->data == new_data){
-            // printf("Data [%ld] already exists in the linked list\n", new_data);
+    // Fast path: increasing IDs land on or after the last run
+    if (set->nruns > 0) {
+        idset_run_t *last = &set->runs[set->nruns - 1];
+        if (id >= last->start && id <= last->end)
+            return;
+        if (id == last->end + 1) {
+            last->end = id;
+            return;
+        }
+        if (id > last->end) {
+            idset_insert_run(set, set->nruns, id);
             return;
         }
-        current = current->next;
     }
-    // printf("Adding data [%ld] to the linked list\n", new_data);
 
-    myll_t *new_node = (myll_t *)malloc(sizeof(myll_t));
-    if (new_node == NULL) {
-        // Handle memory allocation failure
-        fprintf(stderr, "Failed to allocate memory for new node\n");
-        return;
+    // Find the first run starting after id
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (set->runs[mid].start <= id)
+            lo = mid + 1;
+        else
+            hi = mid;
     }
-
-    new_node->data = new_data;
-    new_node->next = NULL;
-
-    if (*head == NULL) {
-        *head = new_node;
-        *tail = new_node;
+    if (lo > 0 && id <= set->runs[lo - 1].end)
+        return; // already present
+
+    int join_prev = (lo > 0 && set->runs[lo - 1].end + 1 == id);
+    int join_next = (lo < set->nruns && set->runs[lo].start == id + 1);
+
+    if (join_prev && join_next) {
+        set->runs[lo - 1].end = set->runs[lo].end;
+        memmove(&set->runs[lo], &set->runs[lo + 1], (set->nruns - lo - 1) * sizeof(idset_run_t));
+        set->nruns--;
+    } else if (join_prev) {
+        set->runs[lo - 1].end = id;
+    } else if (join_next) {
+        set->runs[lo].start = id;
     } else {
-        (*tail)->next = new_node;
-        *tail = new_node;
+        idset_insert_run(set, lo, id);
     }
 }
 
@@ -3954,11 +5163,17 @@ void update_dset_track_info(char * key, dataset_tkr_info_t* dset_info) {
         if(dset_info->dataset_write_cnt > 0){
             entry->dset_track_info->dataset_write_cnt += dset_info->dataset_write_cnt;
         }
-        if(dset_info->dset_offset > -1){
+        if(dset_info->meta_captured && dset_info->dset_offset > -1){
             entry->dset_track_info->dset_offset = dset_info->dset_offset;
         }
-
-        // myll_add(&(entry->dset_track_info->sorder_ids), &(entry->dset_track_info->sorder_ids_end), dset_info->sorder_id);
+        dset_sel_append(entry->dset_track_info, dset_info);
+        dset_chunk_append(entry->dset_track_info, dset_info);
+        dset_ccache_append(entry->dset_track_info, dset_info);
+        dset_tconv_append(entry->dset_track_info, dset_info);
+        dset_blob_append(entry->dset_track_info, dset_info);
+        dset_req_append(entry->dset_track_info, dset_info);
+
+        // idset_add(&(entry->dset_track_info->sorder_ids), dset_info->sorder_id);
     }
 
     // Release the lock
@@ -3994,6 +5209,7 @@ void add_to_dset_ht(dataset_tkr_info_t* dset_info){
     if (existing_entry != NULL) {
         // printf("Found existing entry\n");
         update_dset_track_info(key, dset_info);
+        free(key);
     } else {
         // printf("No existing entry found\n");
         // Create a dset_track_t object
@@ -4007,8 +5223,35 @@ void add_to_dset_ht(dataset_tkr_info_t* dset_info){
     // // Free the memory
     // free_dset_track_info(dset_track_info);
     
-    FILE_DSET_HT_ADD_TIME+= (get_time_usec() - start);
-    FILE_DSET_HT_TOTAL_TIME+= (get_time_usec() - start);
+    TKR_ADD(FILE_DSET_HT_ADD_TIME, (get_time_usec() - start));
+    TKR_ADD(FILE_DSET_HT_TOTAL_TIME, (get_time_usec() - start));
+
+    // entries only change at dataset close, so that is where a flush is checked,
+    // or a spill when the memory budget is nearly spent and the table holds a
+    // good part of it
+    if(TKR_HELPER && (TKR_HELPER->flush.enabled || dayu_mem_level() == DAYU_MEM_SPILL)){
+        size_t held;
+
+        pthread_mutex_lock(&(lock.mutex));
+        held = HASH_COUNT(lock.hash_table) * TKR_DSET_ENTRY_BYTES;
+        pthread_mutex_unlock(&(lock.mutex));
+        if(dayu_flush_due(&TKR_HELPER->flush, held))
+            log_dset_ht_flush(TKR_HELPER);
+        else if(dayu_mem_level() == DAYU_MEM_SPILL && held >= dayu_mem_used() / 4){
+            dayu_mem_degraded(DAYU_MEM_SPILLED, "vol");
+            log_dset_ht_flush(TKR_HELPER);
+        }
+    }
+}
+
+// Delta records of the datasets closed since the last flush, so a file kept
+// open for days does not grow the table
+void log_dset_ht_flush(tkr_helper_t* helper)
+{
+    unsigned long start = get_time_usec();
+
+    log_dset_ht_json(&helper->log_sink, dayu_flush_done(&helper->flush));
+    TKR_ADD(TKR_LOG_TIME, (get_time_usec() - start));
 }
 
 // Check if the key exists in the hash table
@@ -4027,13 +5270,118 @@ int key_exists(char * key) {
     // Release the lock
     pthread_mutex_unlock(&(lock.mutex));
 
-    FILE_DSET_HT_SEARCH_TIME+= (get_time_usec() - start);
-    FILE_DSET_HT_TOTAL_TIME+= (get_time_usec() - start);
+    TKR_ADD(FILE_DSET_HT_SEARCH_TIME, (get_time_usec() - start));
+    TKR_ADD(FILE_DSET_HT_TOTAL_TIME, (get_time_usec() - start));
 
     return exists;
 }
 
 
+/* dataset property cache implementations */
+// Find cached properties of a dataset by its token in the file
+DsetPropCacheEntry * dset_prop_cache_find(file_tkr_info_t* file_info, H5O_token_t* token) {
+    DsetPropCacheEntry *entry = NULL;
+
+    HASH_FIND(hh, file_info->dset_prop_cache, token, sizeof(H5O_token_t), entry);
+    return entry;
+}
+
+// Copy cached properties into dset_info, return 1 when nothing needs to be re-queried
+int dset_prop_cache_load(DsetPropCacheEntry* entry, dataset_tkr_info_t* dset_info) {
+    dset_info->dt_class = entry->dt_class;
+    dset_info->dset_type_size = entry->dset_type_size;
+    if(!dset_info->layout && entry->layout)
+        dset_info->layout = strdup(entry->layout);
+    if(!dset_info->dset_select_type && entry->dset_select_type)
+        dset_info->dset_select_type = strdup(entry->dset_select_type);
+    dset_info->dset_select_npoints = entry->dset_select_npoints;
+
+    if(entry->extent_valid && !dset_info->dimension_cnt){
+        dset_info->dimension_cnt = entry->dimension_cnt;
+        if(entry->dimension_cnt > 0){
+            dset_info->dimensions = (hsize_t *)malloc(entry->dimension_cnt * sizeof(hsize_t));
+            memcpy(dset_info->dimensions, entry->dimensions, entry->dimension_cnt * sizeof(hsize_t));
+        }
+        dset_info->dset_n_elements = entry->dset_n_elements;
+    }
+
+    if(entry->storage_valid){
+        dset_info->dset_offset = entry->dset_offset;
+        dset_info->storage_size = entry->storage_size;
+    }
+
+    return entry->extent_valid && entry->storage_valid;
+}
+
+// Add or refresh the cache entry from a fully captured dset_info
+void dset_prop_cache_store(file_tkr_info_t* file_info, dataset_tkr_info_t* dset_info) {
+    DsetPropCacheEntry *entry = dset_prop_cache_find(file_info, &dset_info->obj_info.token);
+
+    if(!entry){
+        entry = (DsetPropCacheEntry *)calloc(1, sizeof(DsetPropCacheEntry));
+        if(!entry){
+            fprintf(stderr, "Failed to allocate memory for dataset property cache\n");
+            return;
+        }
+        entry->token = dset_info->obj_info.token;
+        entry->dt_class = dset_info->dt_class;
+        entry->dset_type_size = dset_info->dset_type_size;
+        entry->layout = dset_info->layout ? strdup(dset_info->layout) : NULL;
+        entry->dset_select_type = dset_info->dset_select_type ? strdup(dset_info->dset_select_type) : NULL;
+        entry->dset_select_npoints = dset_info->dset_select_npoints;
+        HASH_ADD(hh, file_info->dset_prop_cache, token, sizeof(H5O_token_t), entry);
+    }
+
+    if(!entry->extent_valid){
+        free(entry->dimensions);
+        entry->dimensions = NULL;
+        entry->dimension_cnt = dset_info->dimension_cnt;
+        if(dset_info->dimension_cnt > 0 && dset_info->dimensions){
+            entry->dimensions = (hsize_t *)malloc(dset_info->dimension_cnt * sizeof(hsize_t));
+            memcpy(entry->dimensions, dset_info->dimensions, dset_info->dimension_cnt * sizeof(hsize_t));
+        }
+        entry->dset_n_elements = dset_info->dset_n_elements;
+        entry->extent_valid = 1;
+    }
+
+    if(!entry->storage_valid){
+        entry->dset_offset = dset_info->dset_offset;
+        entry->storage_size = dset_info->storage_size;
+        entry->storage_valid = 1;
+    }
+}
+
+// Mark mutable properties stale after H5Dwrite (storage) or H5Dset_extent (extent and storage)
+void dset_prop_cache_invalidate(dataset_tkr_info_t* dset_info, bool extent, bool storage) {
+    file_tkr_info_t *file_info = dset_info->obj_info.file_info;
+    DsetPropCacheEntry *entry = NULL;
+
+    if(!file_info)
+        return;
+
+    entry = dset_prop_cache_find(file_info, &dset_info->obj_info.token);
+    if(entry){
+        if(extent)
+            entry->extent_valid = 0;
+        if(storage)
+            entry->storage_valid = 0;
+    }
+}
+
+// Release the cache when the file info is freed
+void dset_prop_cache_free(file_tkr_info_t* file_info) {
+    DsetPropCacheEntry *current, *tmp;
+
+    HASH_ITER(hh, file_info->dset_prop_cache, current, tmp) {
+        HASH_DEL(file_info->dset_prop_cache, current);
+        free(current->layout);
+        free(current->dset_select_type);
+        free(current->dimensions);
+        free(current);
+    }
+    file_info->dset_prop_cache = NULL;
+}
+
 // Function to check object's loc_params type and get some info
 void check_obj_loc_params_type(char* func, H5VL_loc_params_t *loc_params){
     switch(loc_params->type){
@@ -4095,48 +5443,41 @@ char *remove_leading_slash(const char *input) {
 
 
 
-void dset_shm_write(const char *dset_name) { // TODO: modify to append to the end
+// Publish the current object of the calling thread to the VFD through the core
+void dset_ctx_write(const char *dset_name) {
 #ifdef DEBUG_PT_TKR_VOL
-    printf("TRACKER VOL INT: dset_shm_write()\n");
+    printf("TRACKER VOL INT: dset_ctx_write()\n");
 #endif
 
-    char * cp_dset_name = strdup(dset_name);
-
     // remove leading / if in dset_name
-    if (cp_dset_name[0] == '/') {
-        cp_dset_name++;
-    }
-
-
-    // Only write to shared memory if it is different from the current object
-    if (CURR_DSET != NULL && strcmp(CURR_DSET, cp_dset_name) == 0) {
-        return;
-    }
-
-
-    pid_t pid = getpid();
-    size_t len = strlen(SHM_NAME) + 1 + sizeof(pid) * 3; // +1 for null terminator
-    char *task_shm_name = (char *)malloc(len);
-    snprintf(task_shm_name, len, "%s_%d", SHM_NAME, pid);
-
-    // Allocate shared memory
-    int shm_fd = shm_open(task_shm_name, O_CREAT | O_RDWR, 0666);
-    ftruncate(shm_fd, SHM_SIZE);
-
-    if (CURR_DSET != NULL) {
-        munmap(CURR_DSET, SHM_SIZE);
-    }
-
+    if (dset_name[0] == '/')
+        dset_name++;
 
-    CURR_DSET = (char *)mmap(0, SHM_SIZE, PROT_WRITE, MAP_SHARED, shm_fd, 0);
-    strcpy(CURR_DSET, cp_dset_name);
+    dayu_ctx_set(dset_name);
 
 #ifdef DEBUG_TKR_VOL
-    printf("Shared Memory Name: %s\n", task_shm_name);
-    printf("Object Name: %s\n", CURR_DSET);
+    printf("Object Name: %s\n", dayu_ctx_get());
 #endif
+}
 
-    // Clean up
-    close(shm_fd);
-    free(task_shm_name);
+// Make dset_name the current object of this thread, until the matching pop
+void dset_ctx_push(const char *dset_name) {
+    if (DSET_CTX_TOP < DSET_CTX_DEPTH) {
+        const char *cur = dayu_ctx_get();
+        strcpy(DSET_CTX_STACK[DSET_CTX_TOP], cur[0] ? cur : "file");
+    }
+    DSET_CTX_TOP++;
+    dset_ctx_write(dset_name);
+}
+
+// Restore the object that was current before the last push,
+// the outermost pop goes back to "file" like a dataset close did
+void dset_ctx_pop() {
+    if (DSET_CTX_TOP == 0)
+        return;
+    DSET_CTX_TOP--;
+    if (DSET_CTX_TOP == 0)
+        dset_ctx_write("file");
+    else if (DSET_CTX_TOP < DSET_CTX_DEPTH)
+        dset_ctx_write(DSET_CTX_STACK[DSET_CTX_TOP]);
 }
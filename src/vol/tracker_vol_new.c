@@ -329,7 +329,7 @@ H5VL_tracker_register(void)
     if(H5I_VOL != H5Iget_type(tkr_connector_id_global))
         tkr_connector_id_global = H5VLregister_connector(&H5VL_tracker_cls, H5P_DEFAULT);
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start);
+    tkr_cb_record(TKR_CB_register, start, 0);
     return tkr_connector_id_global;
 } /* end H5VL_tracker_register() */
 
@@ -356,7 +356,7 @@ H5VL_tracker_init(hid_t vipl_id)
 
 #ifdef ACCESS_STAT
     // tkrLockAcquire(&myLock);
-    dset_shm_write("file"); // set the current object to file, represented as "/"
+    dset_ctx_write("file"); // set the current object to file, represented as "/"
     // tkrLockRelease(&myLock);
 #endif
 
@@ -375,6 +375,8 @@ H5VL_tracker_init(hid_t vipl_id)
     // In memory HT overhead
     FILE_DSET_HT_TOTAL_TIME = 0;
     TRK_ACCESS_STAT_TIME = 0;
+    DSET_PROP_CACHE_HIT = 0;
+    DSET_PROP_CACHE_MISS = 0;
 
     FILE_SORDER = 0 ;
     DATA_SORDER = 0 ;
@@ -384,8 +386,8 @@ H5VL_tracker_init(hid_t vipl_id)
     /* Shut compiler up about unused parameter */
     (void)vipl_id;
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start);
-    TKR_INIT_TIME += (get_time_usec() - start);
+    tkr_cb_record(TKR_CB_init, start, 0);
+    TKR_ADD(TKR_INIT_TIME, (get_time_usec() - start));
     return 0;
 } /* end H5VL_tracker_init() */
 
@@ -413,16 +415,19 @@ H5VL_tracker_term(void)
     // Release resources, etc.
 #ifdef ACCESS_STAT
     unsigned long trk_start = get_time_usec();
+#endif
+    // Always torn down, the log sink holds records not yet on disk
     tkr_helper_teardown(TKR_HELPER);
-    TRK_ACCESS_STAT_TIME += (get_time_usec() - trk_start);
+#ifdef ACCESS_STAT
+    TKR_ADD(TRK_ACCESS_STAT_TIME, (get_time_usec() - trk_start));
 #endif
     TKR_HELPER = NULL;
 
     /* Reset VOL ID */
     tkr_connector_id_global = H5I_INVALID_HID;
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start);
-    TKR_TERM_TIME += (get_time_usec() - start);
+    tkr_cb_record(TKR_CB_term, start, 0);
+    TKR_ADD(TKR_TERM_TIME, (get_time_usec() - start));
     return 0;
 } /* end H5VL_tracker_term() */
 
@@ -480,7 +485,7 @@ H5VL_tracker_info_copy(const void *_info)
     printf("TRACKER VOL INFO Copy: END\n");
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start);
+    tkr_cb_record(TKR_CB_info_copy, start, 0);
 
     return new_info;
 } /* end H5VL_tracker_info_copy() */
@@ -520,37 +525,37 @@ H5VL_tracker_info_cmp(int *cmp_value, const void *_info1, const void *_info2)
     /* Compare under VOL connector classes */
     H5VLcmp_connector_cls(cmp_value, info1->under_vol_id, info2->under_vol_id);
     if(*cmp_value != 0){
-        TOTAL_TKR_OVERHEAD += (get_time_usec() - start);
+        tkr_cb_record(TKR_CB_info_cmp, start, 0);
         return 0;
     }
 
     /* Compare under VOL connector info objects */
     H5VLcmp_connector_info(cmp_value, info1->under_vol_id, info1->under_vol_info, info2->under_vol_info);
     if(*cmp_value != 0){
-        TOTAL_TKR_OVERHEAD += (get_time_usec() - start);
+        tkr_cb_record(TKR_CB_info_cmp, start, 0);
         return 0;
     }
     m2 = get_time_usec();
 
     *cmp_value = strcmp(info1->tkr_file_path, info2->tkr_file_path);
     if(*cmp_value != 0){
-        TOTAL_TKR_OVERHEAD += (get_time_usec() - start);
+        tkr_cb_record(TKR_CB_info_cmp, start, 0);
         return 0;
     }
 
     *cmp_value = (int)info1->tkr_level - (int)info2->tkr_level;
     if(*cmp_value != 0){
-        TOTAL_TKR_OVERHEAD += (get_time_usec() - start);
+        tkr_cb_record(TKR_CB_info_cmp, start, 0);
         return 0;
     }
 
     *cmp_value = strcmp(info1->tkr_line_format, info2->tkr_line_format);
     if(*cmp_value != 0){
-        TOTAL_TKR_OVERHEAD += (get_time_usec() - start);
+        tkr_cb_record(TKR_CB_info_cmp, start, 0);
         return 0;
     }
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_info_cmp, start, m2 - m1);
     return 0;
 } /* end H5VL_tracker_info_cmp() */
 
@@ -596,7 +601,7 @@ H5VL_tracker_info_free(void *_info)
     // free(info->tkr_line_format);
     free(info);
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start);
+    tkr_cb_record(TKR_CB_info_free, start, 0);
 
 #ifdef DEBUG_PT_TKR_VOL
     printf("TRACKER VOL INFO Free: END\n");
@@ -661,7 +666,7 @@ H5VL_tracker_info_to_str(const void *_info, char **str)
     if(under_vol_string)
         H5free_memory(under_vol_string);
     
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start);
+    tkr_cb_record(TKR_CB_info_to_str, start, 0);
     return 0;
 } /* end H5VL_tracker_info_to_str() */
 
@@ -727,8 +732,9 @@ H5VL_tracker_str_to_info(const char *str, void **_info)
         info->tkr_level = File_only;
     }
 
-    /* init global helper */
-    TKR_HELPER = tkr_helper_init(info->tkr_file_path, info->tkr_level, info->tkr_line_format);
+    /* init global helper, once per process so the stat file is opened once */
+    if(!TKR_HELPER)
+        TKR_HELPER = tkr_helper_init(info->tkr_file_path, info->tkr_level, info->tkr_line_format);
 
 
     /* Set return value */
@@ -744,7 +750,7 @@ H5VL_tracker_str_to_info(const char *str, void **_info)
     printf("}\n");
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start);
+    tkr_cb_record(TKR_CB_str_to_info, start, 0);
     return 0;
 } /* end H5VL_tracker_str_to_info() */
 
@@ -806,7 +812,7 @@ H5VL_tracker_get_object(const void *obj)
 #endif
 
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_get_object, start, m2 - m1);
 
     return ret;
 
@@ -882,7 +888,7 @@ H5VL_tracker_get_wrap_ctx(const void *obj, void **wrap_ctx)
     /* Set wrap context to return */
     *wrap_ctx = new_wrap_ctx;
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_get_wrap_ctx, start, m2 - m1);
     return 0;
 } /* end H5VL_tracker_get_wrap_ctx() */
 
@@ -939,7 +945,7 @@ H5VL_tracker_wrap_object(void *under_under_in, H5I_type_t obj_type, void *_wrap_
 #endif
 
     TKR_OBJ_WRAP += (get_time_usec() - start - (m2 - m1));
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_wrap_object, start, m2 - m1);
     return (void*)new_obj;
 } /* end H5VL_tracker_wrap_object() */
 
@@ -1019,7 +1025,7 @@ H5VL_tracker_unwrap_object(void *obj)
     printf("TRACKER VOL UNWRAP Object: END\n");
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_unwrap_object, start, m2 - m1);
     return under;
 } /* end H5VL_tracker_unwrap_object() */
 
@@ -1067,7 +1073,7 @@ H5VL_tracker_free_wrap_ctx(void *_wrap_ctx)
 #endif
 
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start);
+    tkr_cb_record(TKR_CB_free_wrap_ctx, start, 0);
     return 0;
 } /* end H5VL_tracker_free_wrap_ctx() */
 
@@ -1112,7 +1118,7 @@ H5VL_tracker_attr_create(void *obj, const H5VL_loc_params_t *loc_params,
         tkr_write(o->tkr_helper, __func__, get_time_usec() - start);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_attr_create, start, m2 - m1);
     return (void*)attr;
 } /* end H5VL_tracker_attr_create() */
 
@@ -1180,7 +1186,7 @@ H5VL_tracker_attr_open(void *obj, const H5VL_loc_params_t *loc_params,
     attribute_info_print("H5VLattr_open", obj, loc_params, NULL, dxpl_id, req);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_attr_open, start, m2 - m1);
     return (void *)attr;
 } /* end H5VL_tracker_attr_open() */
 
@@ -1225,7 +1231,7 @@ H5VL_tracker_attr_read(void *attr, hid_t mem_type_id, void *buf,
 #ifdef DEBUG_TKR_VOL
     attribute_info_print("H5VLattr_read", attr, NULL, NULL, dxpl_id, req);
 #endif
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_attr_read, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_attr_read() */
 
@@ -1275,7 +1281,7 @@ H5VL_tracker_attr_write(void *attr, hid_t mem_type_id, const void *buf,
     attribute_info_print("H5VLattr_write", attr, NULL, NULL, dxpl_id, req);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_attr_write, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_attr_write() */
 
@@ -1317,7 +1323,7 @@ H5VL_tracker_attr_get(void *obj, H5VL_attr_get_args_t *args, hid_t dxpl_id,
         tkr_write(o->tkr_helper, __func__, get_time_usec() - start);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_attr_get, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_attr_get() */
 
@@ -1364,7 +1370,7 @@ H5VL_tracker_attr_specific(void *obj, const H5VL_loc_params_t *loc_params,
     attribute_info_print("H5VLattr_specific", obj, loc_params, args, dxpl_id, req);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_attr_specific, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_attr_specific() */
 
@@ -1405,7 +1411,7 @@ H5VL_tracker_attr_optional(void *obj, H5VL_optional_args_t *args, hid_t dxpl_id,
         tkr_write(o->tkr_helper, __func__, get_time_usec() - start);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_attr_optional, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_attr_optional() */
 
@@ -1463,7 +1469,7 @@ H5VL_tracker_attr_close(void *attr, hid_t dxpl_id, void **req)
         H5VL_tracker_free_obj(o);
     }
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_attr_close, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_attr_close() */
 
@@ -1503,22 +1509,13 @@ H5VL_tracker_dataset_create(void *obj, const H5VL_loc_params_t *loc_params,
     else
         dset = NULL;
     
-#ifdef ACCESS_STAT
-    unsigned long trk_start = get_time_usec();
-    // TODO: Record at close time to reduce overhead
-    if(dset != NULL){
-        // get dataset offset and storage size not available yet
-        dataset_info_update("H5VLdataset_create", NULL, NULL, NULL, dset, dxpl_id); // this must exist
-    }
-
-    TRK_ACCESS_STAT_TIME += (get_time_usec() - trk_start);
-#endif
+    // ACCESS_STAT: dataset properties are captured lazily at first write or close
 
 #ifdef DEBUG_OVERHEAD_TKR_VOL
     if(o)
         tkr_write(o->tkr_helper, __func__, get_time_usec() - start);
 #endif
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_dataset_create, start, m2 - m1);
     return (void *)dset;
 } /* end H5VL_tracker_dataset_create() */
 
@@ -1566,10 +1563,9 @@ H5VL_tracker_dataset_open(void *obj, const H5VL_loc_params_t *loc_params,
 
     dset_info->pfile_sorder_id = file_info->sorder_id;
 
-    // Record at close time to reduce overhead?
-    dataset_info_update("H5VLdataset_open", NULL, NULL, NULL, dset, dxpl_id);
+    // dataset properties are captured lazily at first read/write or close
 
-    TRK_ACCESS_STAT_TIME += (get_time_usec() - trk_start);
+    TKR_ADD(TRK_ACCESS_STAT_TIME, (get_time_usec() - trk_start));
 
 #endif
 
@@ -1578,7 +1574,7 @@ H5VL_tracker_dataset_open(void *obj, const H5VL_loc_params_t *loc_params,
         tkr_write(dset->tkr_helper, __func__, get_time_usec() - start);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_dataset_open, start, m2 - m1);
     return (void *)dset;
 } /* end H5VL_tracker_dataset_open() */
 
@@ -1600,6 +1596,7 @@ static herr_t H5VL_tracker_dataset_read(size_t count, void *dset[],
     unsigned long start = get_time_usec();
     unsigned long m1, m2;
     void *o_arr[count];   /* Array of under objects */
+    unsigned long io_time[count];           /* time in the under call per dataset */
 
     hid_t under_vol_id;                     /* VOL ID for all objects */
     herr_t ret_value;
@@ -1608,22 +1605,11 @@ static herr_t H5VL_tracker_dataset_read(size_t count, void *dset[],
     printf("TRACKER VOL DATASET Read\n");
 #endif
 
-#ifdef ACCESS_STAT
-    unsigned long trk_start = get_time_usec();
-    // Assume only 1 dataset being open at a time from the same process
-    H5VL_tracker_t *o = (H5VL_tracker_t *)dset[0]; // only get the first dataset
-    dataset_tkr_info_t * dset_info = (dataset_tkr_info_t*)o->generic_tkr_info;
-    if(dset_info->obj_info.name)
-        dset_shm_write(dset_info->obj_info.name); // TODO: improve to update only when dataset is changed
-    TRK_ACCESS_STAT_TIME += (get_time_usec() - trk_start);
-#endif
-
 #ifdef H5_HAVE_PARALLEL
     H5FD_mpio_xfer_t xfer_mode = H5FD_MPIO_INDEPENDENT;
     // Retrieve MPI-IO transfer option
     H5Pget_dxpl_mpio(plist_id, &xfer_mode);
 #endif /* H5_HAVE_PARALLEL */
-    
 
     /* Populate the array of under objects */
     under_vol_id = ((H5VL_tracker_t *)(dset[0]))->under_vol_id;
@@ -1633,22 +1619,43 @@ static herr_t H5VL_tracker_dataset_read(size_t count, void *dset[],
     }
 
     m1 = get_time_usec();
-    // ret_value = H5VLdataset_read(o->under_object, o->under_vol_id, mem_type_id, mem_space_id, file_space_id, plist_id, buf, req);
+#ifdef ACCESS_STAT
+    // A multi-dataset call stays one under call, as the application issued
+    // it. Its raw data is attributed by address in the VFD, its other I/O
+    // and blobs go to the file, and its time is split by selected bytes.
+    dataset_tkr_info_t * ctx_info = (dataset_tkr_info_t*)((H5VL_tracker_t *)dset[0])->generic_tkr_info;
+    dset_ctx_push(count > 1 ? "file" : ctx_info->obj_info.name ? ctx_info->obj_info.name : "unknown");
+    DSET_CTX_DSET = count == 1 ? ctx_info : NULL;
+#endif
     ret_value = H5VLdataset_read(count, o_arr, under_vol_id, mem_type_id, mem_space_id, file_space_id, plist_id, buf, req);
+#ifdef ACCESS_STAT
+    DSET_CTX_DSET = NULL;
+    dset_ctx_pop();
+#endif
     m2 = get_time_usec();
+    if(count > 1)
+        dset_io_time_split(count, dset, mem_type_id, mem_space_id, file_space_id, m2 - m1, io_time);
+    else
+        io_time[0] = m2 - m1;
 
 #ifdef DEBUG_PT_TKR_VOL
     printf("TRACKER VOL DATASET Read: H5VLdataset_read() done\n");
 #endif
 
     if(ret_value >= 0){
-        for (int obj_idx=0; obj_idx<count; obj_idx++){
+        /* Check for async request */
+        if(req && *req){
+            *req = H5VL_tracker_new_obj(*req, under_vol_id, ((H5VL_tracker_t *)dset[0])->tkr_helper);
+#ifdef ACCESS_STAT
+            tkr_req_submit((H5VL_tracker_t *)*req,
+                (dataset_tkr_info_t*)((H5VL_tracker_t *)dset[0])->generic_tkr_info, 'r', start);
+#endif
+        }
+
+        for (size_t obj_idx=0; obj_idx<count; obj_idx++){
             H5VL_tracker_t *o = (H5VL_tracker_t *)dset[obj_idx];
+            dataset_tkr_info_t * dset_info = (dataset_tkr_info_t*)o->generic_tkr_info;
 
-            /* Check for async request */
-            if(req && *req)
-                *req = H5VL_tracker_new_obj(*req, under_vol_id, o->tkr_helper);
-                // *req = H5VL_tracker_new_obj(*req, under_vol_id);
 #ifdef H5_HAVE_PARALLEL
         // Increment appropriate parallel I/O counters
         if(xfer_mode == H5FD_MPIO_INDEPENDENT)
@@ -1667,13 +1674,23 @@ static herr_t H5VL_tracker_dataset_read(size_t count, void *dset[],
 
 #ifdef ACCESS_STAT
             unsigned long trk_start = get_time_usec();
-            // dataset_tkr_info_t * dset_info = (dataset_tkr_info_t*)o->generic_tkr_info;
+            dataset_info_capture("H5VLdataset_read", o, plist_id);
             dset_info->dataset_read_cnt++;
+            int sel_repeat = dset_sel_record(dset_info, 'r', file_space_id[obj_idx], mem_type_id[obj_idx]);
+            dset_chunk_record(o, dset_info, 'r', file_space_id[obj_idx], plist_id, sel_repeat);
+            dset_amap_record(o, dset_info, plist_id);
+            size_t io_bytes = dset_tconv_record(o, dset_info, 'r', mem_type_id[obj_idx], plist_id, io_time[obj_idx]);
+            if(dset_info->obj_info.file_info && dset_info->obj_info.file_info->live_slot >= 0)
+                dayu_live_io(dset_info->obj_info.file_info->live_slot, DAYU_LIVE_VOL, 0, io_bytes,
+                    io_time[obj_idx], dset_info->obj_info.name);
+            if(req == NULL)
+                dset_vlen_read_end(o, dset_info, mem_type_id[obj_idx], mem_space_id[obj_idx],
+                    file_space_id[obj_idx], plist_id, buf[obj_idx]);
             if(!dset_info->dspace_id)
                 dset_info->dspace_id = mem_space_id[obj_idx];
             if(!dset_info->dtype_id)
                 dset_info->dtype_id = mem_type_id[obj_idx];
-            TRK_ACCESS_STAT_TIME += (get_time_usec() - trk_start);
+            TKR_ADD(TRK_ACCESS_STAT_TIME, (get_time_usec() - trk_start));
 #endif
 
 #ifdef DEBUG_OVERHEAD_TKR_VOL
@@ -1685,7 +1702,7 @@ static herr_t H5VL_tracker_dataset_read(size_t count, void *dset[],
     printf("TRACKER VOL DATASET Read: END\n");
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_dataset_read, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_dataset_read() */
 
@@ -1707,9 +1724,8 @@ static herr_t H5VL_tracker_dataset_write(size_t count, void *dset[],
 
     unsigned long start = get_time_usec();
     unsigned long m1, m2;
-// //H5VL_tracker_t: A envelop
-//     H5VL_tracker_t *o = (H5VL_tracker_t *)dset[0];
     void *o_arr[count];   /* Array of under objects */
+    unsigned long io_time[count];           /* time in the under call per dataset */
     hid_t under_vol_id;                     /* VOL ID for all objects */
 
 #ifdef H5_HAVE_PARALLEL
@@ -1722,21 +1738,6 @@ static herr_t H5VL_tracker_dataset_write(size_t count, void *dset[],
     printf("TRACKER VOL DATASET Write\n");
 #endif
 
-#ifdef ACCESS_STAT
-    unsigned long trk_start = get_time_usec();
-    // Assume only 1 dataset being open at a time from the same process
-    H5VL_tracker_t *o = (H5VL_tracker_t *)(dset[0]);
-    dataset_tkr_info_t * dset_info = (dataset_tkr_info_t*)o->generic_tkr_info;
-    if(dset_info->obj_info.name)
-        dset_shm_write(dset_info->obj_info.name); // TODO: improve to update only when dataset is changed
-#ifdef DEBUG_PT_TKR_VOL
-    printf("TRACKER VOL DATASET Write: dset_shm_write() done\n");
-#endif
-    TRK_ACCESS_STAT_TIME += (get_time_usec() - trk_start);
-#endif
-
-
-
 #ifdef H5_HAVE_PARALLEL
     // Retrieve MPI-IO transfer option
     H5Pget_dxpl_mpio(plist_id, &xfer_mode);
@@ -1758,10 +1759,24 @@ static herr_t H5VL_tracker_dataset_write(size_t count, void *dset[],
 
     // reuse A envelop
     m1 = get_time_usec();
-    // ret_value = H5VLdataset_write(o->under_object, o->under_vol_id, mem_type_id, mem_space_id, file_space_id, plist_id, buf, req);
+#ifdef ACCESS_STAT
+    // A multi-dataset call stays one under call, as the application issued
+    // it. Its raw data is attributed by address in the VFD, its other I/O
+    // and blobs go to the file, and its time is split by selected bytes.
+    dataset_tkr_info_t * ctx_info = (dataset_tkr_info_t*)((H5VL_tracker_t *)dset[0])->generic_tkr_info;
+    dset_ctx_push(count > 1 ? "file" : ctx_info->obj_info.name ? ctx_info->obj_info.name : "unknown");
+    DSET_CTX_DSET = count == 1 ? ctx_info : NULL;
+#endif
     ret_value = H5VLdataset_write(count, o_arr, under_vol_id, mem_type_id, mem_space_id, file_space_id, plist_id, buf, req);
-
+#ifdef ACCESS_STAT
+    DSET_CTX_DSET = NULL;
+    dset_ctx_pop();
+#endif
     m2 = get_time_usec();
+    if(count > 1)
+        dset_io_time_split(count, dset, mem_type_id, mem_space_id, file_space_id, m2 - m1, io_time);
+    else
+        io_time[0] = m2 - m1;
 
 #ifdef DEBUG_PT_TKR_VOL
     printf("TRACKER VOL DATASET Write: H5VLdataset_write() done\n");
@@ -1769,13 +1784,19 @@ static herr_t H5VL_tracker_dataset_write(size_t count, void *dset[],
 
 
     if(ret_value >= 0){
-        H5VL_tracker_t *o;
-        for (int obj_idx=0; obj_idx<count; obj_idx++){
+        /* Check for async request */
+        if(req && *req){
+            *req = H5VL_tracker_new_obj(*req, under_vol_id, ((H5VL_tracker_t *)dset[0])->tkr_helper);
+#ifdef ACCESS_STAT
+            tkr_req_submit((H5VL_tracker_t *)*req,
+                (dataset_tkr_info_t*)((H5VL_tracker_t *)dset[0])->generic_tkr_info, 'w', start);
+#endif
+        }
+
+        for (size_t obj_idx=0; obj_idx<count; obj_idx++){
             H5VL_tracker_t *o = (H5VL_tracker_t *)dset[obj_idx];
+            dataset_tkr_info_t * dset_info = (dataset_tkr_info_t*)o->generic_tkr_info;
 
-            /* Check for async request */
-            if(req && *req)
-                *req = H5VL_tracker_new_obj(*req, under_vol_id, o->tkr_helper);
 #ifdef H5_HAVE_PARALLEL
         // Increment appropriate parallel I/O counters
         if(xfer_mode == H5FD_MPIO_INDEPENDENT)
@@ -1793,7 +1814,7 @@ static herr_t H5VL_tracker_dataset_write(size_t count, void *dset[],
 #endif /* H5_HAVE_PARALLEL */
 #ifdef ACCESS_STAT
             unsigned long trk_start = get_time_usec();
-            dataset_tkr_info_t * dset_info = (dataset_tkr_info_t*)o->generic_tkr_info;
+            dataset_info_capture("H5VLdataset_write", o, plist_id);
 
             if(!dset_info->dspace_id)
                 dset_info->dspace_id = mem_space_id[obj_idx];
@@ -1801,7 +1822,15 @@ static herr_t H5VL_tracker_dataset_write(size_t count, void *dset[],
                 dset_info->dtype_id = mem_type_id[obj_idx];
             
             dset_info->dataset_write_cnt++;
-            TRK_ACCESS_STAT_TIME += (get_time_usec() - trk_start);
+            int sel_repeat = dset_sel_record(dset_info, 'w', file_space_id[obj_idx], mem_type_id[obj_idx]);
+            dset_chunk_record(o, dset_info, 'w', file_space_id[obj_idx], plist_id, sel_repeat);
+            dset_amap_record(o, dset_info, plist_id);
+            size_t io_bytes = dset_tconv_record(o, dset_info, 'w', mem_type_id[obj_idx], plist_id, io_time[obj_idx]);
+            if(dset_info->obj_info.file_info && dset_info->obj_info.file_info->live_slot >= 0)
+                dayu_live_io(dset_info->obj_info.file_info->live_slot, DAYU_LIVE_VOL, 1, io_bytes,
+                    io_time[obj_idx], dset_info->obj_info.name);
+            dset_prop_cache_invalidate(dset_info, 0, 1); // storage may be allocated or grown
+            TKR_ADD(TRK_ACCESS_STAT_TIME, (get_time_usec() - trk_start));
 #endif
 
 #ifdef DEBUG_OVERHEAD_TKR_VOL
@@ -1811,7 +1840,7 @@ static herr_t H5VL_tracker_dataset_write(size_t count, void *dset[],
     }
 
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_dataset_write, start, m2 - m1);
 
 #ifdef DEBUG_PT_TKR_VOL
     printf("TRACKER VOL DATASET Write: END\n");
@@ -1866,7 +1895,7 @@ H5VL_tracker_dataset_get(void *dset, H5VL_dataset_get_args_t *args,
         tkr_write(o->tkr_helper, __func__, get_time_usec() - start);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_dataset_get, start, m2 - m1);
 
     return ret_value;
 } /* end H5VL_tracker_dataset_get() */
@@ -1922,6 +1951,15 @@ H5VL_tracker_dataset_specific(void *obj, H5VL_dataset_specific_args_t *args,
     ret_value = H5VLdataset_specific(o->under_object, o->under_vol_id, args, dxpl_id, req);
     m2 = get_time_usec();
 
+#ifdef ACCESS_STAT
+    // flushed chunks have their addresses, look them up without another flush
+    if(args->op_type == H5VL_DATASET_FLUSH && ret_value >= 0 && !(req && *req)){
+        unsigned long trk_start = get_time_usec();
+        dset_chunk_resolve(o, (dataset_tkr_info_t *)o->generic_tkr_info, dxpl_id);
+        TKR_ADD(TRK_ACCESS_STAT_TIME, (get_time_usec() - trk_start));
+    }
+#endif
+
     // Update dataset dimensions for 'set extent' operations
     if(args->op_type == H5VL_DATASET_SET_EXTENT) {
         if(ret_value >= 0) {
@@ -1929,6 +1967,7 @@ H5VL_tracker_dataset_specific(void *obj, H5VL_dataset_specific_args_t *args,
 
             ds_info = (dataset_tkr_info_t *)o->generic_tkr_info;
             assert(ds_info);
+            dset_prop_cache_invalidate(ds_info, 1, 1);
 
             // Update dimension sizes, if simple dataspace
             if(H5S_SIMPLE == ds_info->ds_class) {
@@ -1964,10 +2003,13 @@ H5VL_tracker_dataset_specific(void *obj, H5VL_dataset_specific_args_t *args,
             dataset_id = args->args.refresh.dset_id;
 
             // Update dataspace dimensions & element count (which could have changed)
-            space_id = H5Dget_space(dataset_id);
-            H5Sget_simple_extent_dims(space_id, my_dataset_info->dimensions, NULL);
-            my_dataset_info->dset_n_elements = (hsize_t)H5Sget_simple_extent_npoints(space_id);
-            H5Sclose(space_id);
+            // not yet captured dataset will pick up the refreshed extent lazily
+            if(my_dataset_info->meta_captured) {
+                space_id = H5Dget_space(dataset_id);
+                H5Sget_simple_extent_dims(space_id, my_dataset_info->dimensions, NULL);
+                my_dataset_info->dset_n_elements = (hsize_t)H5Sget_simple_extent_npoints(space_id);
+                H5Sclose(space_id);
+            }
 
             // Don't close dataset ID, it's owned by the application
         }
@@ -1984,7 +2026,7 @@ H5VL_tracker_dataset_specific(void *obj, H5VL_dataset_specific_args_t *args,
     tkr_write(helper, __func__, get_time_usec() - start);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_dataset_specific, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_dataset_specific() */
 
@@ -2026,7 +2068,7 @@ H5VL_tracker_dataset_optional(void *obj, H5VL_optional_args_t *args,
         tkr_write(o->tkr_helper, __func__, get_time_usec() - start);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_dataset_optional, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_dataset_optional() */
 
@@ -2061,9 +2103,20 @@ H5VL_tracker_dataset_close(void *dset, hid_t dxpl_id, void **req)
     assert(dset_info);
     
     BLOB_SORDER=0;
+    // capture properties for datasets never read/written, only if not yet recorded
+    if(!dset_info->meta_captured && dset_info->pfile_name && dset_info->obj_info.name){
+        char * key = encode_two_strings(dset_info->pfile_name, dset_info->obj_info.name);
+        if(key_exists(key) == 0)
+            dataset_info_capture("H5VLdataset_close", o, dxpl_id);
+        free(key);
+    }
+    // chunk addresses once, the close writes the chunk cache out anyway
+    dset_chunk_resolve(o, dset_info, dxpl_id);
     // add to dset hashtable at dset close time
     add_to_dset_ht(dset_info); // Record to hash table before freeing the dset_info
-    TRK_ACCESS_STAT_TIME += (get_time_usec() - trk_start);
+    // metadata flushed at close belongs to this dataset
+    dset_ctx_push(dset_info->obj_info.name ? dset_info->obj_info.name : "unknown");
+    TKR_ADD(TRK_ACCESS_STAT_TIME, (get_time_usec() - trk_start));
 #endif
 
     m1 = get_time_usec();
@@ -2081,8 +2134,8 @@ H5VL_tracker_dataset_close(void *dset, hid_t dxpl_id, void **req)
         rm_dataset_node(o->tkr_helper, o->under_object, o->under_vol_id, dset_info);
         H5VL_tracker_free_obj(o);
     }
-    dset_shm_write("file"); // clear the dataset name
-    TRK_ACCESS_STAT_TIME += (get_time_usec() - trk_start);
+    dset_ctx_pop(); // back to the enclosing object, "file" outside any dataset
+    TKR_ADD(TRK_ACCESS_STAT_TIME, (get_time_usec() - trk_start));
 #endif
 
 
@@ -2090,7 +2143,7 @@ H5VL_tracker_dataset_close(void *dset, hid_t dxpl_id, void **req)
         tkr_write(o->tkr_helper, __func__, get_time_usec() - start);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_dataset_close, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_dataset_close() */
 
@@ -2135,7 +2188,7 @@ H5VL_tracker_datatype_commit(void *obj, const H5VL_loc_params_t *loc_params,
         tkr_write(o->tkr_helper, __func__, get_time_usec() - start);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_datatype_commit, start, m2 - m1);
     return (void *)dt;
 } /* end H5VL_tracker_datatype_commit() */
 
@@ -2179,7 +2232,7 @@ H5VL_tracker_datatype_open(void *obj, const H5VL_loc_params_t *loc_params,
         tkr_write(dt->tkr_helper, __func__, get_time_usec() - start);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_datatype_open, start, m2 - m1);
     return (void *)dt;
 } /* end H5VL_tracker_datatype_open() */
 
@@ -2221,7 +2274,7 @@ H5VL_tracker_datatype_get(void *dt, H5VL_datatype_get_args_t *args,
         tkr_write(o->tkr_helper, __func__, get_time_usec() - start);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_datatype_get, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_datatype_get() */
 
@@ -2300,7 +2353,7 @@ H5VL_tracker_datatype_specific(void *obj, H5VL_datatype_specific_args_t *args,
     tkr_write(helper, __func__, get_time_usec() - start);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_datatype_specific, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_datatype_specific() */
 
@@ -2342,7 +2395,7 @@ H5VL_tracker_datatype_optional(void *obj, H5VL_optional_args_t *args,
         tkr_write(o->tkr_helper, __func__, get_time_usec() - start);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_datatype_optional, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_datatype_optional() */
 
@@ -2393,7 +2446,7 @@ H5VL_tracker_datatype_close(void *dt, hid_t dxpl_id, void **req)
     }
 
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_datatype_close, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_datatype_close() */
 
@@ -2517,7 +2570,7 @@ H5VL_tracker_file_create(const char *name, unsigned flags, hid_t fcpl_id,
     file_info_update("H5VLfile_create", file, fapl_id, fcpl_id, dxpl_id);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_file_create, start, m2 - m1);
     return (void *)file;
 } /* end H5VL_tracker_file_create() */
 
@@ -2649,7 +2702,7 @@ H5VL_tracker_file_open(const char *name, unsigned flags, hid_t fapl_id,
     // Add File node to Tracker
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_file_open, start, m2 - m1);
     return (void *)file;
 } /* end H5VL_tracker_file_open() */
 
@@ -2702,7 +2755,7 @@ H5VL_tracker_file_get(void *file, H5VL_file_get_args_t *args, hid_t dxpl_id,
     file_info_update("H5VLfile_get", file, NULL, NULL, dxpl_id);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_file_get, start, m2 - m1);
 
 #ifdef DEBUG_PT_TKR_VOL
     printf("TRACKER VOL FILE Get END\n");
@@ -2861,7 +2914,7 @@ H5VL_tracker_file_specific(void *file, H5VL_file_specific_args_t *args,
         tkr_write(o->tkr_helper, __func__, get_time_usec() - start);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_file_specific, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_file_specific() */
 
@@ -2906,7 +2959,7 @@ H5VL_tracker_file_optional(void *file, H5VL_optional_args_t *args,
         tkr_write(o->tkr_helper, __func__, get_time_usec() - start);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_file_optional, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_file_optional() */
 
@@ -2947,7 +3000,7 @@ H5VL_tracker_file_close(void *file, hid_t dxpl_id, void **req)
     // tkrLockRelease(&myLock);
     // printf("TRACKER VOL FILE Close: TOTAL_TKR_OVERHEAD should be 0 : %ld\n", TOTAL_TKR_OVERHEAD);
     cleanup_hash_table();
-    TRK_ACCESS_STAT_TIME += (get_time_usec() - trk_start);
+    TKR_ADD(TRK_ACCESS_STAT_TIME, (get_time_usec() - trk_start));
 #endif
 
 
@@ -2971,7 +3024,7 @@ H5VL_tracker_file_close(void *file, hid_t dxpl_id, void **req)
         rm_file_node(TKR_HELPER, ((file_tkr_info_t*)(o->generic_tkr_info))->file_no);
     }
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_file_close, start, m2 - m1);
     H5VL_tracker_free_obj(o);
     return ret_value;
 } /* end H5VL_tracker_file_close() */
@@ -3024,14 +3077,14 @@ H5VL_tracker_group_create(void *obj, const H5VL_loc_params_t *loc_params,
     file_tkr_info_t * file_info = (file_tkr_info_t*)file->generic_tkr_info;
     file_grp_created(file_info);
     // group_info_update("H5VLgroup_create", obj, loc_params, name, gapl_id, dxpl_id);
-    TRK_ACCESS_STAT_TIME += (get_time_usec() - trk_start);
+    TKR_ADD(TRK_ACCESS_STAT_TIME, (get_time_usec() - trk_start));
 #endif
 
 #ifdef DEBUG_TKR_VOL
     group_info_print("H5VLgroup_create", obj, loc_params, name, gapl_id, dxpl_id, req);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_group_create, start, m2 - m1);
     return (void *)group;
 } /* end H5VL_tracker_group_create() */
 
@@ -3081,14 +3134,14 @@ H5VL_tracker_group_open(void *obj, const H5VL_loc_params_t *loc_params,
     file_tkr_info_t * file_info = (file_tkr_info_t*)file->generic_tkr_info;
     file_grp_accessed(file_info);
     // group_info_update("H5VLgroup_create", obj, loc_params, name, gapl_id, dxpl_id);
-    TRK_ACCESS_STAT_TIME += (get_time_usec() - trk_start);
+    TKR_ADD(TRK_ACCESS_STAT_TIME, (get_time_usec() - trk_start));
 #endif
 
 #ifdef DEBUG_TKR_VOL
     group_info_print("H5VLgroup_open", obj, loc_params, name, gapl_id, dxpl_id, req);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_group_open, start, m2 - m1);
     return (void *)group;
 } /* end H5VL_tracker_group_open() */
 
@@ -3139,7 +3192,7 @@ H5VL_tracker_group_get(void *obj, H5VL_group_get_args_t *args, hid_t dxpl_id,
     file_tkr_info_t* file_info = (file_tkr_info_t*)group_info->obj_info.file_info;
     file_grp_accessed(file_info);
     // group_info_update("H5VLgroup_create", obj, loc_params, name, gapl_id, dxpl_id);
-    TRK_ACCESS_STAT_TIME += (get_time_usec() - trk_start);
+    TKR_ADD(TRK_ACCESS_STAT_TIME, (get_time_usec() - trk_start));
 #endif
 
 // #ifdef DEBUG_TKR_VOL
@@ -3149,7 +3202,7 @@ H5VL_tracker_group_get(void *obj, H5VL_group_get_args_t *args, hid_t dxpl_id,
 #ifdef DEBUG_PT_TKR_VOL
     printf("TRACKER VOL GROUP Get: END\n");
 #endif
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_group_get, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_group_get() */
 
@@ -3246,7 +3299,7 @@ H5VL_tracker_group_specific(void *obj, H5VL_group_specific_args_t *args,
     tkr_write(helper, __func__, get_time_usec() - start);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_group_specific, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_group_specific() */
 
@@ -3288,7 +3341,7 @@ H5VL_tracker_group_optional(void *obj, H5VL_optional_args_t *args,
         tkr_write(o->tkr_helper, __func__, get_time_usec() - start);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_group_optional, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_group_optional() */
 
@@ -3339,7 +3392,7 @@ H5VL_tracker_group_close(void *grp, hid_t dxpl_id, void **req)
         H5VL_tracker_free_obj(o);
     }
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_group_close, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_group_close() */
 
@@ -3413,7 +3466,7 @@ H5VL_tracker_link_create(H5VL_link_create_args_t *args, void *obj,
         tkr_write(o->tkr_helper, __func__, get_time_usec() - start);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_link_create, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_link_create() */
 
@@ -3470,7 +3523,7 @@ H5VL_tracker_link_copy(void *src_obj, const H5VL_loc_params_t *loc_params1,
         tkr_write(o_dst->tkr_helper, __func__, get_time_usec() - start);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_link_copy, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_link_copy() */
 
@@ -3527,7 +3580,7 @@ H5VL_tracker_link_move(void *src_obj, const H5VL_loc_params_t *loc_params1,
         tkr_write(o_dst->tkr_helper, __func__, get_time_usec() - start);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_link_move, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_link_move() */
 
@@ -3569,7 +3622,7 @@ H5VL_tracker_link_get(void *obj, const H5VL_loc_params_t *loc_params,
         tkr_write(o->tkr_helper, __func__, get_time_usec() - start);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_link_get, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_link_get() */
 
@@ -3611,7 +3664,7 @@ H5VL_tracker_link_specific(void *obj, const H5VL_loc_params_t *loc_params,
         tkr_write(o->tkr_helper, __func__, get_time_usec() - start);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_link_specific, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_link_specific() */
 
@@ -3653,7 +3706,7 @@ H5VL_tracker_link_optional(void *obj, const H5VL_loc_params_t *loc_params,
         tkr_write(o->tkr_helper, __func__, get_time_usec() - start);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_link_optional, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_link_optional() */
 
@@ -3683,7 +3736,7 @@ H5VL_tracker_object_open(void *obj, const H5VL_loc_params_t *loc_params,
 #ifdef ACCESS_STAT
     if(loc_params->type == H5VL_OBJECT_BY_NAME){
         obj_name = loc_params->loc_data.loc_by_name.name;
-        dset_shm_write(obj_name); 
+        dset_ctx_write(obj_name); 
     }
 #endif
 
@@ -3723,22 +3776,9 @@ H5VL_tracker_object_open(void *obj, const H5VL_loc_params_t *loc_params,
 
         // dataset_info_update("H5VLobject_open", NULL, NULL, NULL, new_obj, dxpl_id); // must exist to not segfault
 
-        // Make copy of file name and dataset name to use as key
-        const char * check_ds_name = obj_name ? strdup(obj_name) : NULL;
-        const char * check_fname = file_info->file_name ? strdup(file_info->file_name) : NULL;
-
-        // if both names are not null, then create a key
-        if (check_ds_name && check_fname){
-            char * key = encode_two_strings(check_fname, check_ds_name);
-            // printf("TRACKER VOL INT : _obj_wrap_under 4.1 H5I_DATASET: key: %s\n", key);
-            int has_key = key_exists(key);
-            if (has_key == 0) {
-                // dtype_id and dset_id cannot be accessed here
-                dataset_info_update("H5VLobject_open", NULL, NULL, NULL, new_obj, dxpl_id); // must exist to not segfault
-            }
-        }
+        // dataset properties are captured lazily at first read/write or close
     }
-    TRK_ACCESS_STAT_TIME += (get_time_usec() - trk_start);
+    TKR_ADD(TRK_ACCESS_STAT_TIME, (get_time_usec() - trk_start));
 #endif
 
     } /* end if */
@@ -3751,7 +3791,7 @@ H5VL_tracker_object_open(void *obj, const H5VL_loc_params_t *loc_params,
         tkr_write(o->tkr_helper, __func__, get_time_usec() - start);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_object_open, start, m2 - m1);
     return (void *)new_obj;
 } /* end H5VL_tracker_object_open() */
 
@@ -3796,7 +3836,7 @@ H5VL_tracker_object_copy(void *src_obj, const H5VL_loc_params_t *src_loc_params,
         tkr_write(o_dst->tkr_helper, __func__, get_time_usec() - start);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_object_copy, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_object_copy() */
 
@@ -3858,7 +3898,7 @@ H5VL_tracker_object_get(void *obj, const H5VL_loc_params_t *loc_params, H5VL_obj
         tkr_write(o->tkr_helper, __func__, get_time_usec() - start);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_object_get, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_object_get() */
 
@@ -3937,12 +3977,14 @@ H5VL_tracker_object_specific(void *obj, const H5VL_loc_params_t *loc_params,
                 my_dataset_info = (dataset_tkr_info_t *)my_tkr_info;
 
                 // Update dataspace dimensions & element count (which could have changed)
-                space_id = H5Dget_space(dataset_id);
-                H5Sget_simple_extent_dims(space_id, my_dataset_info->dimensions, NULL);
-                my_dataset_info->dset_n_elements = (hsize_t)H5Sget_simple_extent_npoints(space_id);
-                // my_dataset_info->dset_id = dataset_id;
-                printf("H5VL_tracker_object_specific dset_id[%ld]",dataset_id); // not used!
-                H5Sclose(space_id);
+                if(my_dataset_info->meta_captured) {
+                    space_id = H5Dget_space(dataset_id);
+                    H5Sget_simple_extent_dims(space_id, my_dataset_info->dimensions, NULL);
+                    my_dataset_info->dset_n_elements = (hsize_t)H5Sget_simple_extent_npoints(space_id);
+                    // my_dataset_info->dset_id = dataset_id;
+                    printf("H5VL_tracker_object_specific dset_id[%ld]",dataset_id); // not used!
+                    H5Sclose(space_id);
+                }
 
                 // Don't close dataset ID, it's owned by the application
             }
@@ -3969,7 +4011,7 @@ H5VL_tracker_object_specific(void *obj, const H5VL_loc_params_t *loc_params,
     tkr_write(helper, __func__, get_time_usec() - start);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_object_specific, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_object_specific() */
 
@@ -4011,7 +4053,7 @@ H5VL_tracker_object_optional(void *obj, const H5VL_loc_params_t *loc_params,
         tkr_write(o->tkr_helper, __func__, get_time_usec() - start);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_object_optional, start, m2 - m1);
 
     return ret_value;
 } /* end H5VL_tracker_object_optional() */
@@ -4029,7 +4071,7 @@ herr_t
 H5VL_tracker_introspect_get_conn_cls(void *obj, H5VL_get_conn_lvl_t lvl,
     const H5VL_class_t **conn_cls)
 {   
-    // Overhead not recorded here
+    TKR_CB_COUNT(TKR_CB_introspect_get_conn_cls); // pure passthrough, calls only
 
     H5VL_tracker_t *o = (H5VL_tracker_t *)obj;
     herr_t ret_value;
@@ -4065,7 +4107,7 @@ H5VL_tracker_introspect_get_conn_cls(void *obj, H5VL_get_conn_lvl_t lvl,
 herr_t
 H5VL_tracker_introspect_get_cap_flags(const void *_info, uint64_t *cap_flags)
 {
-    // Overhead not recorded here
+    TKR_CB_COUNT(TKR_CB_introspect_get_cap_flags); // pure passthrough, calls only
 
     const H5VL_tracker_info_t *info = (const H5VL_tracker_info_t *)_info;
     herr_t                          ret_value;
@@ -4098,7 +4140,7 @@ herr_t
 H5VL_tracker_introspect_opt_query(void *obj, H5VL_subclass_t cls,
                                      int opt_type, uint64_t *flags)
 {
-    // Overhead not recorded here
+    TKR_CB_COUNT(TKR_CB_introspect_opt_query); // pure passthrough, calls only
 
     H5VL_tracker_t *o = (H5VL_tracker_t *)obj;
     herr_t ret_value;
@@ -4150,10 +4192,15 @@ H5VL_tracker_request_wait(void *obj, uint64_t timeout,
         tkr_write(o->tkr_helper, __func__, get_time_usec() - start);
 #endif
 
+#ifdef ACCESS_STAT
+    if(ret_value >= 0)
+        tkr_req_wait(o, m2 - m1, *status);
+#endif
+
     if(ret_value >= 0 && *status != H5ES_STATUS_IN_PROGRESS)
         H5VL_tracker_free_obj(o);
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_request_wait, start, m2 - m1);
 
     return ret_value;
 } /* end H5VL_tracker_request_wait() */
@@ -4185,6 +4232,17 @@ H5VL_tracker_request_notify(void *obj, H5VL_request_notify_t cb, void *ctx)
     printf("TRACKER VOL REQUEST Wait\n");
 #endif
 
+#ifdef ACCESS_STAT
+    // Chain our completion stamp in front of the application callback
+    tkr_req_info_t *req_info = (tkr_req_info_t *)o->generic_tkr_info;
+    if(req_info){
+        req_info->user_cb = cb;
+        req_info->user_ctx = ctx;
+        cb = tkr_req_notify_cb;
+        ctx = req_info;
+    }
+#endif
+
     m1 = get_time_usec();
     ret_value = H5VLrequest_notify(o->under_object, o->under_vol_id, cb, ctx);
     m2 = get_time_usec();
@@ -4197,7 +4255,7 @@ H5VL_tracker_request_notify(void *obj, H5VL_request_notify_t cb, void *ctx)
     if(ret_value >= 0)
         H5VL_tracker_free_obj(o);
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_request_notify, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_request_notify() */
 
@@ -4236,10 +4294,18 @@ H5VL_tracker_request_cancel(void *obj, H5VL_request_status_t *status)
         tkr_write(o->tkr_helper, __func__, get_time_usec() - start);
 #endif
 
+#ifdef ACCESS_STAT
+    // A request that finished before the cancel still completed
+    if(ret_value >= 0 && (*status == H5VL_REQUEST_STATUS_SUCCEED || *status == H5VL_REQUEST_STATUS_FAIL))
+        tkr_req_wait(o, 0, *status);
+    else if(ret_value >= 0)
+        tkr_req_release(o);
+#endif
+
     if(ret_value >= 0)
         H5VL_tracker_free_obj(o);
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_request_cancel, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_request_cancel() */
 
@@ -4276,7 +4342,7 @@ H5VL_tracker_request_specific(void *obj, H5VL_request_specific_args_t *args)
         tkr_write(o->tkr_helper, __func__, get_time_usec() - start);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_request_specific, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_request_specific() */
 
@@ -4313,7 +4379,7 @@ H5VL_tracker_request_optional(void *obj, H5VL_optional_args_t *args)
         tkr_write(o->tkr_helper, __func__, get_time_usec() - start);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_request_optional, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_request_optional() */
 
@@ -4351,10 +4417,15 @@ H5VL_tracker_request_free(void *obj)
         tkr_write(o->tkr_helper, __func__, get_time_usec() - start);
 #endif
 
+#ifdef ACCESS_STAT
+    if(ret_value >= 0)
+        tkr_req_release(o);
+#endif
+
     if(ret_value >= 0)
         H5VL_tracker_free_obj(o);
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_request_free, start, m2 - m1);
     return ret_value;
 } /* end H5VL_tracker_request_free() */
 
@@ -4393,11 +4464,11 @@ H5VL_tracker_blob_put(void *obj, const void *buf, size_t size,
 #endif
 
 #ifdef ACCESS_STAT
-    // blob_info_update("H5VLblob_put", obj, NULL, size, blob_id, buf, ctx);
-    // TODO: use shm to store blob_info to dset_info
+    if(ret_value >= 0)
+        dset_blob_record((file_tkr_info_t*)o->generic_tkr_info, 'w', size, m2 - m1);
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+    tkr_cb_record(TKR_CB_blob_put, start, m2 - m1);
 
     return ret_value;
 } /* end H5VL_tracker_blob_put() */
@@ -4430,18 +4501,16 @@ H5VL_tracker_blob_get(void *obj, const void *blob_id, void *buf,
     m2 = get_time_usec();
 
 #ifdef DEBUG_BLOB_TKR_VOL
-    file_tkr_info_t* file_info = (file_tkr_info_t*)o->generic_tkr_info;
-    dataset_tkr_info_t * dset_info = (dataset_tkr_info_t*)file_info->opened_datasets;
-
-    if(ret_value >= 0) {
-        dset_info->total_bytes_blob_get += size;
-        dset_info->blob_get_cnt++;
-        dset_info->total_blob_get_time += (m2 - m1);
+    if(ret_value >= 0)
         blob_info_print("H5VLblob_get", obj, NULL, size, blob_id, buf, ctx);
-    }
 #endif
 
-    TOTAL_TKR_OVERHEAD += (get_time_usec() - start - (m2 - m1));
+#ifdef ACCESS_STAT
+    if(ret_value >= 0)
+        dset_blob_record((file_tkr_info_t*)o->generic_tkr_info, 'r', size, m2 - m1);
+#endif
+
+    tkr_cb_record(TKR_CB_blob_get, start, m2 - m1);
 
     return ret_value;
 } /* end H5VL_tracker_blob_get() */
@@ -4460,7 +4529,7 @@ herr_t
 H5VL_tracker_blob_specific(void *obj, void *blob_id,
     H5VL_blob_specific_args_t *args)
 {
-    // Overhead not recorded here
+    TKR_CB_COUNT(TKR_CB_blob_specific); // pure passthrough, calls only
 
     H5VL_tracker_t *o = (H5VL_tracker_t *)obj;
     herr_t ret_value;
@@ -4487,7 +4556,7 @@ H5VL_tracker_blob_specific(void *obj, void *blob_id,
 herr_t
 H5VL_tracker_blob_optional(void *obj, void *blob_id, H5VL_optional_args_t *args)
 {
-    // Overhead not recorded here
+    TKR_CB_COUNT(TKR_CB_blob_optional); // pure passthrough, calls only
 
     H5VL_tracker_t *o = (H5VL_tracker_t *)obj;
     herr_t ret_value;
@@ -4516,7 +4585,7 @@ static herr_t
 H5VL_tracker_token_cmp(void *obj, const H5O_token_t *token1,
     const H5O_token_t *token2, int *cmp_value)
 {
-    // Overhead not recorded here
+    TKR_CB_COUNT(TKR_CB_token_cmp); // pure passthrough, calls only
 
     H5VL_tracker_t *o = (H5VL_tracker_t *)obj;
     herr_t ret_value;
@@ -4551,7 +4620,7 @@ static herr_t
 H5VL_tracker_token_to_str(void *obj, H5I_type_t obj_type,
     const H5O_token_t *token, char **token_str)
 {
-    // Overhead not recorded here
+    TKR_CB_COUNT(TKR_CB_token_to_str); // pure passthrough, calls only
     H5VL_tracker_t *o = (H5VL_tracker_t *)obj;
     herr_t ret_value;
 
@@ -4584,7 +4653,7 @@ static herr_t
 H5VL_tracker_token_from_str(void *obj, H5I_type_t obj_type,
     const char *token_str, H5O_token_t *token)
 {
-    // Overhead not recorded here
+    TKR_CB_COUNT(TKR_CB_token_from_str); // pure passthrough, calls only
     H5VL_tracker_t *o = (H5VL_tracker_t *)obj;
     herr_t ret_value;
 
@@ -4615,7 +4684,7 @@ H5VL_tracker_token_from_str(void *obj, H5I_type_t obj_type,
 static herr_t
 H5VL_tracker_optional(void *obj, H5VL_optional_args_t *args, hid_t dxpl_id, void **req)
 {
-    // Overhead not recorded here
+    TKR_CB_COUNT(TKR_CB_optional); // pure passthrough, calls only
     H5VL_tracker_t *o = (H5VL_tracker_t *)obj;
     herr_t ret_value;
 
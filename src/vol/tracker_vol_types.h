@@ -3,7 +3,11 @@
 
 // #include "/home/mtang11/spack/opt/spack/linux-centos7-skylake_avx512/gcc-7.3.0/openssl-1.1.1q-kqr6gf43vvc4kxk3m5d3ozopr7fq5c4s/include/openssl/md5.h"
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <pthread.h>
 
 #include "hdf5.h"
 #include "tracker_vol.h"
@@ -12,12 +16,10 @@
 // #include <openssl/md5.h>
 #include "../utils/uthash/src/uthash.h"
 
-// Declare the shared memory region
+#include "../core/dayu_core.h"
+
 #define H5FD_MAX_FILENAME_LEN 1024 // same as H5FD_MAX_FILENAME_LEN
-#define SHM_NAME "/tracker_shm"
-#define SHM_SIZE 256
 #define VOL_STAT_FILE_NAME "vol_data_stat.json"
-char* CURR_DSET;
 
 /************/
 /* Typedefs */
@@ -31,6 +33,175 @@ typedef struct H5VL_tkr_file_info_t file_tkr_info_t;
 
 typedef struct H5VL_tkr_blob_info_t blob_tkr_info_t;
 
+/* Selection Summary Start */
+#define TKR_SEL_MAX_RUNS 256        // distinct selection runs kept per dataset
+#define TKR_SEL_SCAN_BLOCKS 4096    // irregular hyperslab blocks scanned for strides
+#define TKR_SEL_BLOCK_BUF 1024      // hsize_t coordinates fetched per block list call
+
+// One run of consecutive reads or writes with an identical selection
+typedef struct sel_summary_t {
+    char op;                        // 'r' or 'w'
+    H5S_sel_type sel_type;
+    int ndim;
+    hsize_t * bbox_start;           // ndim entries each, one allocation
+    hsize_t * bbox_end;
+    hsize_t * stride;               // 0 where a dim has a single block position
+    hssize_t nblocks;
+    hssize_t npoints;
+    size_t sel_bytes;               // bytes selected per call
+    hbool_t stride_sampled;         // stride taken from the first TKR_SEL_SCAN_BLOCKS blocks
+    unsigned long repeat;           // consecutive calls with this selection
+    struct sel_summary_t * next;
+} sel_summary_t;
+/* Selection Summary End */
+
+/* Chunk Heat Start */
+#define TKR_CHUNK_MAP_MAX 65536         // chunks tracked per dataset open
+#define TKR_CHUNK_SCAN_BLOCKS 65536     // selection blocks mapped to chunks per call
+
+// Address and access heat of one chunk, keyed by its chunk grid
+// coordinates (chunk offset / chunk dims). coords trails the struct.
+typedef struct chunk_heat_t {
+    hsize_t * coords;
+    haddr_t addr;                       // HADDR_UNDEF if not allocated or not resolved yet
+    hsize_t stored_size;                // on-disk size after filters
+    unsigned long read_cnt;             // calls touching the chunk
+    unsigned long write_cnt;
+    size_t read_bytes;                  // selected bytes falling in the chunk
+    size_t write_bytes;
+    unsigned long last_call;            // call sequence that last touched the chunk
+    size_t last_slot;                   // slot in chunk_last for that call
+    UT_hash_handle hh;
+} chunk_heat_t;
+
+typedef struct {
+    chunk_heat_t * chunk;
+    size_t bytes;
+} chunk_touch_t;
+/* Chunk Heat End */
+
+/* Chunk Cache Simulator Start */
+#define TKR_CCACHE_NSLOTS_CNT 3
+#define TKR_CCACHE_NBYTES_CNT 4
+#define TKR_CCACHE_NCONF (TKR_CCACHE_NSLOTS_CNT * TKR_CCACHE_NBYTES_CNT)
+#define TKR_CCACHE_MAX_DSETS 64         // open datasets simulated at once, bounds total memory
+#define TKR_CCACHE_TARGET_HIT 0.9       // default target, TRACKER_CCACHE_TARGET overrides
+#define TKR_CCACHE_NIL UINT32_MAX
+
+// One simulated raw data chunk cache (H5Pset_chunk_cache): chunks hash to
+// slot (index % nslots) and evict the occupant, byte budget evicts by LRU.
+// Chunks are told apart by a hash of their coordinates, the index follows
+// the current extent as HDF5's does.
+typedef struct {
+    size_t nslots;
+    size_t nbytes;
+    size_t capacity;                    // chunks that fit in nbytes
+    size_t resident;
+    uint64_t * slot_key;                // chunk coordinate hash, 0 when empty
+    uint32_t * lru_prev;                // LRU list over slots
+    uint32_t * lru_next;
+    uint32_t lru_head;                  // most recent
+    uint32_t lru_tail;
+    unsigned long hits;
+} ccache_sim_t;
+/* Chunk Cache Simulator End */
+
+/* Datatype Conversion Start */
+#define TKR_TCONV_CACHE 4               // memory types remembered per open dataset
+
+typedef enum {
+    TKR_TCONV_NOOP = 0,                 // memory and file types are equal
+    TKR_TCONV_HARD,                     // compiled conversion path
+    TKR_TCONV_SOFT,                     // library soft conversion
+    TKR_TCONV_NCLASS
+} tkr_tconv_class_t;
+
+// Conversion class of one (mem_type, file_type) pair in one direction,
+// the file type being fixed for the dataset
+typedef struct {
+    hid_t mem_type_id;
+    char op;                            // 'r' file to memory, 'w' memory to file
+    tkr_tconv_class_t conv;
+    size_t mem_type_size;
+} tconv_cache_t;
+
+typedef struct {
+    unsigned long calls;
+    size_t bytes;                       // selected elements times memory type size
+    unsigned long time;                 // time inside H5VLdataset_read/write (us)
+} tconv_stat_t;
+/* Datatype Conversion End */
+
+/* Callback Profile Start */
+// Every H5VL_tracker_* callback, one profile slot each
+#define TKR_CB_LIST(X) \
+    X(register) X(init) X(term) X(info_copy) X(info_cmp) X(info_free) X(info_to_str) X(str_to_info) \
+    X(get_object) X(get_wrap_ctx) X(wrap_object) X(unwrap_object) X(free_wrap_ctx) \
+    X(attr_create) X(attr_open) X(attr_read) X(attr_write) X(attr_get) X(attr_specific) X(attr_optional) X(attr_close) \
+    X(dataset_create) X(dataset_open) X(dataset_read) X(dataset_write) X(dataset_get) X(dataset_specific) X(dataset_optional) X(dataset_close) \
+    X(datatype_commit) X(datatype_open) X(datatype_get) X(datatype_specific) X(datatype_optional) X(datatype_close) \
+    X(file_create) X(file_open) X(file_get) X(file_specific) X(file_optional) X(file_close) \
+    X(group_create) X(group_open) X(group_get) X(group_specific) X(group_optional) X(group_close) \
+    X(link_create) X(link_copy) X(link_move) X(link_get) X(link_specific) X(link_optional) \
+    X(object_open) X(object_copy) X(object_get) X(object_specific) X(object_optional) \
+    X(introspect_get_conn_cls) X(introspect_get_cap_flags) X(introspect_opt_query) \
+    X(request_wait) X(request_notify) X(request_cancel) X(request_specific) X(request_optional) X(request_free) \
+    X(blob_put) X(blob_get) X(blob_specific) X(blob_optional) \
+    X(token_cmp) X(token_to_str) X(token_from_str) X(optional)
+
+#define TKR_CB_ENUM(name) TKR_CB_##name,
+typedef enum {
+    TKR_CB_LIST(TKR_CB_ENUM)
+    TKR_CB_NUM
+} tkr_cb_t;
+#undef TKR_CB_ENUM
+
+#define TKR_CB_HIST_BINS 20             // bin 0: < 1us, bin b: [2^(b-1), 2^b) us, last bin open
+
+typedef struct {
+    unsigned long calls;
+    unsigned long native_time;          // time in the under connector (us)
+    unsigned long self_time;            // tracker time around it (us)
+    unsigned long self_hist[TKR_CB_HIST_BINS];
+} tkr_cb_stat_t;
+/* Callback Profile End */
+
+/* Async Request Start */
+#define TKR_REQ_LEVELS 16               // in-flight counts kept in the time histogram, last one open
+
+// One asynchronous dataset read/write, from submit to completion. Lives
+// on past its request wrapper when completion is reported through notify.
+typedef struct tkr_req_info_t {
+    dataset_tkr_info_t * dset_info;     // NULL once the dataset closed first
+    char op;                            // 'r' or 'w'
+    unsigned long submit_time;
+    unsigned long wait_time;            // application blocked in request_wait (us)
+    H5VL_request_notify_t user_cb;      // application notify callback, chained after ours
+    void * user_ctx;
+    struct tkr_req_info_t * prev;       // in-flight requests of the dataset
+    struct tkr_req_info_t * next;
+} tkr_req_info_t;
+
+typedef struct {
+    unsigned long submitted;
+    unsigned long completed;
+    unsigned long released;             // freed before a completion was seen
+    unsigned long latency;              // submit to completion (us), summed
+    unsigned long latency_max;
+    unsigned long queue;                // submit to execution start (us), summed
+    unsigned long queue_cnt;            // completions whose connector reported an execution start
+    unsigned long wait;                 // time blocked in request_wait (us)
+} tkr_req_stat_t;
+/* Async Request End */
+
+// Sequence ids and accumulators below (and the VOL/VFD time totals) are
+// shared by application threads under a thread-safe HDF5 build. Relaxed
+// atomic read-modify-write keeps ids unique and sums exact without a lock;
+// GCC builtins so the C++ VFD can use them on the same plain globals.
+#define TKR_NEXT_ID(var)   __atomic_add_fetch(&(var), 1, __ATOMIC_RELAXED)
+#define TKR_ADD(var, n)    ((void)__atomic_fetch_add(&(var), (n), __ATOMIC_RELAXED))
+#define TKR_TAKE(var)      __atomic_exchange_n(&(var), 0, __ATOMIC_RELAXED)   // read and reset
+
 unsigned long FILE_SORDER;
 // unsigned long FILE_PORDER;
 
@@ -45,24 +216,16 @@ unsigned long BLOB_PORDER;
 // Only recorded at H5VLfile_create time
 // hsize_t HEADER_SIZE; // candice added
 
-/* VFD uses vars*/
-unsigned long VFD_ACCESS_IDX;
-unsigned long TOTAL_VFD_READ;
-unsigned long TOTAL_VFD_WRITE;
-
-unsigned long START_ADDR;
-unsigned long END_ADDR;
-unsigned long ACC_SIZE;
-unsigned long START_PAGE;
-unsigned long END_PAGE;
-
 int TASK_ID = 0;
 
 
+
 typedef struct TrackerHelper {
     /* Tracker properties */
     char* tkr_file_path;
     FILE* tkr_file_handle;
+    dayu_sink_t log_sink;
+    dayu_flush_t flush;             // incremental flush of the dataset table
     Track_level tkr_level;
     char* tkr_line_format;
     char user_name[32];
@@ -116,6 +279,27 @@ typedef struct H5VL_tracker_wrap_ctx_t {
 
 
 
+/* Dataset Property Cache Start */
+// Per-file cache of dataset properties, survives dataset close/reopen
+typedef struct {
+    H5O_token_t token;                  // Key: object token within the file
+    H5T_class_t dt_class;
+    size_t dset_type_size;
+    char * layout;
+    char * dset_select_type;
+    size_t dset_select_npoints;
+    /* mutable fields below */
+    unsigned int dimension_cnt;
+    hsize_t * dimensions;
+    size_t dset_n_elements;
+    haddr_t dset_offset;
+    hsize_t storage_size;
+    bool extent_valid;                  // cleared by H5Dset_extent
+    bool storage_valid;                 // cleared by H5Dwrite and H5Dset_extent
+    UT_hash_handle hh;                  // Uthash handle
+} DsetPropCacheEntry;
+/* Dataset Property Cache End */
+
 struct H5VL_tkr_file_info_t {//assigned when a file is closed, serves to store stats (copied from shared_file_info)
     tkr_helper_t* tkr_helper;  //pointer shared among all layers, one per process.
     const char* file_name;
@@ -133,6 +317,7 @@ struct H5VL_tkr_file_info_t {//assigned when a file is closed, serves to store s
     hsize_t threshold;
     unsigned long open_time;
     /* candice added for more stats end */
+    int live_slot;               // slot in the live stats region, -1 when not published
 
 #ifdef H5_HAVE_PARALLEL
     // Only present for parallel HDF5 builds
@@ -152,6 +337,8 @@ struct H5VL_tkr_file_info_t {//assigned when a file is closed, serves to store s
     int opened_attrs_cnt;
     attribute_tkr_info_t *opened_attrs;
 
+    DsetPropCacheEntry *dset_prop_cache; // dataset properties by token, across reopens
+
     /* Statistics */
     int ds_created;
     int ds_accessed;
@@ -159,6 +346,10 @@ struct H5VL_tkr_file_info_t {//assigned when a file is closed, serves to store s
     int grp_accessed;
     int dtypes_created;
     int dtypes_accessed;
+    unsigned long blob_put_cnt;         // blobs with no dataset in context (attributes, async)
+    size_t blob_put_bytes;
+    unsigned long blob_get_cnt;
+    size_t blob_get_bytes;
 
     file_tkr_info_t *next;
 };
@@ -206,6 +397,39 @@ struct H5VL_tkr_dataset_info_t {
 
     char * dset_select_type;
     size_t dset_select_npoints;
+    hbool_t meta_captured;              // type/space/layout/offset queried, done lazily on first I/O or close
+
+    sel_summary_t * sel_head;           // per-call selection runs, moved to the tracking entry on close
+    sel_summary_t * sel_tail;
+    int sel_runs;
+    unsigned long sel_dropped;          // calls not summarized once TKR_SEL_MAX_RUNS is reached
+
+    int chunk_ndim;                     // 0 until chunk dims are read, -1 if not chunked
+    hsize_t * chunk_dims;
+    chunk_heat_t * chunk_map;           // touched chunks with address and heat, moved to the tracking entry on close
+    size_t chunk_map_cnt;
+    unsigned long chunk_dropped;        // chunk touches not counted: map full, memory budget or out of memory
+    hbool_t chunk_sampled;              // some call mapped only its first TKR_CHUNK_SCAN_BLOCKS blocks
+    unsigned long chunk_call;           // I/O call sequence for per-call dedup
+    chunk_touch_t * chunk_last;         // chunks touched by the last call, replayed on a repeated selection
+    size_t chunk_last_cnt;
+    size_t chunk_last_cap;
+
+    ccache_sim_t * ccache;              // TKR_CCACHE_NCONF simulated caches, NULL if not simulated
+    void * ccache_pool;                 // slot arrays of every config, allocated at the first chunk access
+    size_t chunk_bytes;                 // uncompressed chunk size in the cache
+    unsigned long ccache_accesses;
+
+    hssize_t sel_npoints;               // points selected by the last read/write
+    hid_t file_type_id;                 // dataset type, opened on the first conversion check
+    tconv_cache_t tconv_cache[TKR_TCONV_CACHE];
+    int tconv_cache_cnt;
+    tconv_stat_t tconv[2][TKR_TCONV_NCLASS]; // [read, write][class]
+
+    tkr_req_stat_t req;                 // async reads/writes, guarded by TKR_REQ_MUTEX
+    tkr_req_info_t * req_inflight;
+
+    int amap_contig_done;               // contiguous extent in the core dataset registry
 
     /* candice added for more dset stats end */
 
@@ -220,6 +444,11 @@ struct H5VL_tkr_dataset_info_t {
 
     int used_blob_cnt;
     blob_tkr_info_t * used_blobs;
+
+    size_t vlen_call_bytes;             // blob get bytes of the read in progress
+    unsigned long vlen_reads;           // reads that fetched vlen data
+    size_t vlen_read_bytes;
+    size_t vlen_read_max;               // largest vlen buffer of one read
     /* candice added for recording blob end */
 #ifdef H5_HAVE_PARALLEL
     int ind_dataset_read_cnt;
@@ -354,10 +583,18 @@ typedef struct {
     UT_hash_handle hh;              // Uthash handle
 } DsetTrackHashEntry;
 
-typedef struct myll_t {
-    unsigned long data;
-    struct myll_t* next;
-} myll_t;
+// Sorted set of IDs kept as disjoint [start, end] runs. Appending an ID at
+// or past the last run is O(1) amortized, anything else is a binary search.
+typedef struct {
+    unsigned long start;
+    unsigned long end;
+} idset_run_t;
+
+typedef struct idset_t {
+    idset_run_t * runs;
+    size_t nruns;
+    size_t cap;
+} idset_t;
 
 typedef struct H5VL_dset_track_t {
     // char *file_name;    // Parent file name
@@ -386,13 +623,41 @@ typedef struct H5VL_dset_track_t {
     size_t data_file_page_start;
     size_t data_file_page_end;
 
-    myll_t * sorder_ids; // linked-list head pointer
-    myll_t * sorder_ids_end; // linked-list tail pointer
-    myll_t * metadata_file_pages; // linked-list head pointer
-    myll_t * metadata_file_pages_end; // linked-list tail pointer
+    idset_t sorder_ids;                 // access orders, as runs
+    idset_t metadata_file_pages;        // metadata pages, as runs
 
     char * dset_select_type; // TODO: use to check for bytes
     size_t dset_select_npoints;
+
+    sel_summary_t * sel_head;           // selection runs across all opens of the dataset
+    sel_summary_t * sel_tail;
+    int sel_runs;
+    unsigned long sel_dropped;
+
+    int chunk_ndim;                     // 0 if not chunked
+    hsize_t * chunk_dims;
+    chunk_heat_t * chunk_map;           // touched chunks across all opens of the dataset
+    size_t chunk_map_cnt;
+    unsigned long chunk_dropped;
+    hbool_t chunk_sampled;
+
+    unsigned long ccache_hits[TKR_CCACHE_NCONF]; // per simulated cache config, summed across opens
+    unsigned long ccache_accesses;
+    size_t chunk_bytes;
+
+    tconv_stat_t tconv[2][TKR_TCONV_NCLASS]; // [read, write][class], summed across opens
+
+    unsigned long blob_put_cnt;         // vlen/global heap objects, summed across opens
+    size_t blob_put_bytes;
+    unsigned long blob_put_time;
+    unsigned long blob_get_cnt;
+    size_t blob_get_bytes;
+    unsigned long blob_get_time;
+    unsigned long vlen_reads;
+    size_t vlen_read_bytes;
+    size_t vlen_read_max;
+
+    tkr_req_stat_t req;                 // async reads/writes completed while open
     // int access_cnt;
     // dset_track_t *next;
 } dset_track_t;
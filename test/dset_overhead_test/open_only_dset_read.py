@@ -0,0 +1,79 @@
+import h5py
+import numpy as np
+import os
+import sys
+import time
+import subprocess
+
+DSET_OPEN_TIME=1000
+DSET_NUM=32
+DSET_SIZE=1024
+
+
+def set_curr_task_env(task):
+    os.environ['CURR_TASK'] = task
+    command = "echo running task [$CURR_TASK]"
+    command2 = "export CURR_TASK=$CURR_TASK"
+    subprocess.run(command, shell=True)
+    subprocess.run(command2, shell=True)
+
+
+def write_file(file_name, dset_size):
+    dtype=np.int32
+    hf = h5py.File(file_name, mode='w')
+
+    for i in range(DSET_NUM):
+        data = np.random.randint(0, 100, dset_size)
+        hf.create_dataset(
+            f'dataset{i}', 
+            data=data,
+            dtype=dtype)
+        hf[f'dataset{i}'].attrs['units'] = 'K'
+    hf.close()
+
+
+def open_file_once(hdf_file):
+    # Open every dataset and only touch attributes, no raw data access
+    for i in range(DSET_NUM):
+        dset = hdf_file[f'dataset{i}']
+        units = dset.attrs['units']
+        dset.id.close()
+
+
+def run_open_only(file_name, open_cnt):
+    hdf_file = h5py.File(file_name, 'r')
+    for i in range(open_cnt):
+        open_file_once(hdf_file)
+    hdf_file.close()
+
+
+if __name__ == "__main__":
+    # get user argument with file name
+    if len(sys.argv) < 2:
+        print("Please provide a file name.")
+        sys.exit(1)
+
+    file_name = sys.argv[1]
+    if len(sys.argv) >= 3:
+        open_cnt = int(sys.argv[2])
+        print(f"Using user provided open count [{open_cnt}]")
+    else:
+        print(f"Using default open count [{DSET_OPEN_TIME}]")
+        open_cnt = DSET_OPEN_TIME
+
+    if not os.path.exists(file_name):
+        write_file(file_name, DSET_SIZE)
+
+    task_name = "h5_open_only"
+    set_curr_task_env(task_name)
+    print(f"Running Task : {task_name}")
+
+    print(f"Running test for file {file_name}")
+
+    start_time = time.time()
+    run_open_only(file_name, open_cnt)
+    end_time = time.time()
+
+    duration_ms = (end_time - start_time) * 1000
+    print(f"Open {DSET_NUM * open_cnt} datasets time: {duration_ms} milliseconds")
+    print(f"Per dataset open time: {duration_ms * 1000 / (DSET_NUM * open_cnt)} microseconds")
@@ -0,0 +1,38 @@
+#!/bin/bash
+
+# Open-only microbenchmark: datasets are opened for attributes only,
+# compares no tracker vs VOL tracker dataset open overhead
+
+
+TRACKER_SRC_DIR=../../build/src
+export VOL_NAME="tracker"
+export HDF5_USE_FILE_LOCKING='FALSE' # TRUE FALSE BESTEFFORT
+
+
+OPEN_CNT=$1
+IO_PATH=$2
+LOG_FILE_PATH=$3
+
+# Write usege information
+if [ "$#" -ne 3 ]; then
+    echo "Usage: $0 <OPEN_CNT> <IO_PATH> <LOG_FILE_PATH>"
+    exit 1
+fi
+
+IO_FILE="$IO_PATH/open_only_sample.h5"
+rm -rf $IO_FILE
+
+schema_file_path=$LOG_FILE_PATH
+rm -rf $schema_file_path/*vol_data_stat.json
+
+# create the file without the tracker
+python3 open_only_dset_read.py $IO_FILE 0
+
+echo "Running open-only test without tracker"
+python3 open_only_dset_read.py $IO_FILE $OPEN_CNT
+
+echo "Running open-only test with VOL tracker"
+export CURR_TASK="open_only"
+export HDF5_VOL_CONNECTOR="$VOL_NAME under_vol=0;under_info={};path=$schema_file_path;level=2;format="
+export HDF5_PLUGIN_PATH=$TRACKER_SRC_DIR/vol
+python3 open_only_dset_read.py $IO_FILE $OPEN_CNT
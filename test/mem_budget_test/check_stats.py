@@ -0,0 +1,60 @@
+import glob
+import os
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "../../flow_analysis/utils"))
+import stat_loader
+
+# Check a mem_budget run: the VOL stat file was written to the end, has its
+# Memory-Budget record and the chunk heat of the chunked dataset. A tight
+# budget must have degraded the records, a generous one must not have.
+
+DEGRADE_ACTIONS = ("merged_ranges", "sampled_ranges", "dropped_detail", "spills")
+
+def find_key(obj, key):
+    if isinstance(obj, dict):
+        for k, v in obj.items():
+            if k == key:
+                yield v
+            else:
+                yield from find_key(v, key)
+    elif isinstance(obj, list):
+        for v in obj:
+            yield from find_key(v, key)
+
+def main():
+    if len(sys.argv) != 3 or sys.argv[2] not in ("tight", "generous"):
+        print(f"Usage: {sys.argv[0]} <stat_dir> tight|generous")
+        sys.exit(1)
+    tight = sys.argv[2] == "tight"
+    paths = glob.glob(os.path.join(sys.argv[1], "*vol_data_stat.json"))
+    if not paths:
+        print("no VOL stat file written")
+        sys.exit(1)
+
+    status = 0
+    for path, records in stat_loader.load_stat_json(paths).items():
+        budgets = list(find_key(records, "Memory-Budget"))
+        heat = list(find_key(records, "chunk_heat"))
+        if not budgets:
+            print(f"{path}: no Memory-Budget record")
+            status = 1
+            continue
+        mem = budgets[-1]
+        actions = sum(mem.get(a, 0) for a in DEGRADE_ACTIONS)
+        print(f"{path}: budget {mem['budget']} high_water {mem['high_water']} "
+              f"degrade actions {actions}, events {len(mem['events'])}, "
+              f"chunk_heat lists {len(heat)}, {sum(len(h) for h in heat)} chunks")
+        if not heat:
+            print(f"{path}: no chunk heat recorded")
+            status = 1
+        if tight and (actions == 0 or not mem["events"]):
+            print(f"{path}: tight budget but no degradation recorded")
+            status = 1
+        if not tight and actions != 0:
+            print(f"{path}: generous budget but records were degraded")
+            status = 1
+    sys.exit(status)
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,30 @@
+import sys
+
+import h5py
+import numpy as np
+
+# Write, reopen and read back a chunked dataset with many chunks, so the
+# tracker creates, merges and frees chunk heat records at every close.
+
+def main():
+    if len(sys.argv) != 3:
+        print(f"Usage: {sys.argv[0]} <h5_file> <reopens>")
+        sys.exit(1)
+    path = sys.argv[1]
+    reopens = int(sys.argv[2])
+
+    data = np.arange(256 * 256, dtype=np.float64).reshape(256, 256)
+    with h5py.File(path, "w") as f:
+        dset = f.create_dataset("chunked", data=data, chunks=(8, 8))
+        dset[:64, :] = data[:64, :] + 1
+
+    for i in range(reopens):
+        with h5py.File(path, "r") as f:
+            dset = f["chunked"]
+            row = (i * 8) % 256
+            if not np.array_equal(dset[row:row + 8, :], data[row:row + 8, :] + (row < 64)):
+                print(f"reopen {i}: data mismatch")
+                sys.exit(1)
+
+if __name__ == "__main__":
+    main()
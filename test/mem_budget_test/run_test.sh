@@ -0,0 +1,38 @@
+#!/bin/bash
+# Chunked dataset closes under a tracker memory budget: the run must finish
+# and write complete stat files, with a generous and with a tight budget.
+
+TRACKER_SRC_DIR=../../build/src
+export VOL_NAME="tracker"
+export HDF5_USE_FILE_LOCKING='FALSE' # TRUE FALSE BESTEFFORT
+
+REOPENS=${1:-64}
+IO_PATH=${2:-/tmp/$USER/mem_budget_test}
+BUDGET_LIST=${BUDGET_LIST:-"256M 64K"}
+TIGHT_LIST=${TIGHT_LIST:-"64K 16K"}      # budgets that must degrade the records
+
+mkdir -p $IO_PATH
+
+export WORKFLOW_NAME="mem_budget_test"
+export PATH_FOR_TASK_FILES="/tmp/$USER/$WORKFLOW_NAME"
+mkdir -p $PATH_FOR_TASK_FILES
+echo -n "chunked_close" > $PATH_FOR_TASK_FILES/${WORKFLOW_NAME}_vfd.curr_task
+echo -n "chunked_close" > $PATH_FOR_TASK_FILES/${WORKFLOW_NAME}_vol.curr_task
+export CURR_TASK="chunked_close"
+
+status=0
+for budget in $BUDGET_LIST; do
+    rm -f $IO_PATH/chunked.h5 $IO_PATH/*vol_data_stat.json
+
+    echo "== TRACKER_MEM_BUDGET=$budget"
+    TRACKER_MEM_BUDGET=$budget \
+    HDF5_VOL_CONNECTOR="$VOL_NAME under_vol=0;under_info={};path=$IO_PATH;level=2;format=" \
+    HDF5_PLUGIN_PATH=$TRACKER_SRC_DIR/vol \
+        python3 chunked_close.py $IO_PATH/chunked.h5 $REOPENS || status=1
+
+    expect=generous
+    [[ " $TIGHT_LIST " == *" $budget "* ]] && expect=tight
+    python3 check_stats.py $IO_PATH $expect || status=1
+done
+
+exit $status
@@ -0,0 +1,60 @@
+import glob
+import os
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "../../flow_analysis/utils"))
+import stat_loader
+
+# Validate tracker order ids after an mt_stress run: every file open and
+# every dataset open must have received a distinct id, none lost or shared.
+
+def expand_runs(runs):
+    ids = set()
+    for start, end in runs:
+        ids.update(range(start, end + 1))
+    return ids
+
+def main():
+    if len(sys.argv) != 5:
+        print(f"Usage: {sys.argv[0]} <stat_dir> <threads> <datasets> <iterations>")
+        sys.exit(1)
+    stat_dir = sys.argv[1]
+    threads, dsets, iters = (int(x) for x in sys.argv[2:5])
+
+    file_ids = []
+    dset_ids = {}   # (file, dset) -> ids, datasets may be logged more than once
+    paths = glob.glob(os.path.join(stat_dir, "*vol_data_stat.json"))
+    for records in stat_loader.load_stat_json(paths).values():
+        for rec in records:
+            for key, val in rec.items():
+                if not key.startswith("file-") or "mt_stress_" not in val.get("file_name", ""):
+                    continue
+                if "datasets" not in val:
+                    file_ids.append(int(key.split("-")[1]))
+                    continue
+                for ds in val["datasets"]:
+                    k = (val["file_name"], ds["dset_name"])
+                    dset_ids.setdefault(k, set()).update(expand_runs(ds["access_orders"]))
+
+    errors = 0
+    if len(file_ids) != threads * iters or len(set(file_ids)) != len(file_ids):
+        print(f"file ids: {len(file_ids)} records, {len(set(file_ids))} distinct, expected {threads * iters}")
+        errors += 1
+
+    seen = {}
+    for k, ids in dset_ids.items():
+        for i in ids:
+            if i in seen:
+                print(f"dataset id {i} shared by {seen[i]} and {k}")
+                errors += 1
+            seen[i] = k
+    if len(dset_ids) != threads * dsets or len(seen) != threads * dsets * iters:
+        print(f"dataset ids: {len(dset_ids)} datasets with {len(seen)} ids, "
+              f"expected {threads * dsets} with {threads * dsets * iters}")
+        errors += 1
+
+    print("order ids OK" if errors == 0 else f"{errors} order id errors")
+    sys.exit(1 if errors else 0)
+
+if __name__ == "__main__":
+    main()
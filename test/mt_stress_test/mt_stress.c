@@ -0,0 +1,131 @@
+/*
+ * Multi-threaded HDF5 I/O stress for the tracker VOL/VFD.
+ *
+ * Each thread repeatedly opens its own file, writes and reads back a set
+ * of small datasets and closes the file, so every file open and dataset
+ * open takes a tracker order id from a different thread. check_stats.py
+ * validates the ids afterwards; the elapsed time, with and without the
+ * tracker, gives its overhead under HDF5's global lock.
+ *
+ * Usage: mt_stress <threads> <datasets> <iterations> <io_dir>
+ */
+#include <hdf5.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DSET_ELEMS 256
+
+static int NDSETS;
+static int ITERS;
+static const char* IO_DIR;
+static int SERIALIZE;                   // library is not thread-safe
+static pthread_mutex_t H5_MUTEX = PTHREAD_MUTEX_INITIALIZER;
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int thread_io(int tid, int iter)
+{
+    char path[4096], name[64];
+    int wbuf[DSET_ELEMS], rbuf[DSET_ELEMS];
+    hsize_t dims[1] = {DSET_ELEMS};
+    hid_t file, space, dset;
+    int err = 0;
+
+    snprintf(path, sizeof(path), "%s/mt_stress_%d.h5", IO_DIR, tid);
+    if(iter == 0)
+        file = H5Fcreate(path, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    else
+        file = H5Fopen(path, H5F_ACC_RDWR, H5P_DEFAULT);
+    if(file < 0)
+        return -1;
+
+    space = H5Screate_simple(1, dims, NULL);
+    for(int d = 0; d < NDSETS; d++){
+        snprintf(name, sizeof(name), "dset_%d", d);
+        if(iter == 0)
+            dset = H5Dcreate2(file, name, H5T_NATIVE_INT, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+        else
+            dset = H5Dopen2(file, name, H5P_DEFAULT);
+        if(dset < 0){
+            err = -1;
+            break;
+        }
+        for(int i = 0; i < DSET_ELEMS; i++)
+            wbuf[i] = tid * 1000003 + iter * 1009 + d * 31 + i;
+        if(H5Dwrite(dset, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, wbuf) < 0
+            || H5Dread(dset, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, rbuf) < 0
+            || memcmp(wbuf, rbuf, sizeof(wbuf)) != 0)
+            err = -1;
+        H5Dclose(dset);
+        if(err)
+            break;
+    }
+    H5Sclose(space);
+    H5Fclose(file);
+    return err;
+}
+
+static void* thread_main(void* arg)
+{
+    int tid = (int)(long)arg;
+    long failed = 0;
+
+    for(int iter = 0; iter < ITERS; iter++){
+        if(SERIALIZE)
+            pthread_mutex_lock(&H5_MUTEX);
+        if(thread_io(tid, iter) < 0)
+            failed++;
+        if(SERIALIZE)
+            pthread_mutex_unlock(&H5_MUTEX);
+    }
+    return (void*)failed;
+}
+
+int main(int argc, char** argv)
+{
+    pthread_t* threads;
+    hbool_t threadsafe = 0;
+    long failed = 0;
+    int nthreads;
+    double t0, t1;
+
+    if(argc != 5){
+        fprintf(stderr, "Usage: %s <threads> <datasets> <iterations> <io_dir>\n", argv[0]);
+        return 1;
+    }
+    nthreads = atoi(argv[1]);
+    NDSETS = atoi(argv[2]);
+    ITERS = atoi(argv[3]);
+    IO_DIR = argv[4];
+
+    H5is_library_threadsafe(&threadsafe);
+    if(!threadsafe && nthreads > 1){
+        fprintf(stderr, "HDF5 is not thread-safe, serializing HDF5 calls\n");
+        SERIALIZE = 1;
+    }
+
+    threads = (pthread_t*)malloc(nthreads * sizeof(pthread_t));
+    t0 = now_sec();
+    for(long t = 0; t < nthreads; t++)
+        pthread_create(&threads[t], NULL, thread_main, (void*)t);
+    for(int t = 0; t < nthreads; t++){
+        void* ret;
+        pthread_join(threads[t], &ret);
+        failed += (long)ret;
+    }
+    t1 = now_sec();
+    free(threads);
+
+    printf("threads %d datasets %d iterations %d threadsafe %d elapsed(s) %.3f dset_ops/s %.1f failed %ld\n",
+        nthreads, NDSETS, ITERS, (int)threadsafe, t1 - t0,
+        (double)nthreads * ITERS * NDSETS / (t1 - t0), failed);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,43 @@
+#!/bin/bash
+# Multi-threaded stress of the tracker: validates order ids and reports
+# dataset ops/s against thread count, with and without the tracker VOL.
+# Needs a thread-safe HDF5 build for the threads to actually overlap.
+
+TRACKER_SRC_DIR=../../build/src
+export VOL_NAME="tracker"
+export HDF5_USE_FILE_LOCKING='FALSE' # TRUE FALSE BESTEFFORT
+
+DSET_CNT=${1:-16}
+ITER_CNT=${2:-50}
+IO_PATH=${3:-/tmp/$USER/mt_stress_test}
+THREAD_LIST=${THREAD_LIST:-"1 2 4 8 16"}
+
+mkdir -p $IO_PATH
+H5CC=${H5CC:-h5cc}
+$H5CC -O2 -o mt_stress mt_stress.c -lpthread || exit 1
+
+export WORKFLOW_NAME="mt_stress_test"
+export PATH_FOR_TASK_FILES="/tmp/$USER/$WORKFLOW_NAME"
+mkdir -p $PATH_FOR_TASK_FILES
+echo -n "mt_stress" > $PATH_FOR_TASK_FILES/${WORKFLOW_NAME}_vfd.curr_task
+echo -n "mt_stress" > $PATH_FOR_TASK_FILES/${WORKFLOW_NAME}_vol.curr_task
+export CURR_TASK="mt_stress"
+
+status=0
+for threads in $THREAD_LIST; do
+    rm -f $IO_PATH/mt_stress_*.h5 $IO_PATH/*vol_data_stat.json
+
+    echo "== $threads threads, native"
+    ./mt_stress $threads $DSET_CNT $ITER_CNT $IO_PATH || status=1
+
+    echo "== $threads threads, tracker VOL"
+    rm -f $IO_PATH/mt_stress_*.h5
+    HDF5_VOL_CONNECTOR="$VOL_NAME under_vol=0;under_info={};path=$IO_PATH;level=2;format=" \
+    HDF5_PLUGIN_PATH=$TRACKER_SRC_DIR/vol \
+        ./mt_stress $threads $DSET_CNT $ITER_CNT $IO_PATH || status=1
+
+    python3 check_stats.py $IO_PATH $threads $DSET_CNT $ITER_CNT || status=1
+done
+
+rm -f mt_stress
+exit $status